@@ -0,0 +1,131 @@
+/**
+ * Furnace Tracker - multi-system chiptune tracker
+ * Copyright (C) 2021-2024 tildearrow and contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "allocTrap.h"
+
+#ifdef DIV_ALLOC_TRAP
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <atomic>
+#include <new>
+#include "../ta-log.h"
+#ifdef DIV_ALLOC_TRAP_BACKTRACE
+#include "../../extern/backward/backward.hpp"
+#endif
+
+static thread_local int trapDepth=0;
+// set while reporting, as reporting allocates too
+static thread_local bool trapReporting=false;
+static std::atomic<unsigned int> trapCount(0);
+
+DivAllocTrapScope::DivAllocTrapScope(bool enable):
+  active(enable) {
+  if (active) trapDepth++;
+}
+
+DivAllocTrapScope::~DivAllocTrapScope() {
+  if (active) trapDepth--;
+}
+
+bool divAllocTrapActive() {
+  return trapDepth>0 && !trapReporting;
+}
+
+unsigned int divAllocTrapCount() {
+  return trapCount.load(std::memory_order_relaxed);
+}
+
+static void trapReport(const char* what, size_t size, unsigned int count) {
+  logE("ALLOCATION TRAP: %s of %d bytes in the audio thread! (%d)",what,(int)size,count);
+#ifdef DIV_ALLOC_TRAP_BACKTRACE
+  backward::StackTrace st;
+  st.load_here(32);
+  backward::Printer p;
+  p.print(st,stderr);
+#endif
+  if (count==DIV_ALLOC_TRAP_MAX_REPORTS) {
+    logE("ALLOCATION TRAP: too many reports. counting the rest silently.");
+  }
+}
+
+static void trapCheck(const char* what, size_t size) {
+  if (trapDepth<=0 || trapReporting) return;
+  unsigned int count=++trapCount;
+  if (count>DIV_ALLOC_TRAP_MAX_REPORTS) return;
+
+  trapReporting=true;
+  trapReport(what,size,count);
+  trapReporting=false;
+}
+
+static inline void* trapAlloc(const char* what, size_t size) {
+  trapCheck(what,size);
+  return malloc(size?size:1);
+}
+
+void* operator new(size_t size) {
+  void* ret=trapAlloc("new",size);
+  if (ret==NULL) throw std::bad_alloc();
+  return ret;
+}
+
+void* operator new[](size_t size) {
+  void* ret=trapAlloc("new[]",size);
+  if (ret==NULL) throw std::bad_alloc();
+  return ret;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  return trapAlloc("new",size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  return trapAlloc("new[]",size);
+}
+
+void operator delete(void* ptr) noexcept {
+  if (ptr==NULL) return;
+  trapCheck("delete",0);
+  free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+  if (ptr==NULL) return;
+  trapCheck("delete[]",0);
+  free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+  operator delete(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+  operator delete[](ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+  operator delete(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+  operator delete[](ptr);
+}
+
+#endif
@@ -0,0 +1,61 @@
+/**
+ * Furnace Tracker - multi-system chiptune tracker
+ * Copyright (C) 2021-2024 tildearrow and contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _ALLOCTRAP_H
+#define _ALLOCTRAP_H
+
+// debug builds only (WITH_ALLOC_TRAP).
+// while a trap scope is active in a thread, every call to operator new or
+// operator delete in that thread is reported along with a backtrace.
+// the audio thread must not allocate, so nextBuf() runs inside one.
+// memory allocated with malloc() (blip_buf, the C cores) is not seen.
+
+#ifdef DIV_ALLOC_TRAP
+
+// don't flood the log. the rest is only counted.
+#define DIV_ALLOC_TRAP_MAX_REPORTS 32
+
+class DivAllocTrapScope {
+  bool active;
+  public:
+    DivAllocTrapScope(bool enable=true);
+    ~DivAllocTrapScope();
+};
+
+/**
+ * whether the current thread is in a trap scope.
+ */
+bool divAllocTrapActive();
+
+/**
+ * how many allocations have been trapped so far.
+ */
+unsigned int divAllocTrapCount();
+
+#define DIV_ALLOC_TRAP_SCOPE(x) DivAllocTrapScope _allocTrapScope(x)
+#define DIV_ALLOC_TRAP_ACTIVE divAllocTrapActive()
+
+#else
+
+#define DIV_ALLOC_TRAP_SCOPE(x)
+#define DIV_ALLOC_TRAP_ACTIVE false
+
+#endif
+
+#endif
@@ -0,0 +1,317 @@
+/**
+ * Furnace Tracker - multi-system chiptune tracker
+ * Copyright (C) 2021-2024 tildearrow and contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "backupStore.h"
+#include "../fileutils.h"
+#include "../ta-log.h"
+#include <zlib.h>
+#include <fmt/printf.h>
+#include <set>
+#include <errno.h>
+#include <inttypes.h>
+#ifdef _WIN32
+#include "../utfutils.h"
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
+
+String DivBackupStore::getChunkKey(const unsigned char* data, size_t len) {
+  // CRC-32 and 64-bit FNV-1a, plus the length
+  uLong crc=crc32(0L,Z_NULL,0);
+  uint64_t fnv=0xcbf29ce484222325ULL;
+  for (size_t i=0; i<len; i+=0x40000000) {
+    size_t piece=len-i;
+    if (piece>0x40000000) piece=0x40000000;
+    crc=crc32(crc,data+i,piece);
+  }
+  for (size_t i=0; i<len; i++) {
+    fnv^=data[i];
+    fnv*=0x100000001b3ULL;
+  }
+  return fmt::sprintf("%08x%016" PRIx64 "-%" PRIx64,(unsigned int)crc,fnv,(uint64_t)len);
+}
+
+String DivBackupStore::getChunkFileName(const String& key) {
+  return chunkPath+String(DIR_SEPARATOR_STR)+key;
+}
+
+bool DivBackupStore::writeChunk(const String& key, const unsigned char* data, size_t len) {
+  String fileName=getChunkFileName(key);
+  if (fileExists(fileName.c_str())==1) return true;
+
+  // fastest level. this runs every few seconds
+  uLongf compLen=compressBound(len);
+  unsigned char* comp=new unsigned char[compLen];
+  int result=compress2(comp,&compLen,data,len,Z_BEST_SPEED);
+  if (result!=Z_OK) {
+    logW("backup: could not compress chunk %s! (%d)",key,result);
+    delete[] comp;
+    return false;
+  }
+
+  // write to a temporary file first, so that a chunk is either complete or absent
+  String tempName=fileName+".tmp";
+  FILE* f=ps_fopen(tempName.c_str(),"wb");
+  if (f==NULL) {
+    logW("backup: could not open chunk %s! (%s)",key,strerror(errno));
+    delete[] comp;
+    return false;
+  }
+  bool ok=(fwrite(comp,1,compLen,f)==compLen);
+  if (fclose(f)!=0) ok=false;
+  delete[] comp;
+  if (!ok) {
+    logW("backup: could not write chunk %s! (%s)",key,strerror(errno));
+    deleteFile(tempName.c_str());
+    return false;
+  }
+  if (!moveFiles(tempName.c_str(),fileName.c_str())) {
+    logW("backup: could not rename chunk %s!",key);
+    deleteFile(tempName.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool DivBackupStore::readManifest(const String& manifest, size_t& totalLen, std::vector<String>& keys) {
+  FILE* f=ps_fopen(manifest.c_str(),"rb");
+  if (f==NULL) return false;
+
+  char line[256];
+  bool ok=false;
+  totalLen=0;
+  keys.clear();
+  if (fgets(line,256,f)!=NULL && strncmp(line,DIV_BACKUP_MAGIC,strlen(DIV_BACKUP_MAGIC))==0) {
+    if (fgets(line,256,f)!=NULL) {
+      totalLen=strtoull(line,NULL,10);
+      ok=true;
+      while (fgets(line,256,f)!=NULL) {
+        String key=line;
+        while (!key.empty() && (key.back()=='\n' || key.back()=='\r')) key.pop_back();
+        if (key.empty()) continue;
+        // keys never contain separators or dots
+        if (key.find_first_of("/\\.")!=String::npos) {
+          ok=false;
+          break;
+        }
+        keys.push_back(key);
+      }
+    }
+  }
+  fclose(f);
+  return ok;
+}
+
+std::vector<String> DivBackupStore::listDir(const String& dir, const char* ext) {
+  std::vector<String> ret;
+  size_t extLen=strlen(ext);
+#ifdef _WIN32
+  String findPath=dir+String(DIR_SEPARATOR_STR)+String("*")+String(ext);
+  WIN32_FIND_DATAW next;
+  HANDLE d=FindFirstFileW(utf8To16(findPath.c_str()).c_str(),&next);
+  if (d!=INVALID_HANDLE_VALUE) {
+    do {
+      String name=utf16To8(next.cFileName);
+      if (name=="." || name=="..") continue;
+      ret.push_back(name);
+    } while (FindNextFileW(d,&next)!=0);
+    FindClose(d);
+  }
+#else
+  DIR* d=opendir(dir.c_str());
+  if (d==NULL) return ret;
+  while (true) {
+    struct dirent* next=readdir(d);
+    if (next==NULL) break;
+    String name=next->d_name;
+    if (name=="." || name=="..") continue;
+    if (name.size()<extLen || name.compare(name.size()-extLen,extLen,ext)!=0) continue;
+    ret.push_back(name);
+  }
+  closedir(d);
+#endif
+  return ret;
+}
+
+bool DivBackupStore::isBackupPoint(const String& file) {
+  size_t extLen=strlen(DIV_BACKUP_EXT);
+  if (file.size()<extLen) return false;
+  return file.compare(file.size()-extLen,extLen,DIV_BACKUP_EXT)==0;
+}
+
+bool DivBackupStore::lock() {
+  for (int i=0; i<2; i++) {
+    int result=touchFile(lockPath.c_str());
+    if (result==0) return true;
+    if (result!=-EEXIST) {
+      logW("backup: could not create lock file! (%s)",strerror(-result));
+      return false;
+    }
+    // break a lock left behind by a crash
+    long age=getFileAge(lockPath.c_str());
+    if (age<DIV_BACKUP_LOCK_STALE) break;
+    logW("backup: removing stale lock file.");
+    deleteFile(lockPath.c_str());
+  }
+  return false;
+}
+
+void DivBackupStore::unlock() {
+  deleteFile(lockPath.c_str());
+}
+
+int DivBackupStore::save(const String& manifest, const unsigned char* buf, size_t len, const std::vector<size_t>& blocks) {
+  if (!dirExists(chunkPath.c_str())) {
+    if (!makeDir(chunkPath.c_str())) {
+      logW("backup: could not create chunk directory!");
+      return -1;
+    }
+  }
+
+  if (!lock()) {
+    logW("backup: the backup directory is in use by another instance.");
+    return -1;
+  }
+  int ret=saveLocked(manifest,buf,len,blocks);
+  unlock();
+  return ret;
+}
+
+int DivBackupStore::saveLocked(const String& manifest, const unsigned char* buf, size_t len, const std::vector<size_t>& blocks) {
+  // split the file at each block
+  String out=fmt::sprintf("%s\n%" PRIu64 "\n",DIV_BACKUP_MAGIC,(uint64_t)len);
+  int newChunks=0;
+  size_t start=0;
+  for (size_t i=0; i<=blocks.size(); i++) {
+    size_t end=(i<blocks.size())?blocks[i]:len;
+    if (end<start || end>len) {
+      logW("backup: block %d is out of order!",(int)i);
+      return -1;
+    }
+    if (end==start) continue;
+
+    String key=getChunkKey(buf+start,end-start);
+    if (fileExists(getChunkFileName(key).c_str())!=1) {
+      if (!writeChunk(key,buf+start,end-start)) return -1;
+      newChunks++;
+    }
+    out+=key;
+    out+='\n';
+    start=end;
+  }
+
+  String tempName=manifest+".tmp";
+  FILE* f=ps_fopen(tempName.c_str(),"wb");
+  if (f==NULL) {
+    logW("backup: could not save backup point! (%s)",strerror(errno));
+    return -1;
+  }
+  bool ok=(fwrite(out.c_str(),1,out.size(),f)==out.size());
+  if (fclose(f)!=0) ok=false;
+  if (!ok || !moveFiles(tempName.c_str(),manifest.c_str())) {
+    logW("backup: could not write backup point!");
+    deleteFile(tempName.c_str());
+    return -1;
+  }
+  return newChunks;
+}
+
+unsigned char* DivBackupStore::restore(const String& manifest, size_t& len) {
+  std::vector<String> keys;
+  size_t totalLen=0;
+  if (!readManifest(manifest,totalLen,keys) || totalLen==0) {
+    logE("backup: invalid backup point!");
+    return NULL;
+  }
+
+  unsigned char* ret=new unsigned char[totalLen];
+  size_t pos=0;
+  for (String& i: keys) {
+    // the length is part of the key
+    size_t dash=i.rfind('-');
+    if (dash==String::npos) {
+      logE("backup: invalid chunk key %s!",i);
+      delete[] ret;
+      return NULL;
+    }
+    size_t chunkLen=strtoull(i.c_str()+dash+1,NULL,16);
+    if (chunkLen>totalLen-pos) {
+      logE("backup: chunk %s goes past the end!",i);
+      delete[] ret;
+      return NULL;
+    }
+
+    unsigned char* comp=NULL;
+    size_t compLen=0;
+    bool mapped=false;
+    if (mapFile(getChunkFileName(i).c_str(),comp,compLen,mapped)<0 || comp==NULL) {
+      logE("backup: chunk %s is missing!",i);
+      delete[] ret;
+      return NULL;
+    }
+    uLongf outLen=chunkLen;
+    int result=uncompress(ret+pos,&outLen,comp,compLen);
+    unmapFile(comp,compLen,mapped);
+    if (result!=Z_OK || outLen!=chunkLen) {
+      logE("backup: chunk %s is damaged!",i);
+      delete[] ret;
+      return NULL;
+    }
+    pos+=chunkLen;
+  }
+  if (pos!=totalLen) {
+    logE("backup: backup point is incomplete!");
+    delete[] ret;
+    return NULL;
+  }
+
+  len=totalLen;
+  return ret;
+}
+
+void DivBackupStore::collectGarbage() {
+  // another instance may be writing a backup point which reuses a chunk
+  if (!lock()) return;
+
+  std::set<String> used;
+  std::vector<String> keys;
+  size_t totalLen;
+  for (String& i: listDir(path,DIV_BACKUP_EXT)) {
+    if (!readManifest(path+String(DIR_SEPARATOR_STR)+i,totalLen,keys)) continue;
+    for (String& j: keys) used.insert(j);
+  }
+
+  int deleted=0;
+  for (String& i: listDir(chunkPath,"")) {
+    if (used.find(i)!=used.end()) continue;
+    // partial chunks are left alone
+    if (i.size()>=4 && i.compare(i.size()-4,4,".tmp")==0) continue;
+    deleteFile(getChunkFileName(i).c_str());
+    deleted++;
+  }
+  if (deleted>0) logD("backup: deleted %d unused chunks",deleted);
+  unlock();
+}
+
+DivBackupStore::DivBackupStore(const String& dir):
+  path(dir),
+  chunkPath(dir+String(DIR_SEPARATOR_STR)+String(DIV_BACKUP_CHUNK_DIR)),
+  lockPath(dir+String(DIR_SEPARATOR_STR)+String(DIV_BACKUP_LOCK)) {
+}
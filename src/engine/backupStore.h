@@ -0,0 +1,90 @@
+/**
+ * Furnace Tracker - multi-system chiptune tracker
+ * Copyright (C) 2021-2024 tildearrow and contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _BACKUPSTORE_H
+#define _BACKUPSTORE_H
+
+#include "../ta-utils.h"
+#include <vector>
+
+#define DIV_BACKUP_MAGIC "Furnace backup 1"
+#define DIV_BACKUP_EXT ".fbk"
+#define DIV_BACKUP_CHUNK_DIR "chunks"
+#define DIV_BACKUP_LOCK "lock"
+// a lock older than this (in seconds) was left behind by a crash
+#define DIV_BACKUP_LOCK_STALE 300
+
+/**
+ * a deduplicated store of song backups.
+ * a backup point is a small text file listing the chunks which make up a .fur,
+ * in order. each chunk is an instrument, wavetable, sample or pattern block
+ * (or the header before them), stored compressed under its hash.
+ * unchanged blocks produce the same chunk, so only what changed is written.
+ * several instances may share a store. saving and garbage collection take a
+ * lock file, so that a chunk is never deleted while a backup point which
+ * reuses it is being written.
+ */
+class DivBackupStore {
+  String path;
+  String chunkPath;
+  String lockPath;
+
+  bool lock();
+  void unlock();
+  int saveLocked(const String& manifest, const unsigned char* buf, size_t len, const std::vector<size_t>& blocks);
+  String getChunkKey(const unsigned char* data, size_t len);
+  String getChunkFileName(const String& key);
+  bool writeChunk(const String& key, const unsigned char* data, size_t len);
+  bool readManifest(const String& manifest, size_t& totalLen, std::vector<String>& keys);
+  std::vector<String> listDir(const String& dir, const char* ext);
+
+  public:
+    /**
+     * whether a file is a backup point.
+     */
+    static bool isBackupPoint(const String& file);
+
+    /**
+     * save a backup point.
+     * @param manifest path of the backup point.
+     * @param buf a .fur file.
+     * @param len its length.
+     * @param blocks where each block starts, in ascending order.
+     * @return the number of new chunks, or -1 on error (or if another instance is using the store).
+     */
+    int save(const String& manifest, const unsigned char* buf, size_t len, const std::vector<size_t>& blocks);
+
+    /**
+     * rebuild the .fur of a backup point.
+     * @param manifest path of the backup point.
+     * @param len set to the length of the file.
+     * @return the file (to be freed with delete[]), or NULL on error.
+     */
+    unsigned char* restore(const String& manifest, size_t& len);
+
+    /**
+     * delete chunks which no backup point refers to.
+     * does nothing if another instance is using the store.
+     */
+    void collectGarbage();
+
+    DivBackupStore(const String& dir);
+};
+
+#endif
@@ -36,6 +36,8 @@
 
 // dispatch
 #define DIV_MAX_OUTPUTS 16
+// maximum number of segments rendered at once in tick-ahead mode
+#define DIV_MAX_TICK_AHEAD 16
 #define DIV_NOTE_NULL 0x7fffffff
 
 #endif
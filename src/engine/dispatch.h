@@ -308,11 +308,6 @@ struct DivPitchTable {
   }
 };
 
-struct DivDelayedCommand {
-  int ticks;
-  DivCommand cmd;
-};
-
 struct DivRegWrite {
   /**
    * an address of 0xffffxx00 indicates a Furnace specific command.
@@ -362,22 +357,118 @@ struct DivSamplePos {
     freq(0) {}
 };
 
+/**
+ * per-channel oscilloscope tap.
+ * the buffer is only allocated once the tap is enabled, and stays until the tap is destroyed
+ * so that readers never see it go away.
+ */
 struct DivDispatchOscBuffer {
   bool follow;
+  bool enabled;
   unsigned int rate;
   unsigned short needle;
   unsigned short readNeedle;
   unsigned short followNeedle;
-  short data[65536];
+  short* data;
+
+  /**
+   * write a sample. does nothing while the tap is disabled.
+   */
+  inline void putSample(short val) {
+    if (enabled) data[needle++]=val;
+  }
+
+  /**
+   * enable or disable the tap, allocating the buffer if necessary.
+   * must not run at the same time as acquire().
+   */
+  void setEnabled(bool enable) {
+    if (enable && data==NULL) {
+      data=new short[65536];
+      memset(data,0,65536*sizeof(short));
+      needle=0;
+      readNeedle=0;
+    }
+    enabled=enable;
+  }
+
+  bool isEnabled() {
+    return enabled;
+  }
+
+  /**
+   * clear the buffer and rewind.
+   */
+  void reset() {
+    if (data!=NULL) memset(data,0,65536*sizeof(short));
+    needle=0;
+    readNeedle=0;
+  }
 
   DivDispatchOscBuffer():
     follow(true),
+    enabled(false),
     rate(65536),
     needle(0),
     readNeedle(0),
-    followNeedle(0) {
-    memset(data,0,65536*sizeof(short));
+    followNeedle(0),
+    data(NULL) {}
+  ~DivDispatchOscBuffer() {
+    if (data!=NULL) {
+      delete[] data;
+      data=NULL;
+    }
+  }
+};
+
+/**
+ * output of DivDispatch::acquireSpans().
+ * only the positions where the output changes are stored, along with the new value.
+ * the output keeps its value until the next change.
+ * the engine owns the storage, which has room for a change on every sample.
+ */
+struct DivSpanBuffer {
+  unsigned int* pos;
+  short* val;
+  size_t len;
+  // added to every position (set by the engine)
+  size_t offset;
+  // current value of the output
+  short last;
+
+  /**
+   * write a sample. it is only stored if it differs from the previous one.
+   * @param p the position within the current acquire.
+   * @param v the sample.
+   */
+  inline void put(size_t p, short v) {
+    if (v==last) return;
+    last=v;
+    pos[len]=offset+p;
+    val[len++]=v;
+  }
+
+  DivSpanBuffer():
+    pos(NULL),
+    val(NULL),
+    len(0),
+    offset(0),
+    last(0) {}
+};
+
+/**
+ * a plain output buffer with the same put() as DivSpanBuffer, so that a
+ * render loop can be written once for acquire() and acquireSpans().
+ */
+struct DivSampleSink {
+  short* buf;
+
+  inline void put(size_t p, short v) {
+    buf[p]=v;
   }
+
+  DivSampleSink(short* b=NULL):
+    buf(b) {}
 };
 
 struct DivChannelPair {
@@ -441,6 +532,16 @@ class DivDispatch {
      * please honor these variables if needed.
      */
     bool skipRegisterWrites, dumpWrites;
+    /**
+     * tick-ahead stamps (see DivEngine::nextBuf).
+     * writeStamp is the stamp of the tick currently being processed.
+     * acquireStamp is the stamp of the tick which precedes the samples
+     * currently being acquired.
+     * if you implement getTickAheadSupported(), tag your queued writes with
+     * writeStamp and don't apply them in acquire() until TICK_AHEAD_READY.
+     */
+    unsigned int writeStamp=0;
+    unsigned int acquireStamp=0;
   public:
     /**
      * the rate the samples are provided.
@@ -455,6 +556,12 @@ class DivDispatch {
      */
     int chipClock;
 
+    /**
+     * samples since the output last changed or the chip was last woken up.
+     * managed by the engine (see canSleep()).
+     */
+    size_t sleepIdle=0;
+
     /**
      * fill a buffer with sound data.
      * @param buf pointers to output buffers.
@@ -462,6 +569,16 @@ class DivDispatch {
      */
     virtual void acquire(short** buf, size_t len);
 
+    /**
+     * fill span buffers with sound data.
+     * this is used instead of acquire() if getSpansSupported() returns true.
+     * it is meant for chips running at a very high rate (usually one sample per chip clock)
+     * whose output rarely changes, since it saves the engine from looking at every sample.
+     * @param out one span buffer per output.
+     * @param len the amount of samples to fill.
+     */
+    virtual void acquireSpans(DivSpanBuffer* out, size_t len);
+
     /**
      * fill a write stream with data (e.g. for software-mixed PCM).
      * @param stream the write stream.
@@ -559,18 +676,32 @@ class DivDispatch {
     virtual int getRegisterPoolDepth();
 
     /**
-     * get this dispatch's state. DO NOT IMPLEMENT YET.
-     * @return a pointer to the dispatch's state. must be deallocated manually!
+     * check whether this dispatch can save and restore its state.
+     * @return whether getState() and setState() are implemented.
+     */
+    virtual bool getStateSupported();
+
+    /**
+     * get this dispatch's state.
+     * only the dispatch's own channel state is saved, not the chip's (register writes
+     * are skipped while seeking anyway).
+     * @return a pointer to the dispatch's state. must be deallocated with freeState()!
      */
     virtual void* getState();
 
     /**
-     * set this dispatch's state. DO NOT IMPLEMENT YET.
+     * set this dispatch's state.
      * @param state a pointer to a state pertaining to this dispatch,
      * or NULL if this dispatch does not support state saves.
      */
     virtual void setState(void* state);
 
+    /**
+     * deallocate a state returned by getState().
+     * @param state the state.
+     */
+    virtual void freeState(void* state);
+
     /**
      * mute a channel.
      * @param ch the channel to mute.
@@ -644,6 +775,59 @@ class DivDispatch {
      */
     virtual bool getWantPreNote();
 
+    /**
+     * check whether this dispatch can be rendered in tick-ahead mode.
+     * only return true if every change to the emulated chip goes through the
+     * write queue, and if acquire() does not read channel state.
+     * @return truth.
+     */
+    virtual bool getTickAheadSupported();
+
+    /**
+     * check whether the write queue is running out of room in tick-ahead mode.
+     * if so, the engine renders what is pending before running another tick,
+     * so that no write is dropped.
+     * @return truth.
+     */
+    virtual bool getTickAheadQueueFull();
+
+    /**
+     * check whether acquireSpans() shall be used instead of acquire().
+     * this may only change in init() or setFlags().
+     * @return truth.
+     */
+    virtual bool getSpansSupported();
+
+    /**
+     * check whether this chip may be put to sleep now.
+     * the engine asks once the output has been flat for a while. a sleeping chip is not acquired and its output is held
+     * until it is woken up by wakeUp() or a command.
+     * only return true if nothing is queued and no noise or LFO would be heard after waking up,
+     * and call wakeUp() on every register write.
+     * oscillator phases are frozen while asleep, so sleeping is off by default and never used when exporting.
+     * @return truth.
+     */
+    virtual bool canSleep();
+
+    /**
+     * restart the idle count, waking the chip up if it is sleeping.
+     */
+    inline void wakeUp() {
+      sleepIdle=0;
+    }
+
+    /**
+     * set the tick-ahead stamp for subsequent writes.
+     * @param stamp the stamp.
+     */
+    void setWriteStamp(unsigned int stamp);
+
+    /**
+     * set the tick-ahead stamp for the next acquire.
+     * @param stamp the stamp.
+     */
+    void setAcquireStamp(unsigned int stamp);
+
     /**
      * get minimum chip clock.
      * @return clock in Hz, or 0 if custom clocks are not supported.
@@ -764,6 +948,14 @@ class DivDispatch {
      */
     virtual void renderSamples(int sysID);
 
+    /**
+     * use the samples of another instance of this chip instead of rendering them.
+     * only called if both have the same flags and sample set.
+     * @param from the other instance.
+     * @return whether this is supported. if false, samples will be rendered.
+     */
+    virtual bool shareSamples(DivDispatch* from);
+
     /**
      * tell this DivDispatch that the tuning and/or pitch linearity has changed, and therefore the pitch table must be regenerated.
      */
@@ -795,6 +987,12 @@ class DivDispatch {
     if (chipClock<getClockRangeMin()) chipClock=getClockRangeMin(); \
   }
 
+// tick-ahead helper define. use it to check whether a queued write may be applied in acquire().
+#define TICK_AHEAD_READY(w) ((int)((w).stamp-acquireStamp)<=0)
+
+// tick-ahead helper define. use it in getTickAheadQueueFull() to leave room for another tick's writes.
+#define TICK_AHEAD_QUEUE_FULL(q) ((q).size()>=((q).capacity()>>1))
+
 // NOTE: these definitions may be deprecated in the future. see DivPitchTable.
 // pitch calculation:
 // - a DivDispatch usually contains four variables per channel:
@@ -115,6 +115,22 @@ void DivDispatchContainer::grow(size_t size) {
       delete[] bbIn[i];
       bbIn[i]=new short[bbInLen];
     }
+    if (spans[i].pos!=NULL) {
+      delete[] spans[i].pos;
+      spans[i].pos=new unsigned int[bbInLen];
+    }
+    spans[i].val=bbIn[i];
+    spans[i].len=0;
+  }
+}
+
+void DivDispatchContainer::reserve(size_t size) {
+  if (dispatch==NULL || rateMemory<=0.0) return;
+  // input clocks for that many output samples, plus some room for the remainder
+  size_t needed=(size_t)((double)size*(double)dispatch->rate/rateMemory)+256;
+  if (needed>bbInLen) {
+    logD("reserving %d bbIn samples",needed);
+    grow(needed);
   }
 }
 
@@ -136,6 +152,9 @@ void DivDispatchContainer::grow(size_t size) {
  \
       if (bbIn[i]==NULL) bbIn[i]=new short[bbInLen]; \
       if (bbOut[i]==NULL) bbOut[i]=new short[bbInLen]; \
+      if (spans[i].pos==NULL) spans[i].pos=new unsigned int[bbInLen]; \
+      spans[i].val=bbIn[i]; \
+      spans[i].len=0; \
       memset(bbIn[i],0,bbInLen*sizeof(short)); \
       memset(bbOut[i],0,bbInLen*sizeof(short)); \
       mustClear=true; \
@@ -143,21 +162,108 @@ void DivDispatchContainer::grow(size_t size) {
   } \
   if (mustClear) clear(); \
 
+// a chip may sleep after its output has been flat for a quarter of a second
+#define DIV_SLEEP_AFTER(rate) ((size_t)(rate)>>2)
+
 void DivDispatchContainer::acquire(size_t offset, size_t count) {
   CHECK_MISSING_BUFS;
 
-  for (int i=0; i<DIV_MAX_OUTPUTS; i++) {
-    if (i>=outs) {
-      bbInMapped[i]=NULL;
-    } else {
-      if (bbIn[i]==NULL) {
+  bool useSpans=dispatch->getSpansSupported();
+  bool mayIdle=sleepEnabled && dispatch->canSleep();
+  size_t spanLen[DIV_MAX_OUTPUTS];
+
+  if (useSpans) {
+    for (int i=0; i<outs; i++) {
+      // a buffer always begins at 0. discard changes left over from a buffer which was not filled
+      if (offset==0) spans[i].len=0;
+      spans[i].offset=offset;
+      spanLen[i]=spans[i].len;
+    }
+  }
+
+  if (!mayIdle) {
+    dispatch->sleepIdle=0;
+  } else if (dispatch->sleepIdle>=DIV_SLEEP_AFTER(dispatch->rate)) {
+    // sleeping. hold the output (spans don't need anything)
+    if (!useSpans) {
+      for (int i=0; i<outs; i++) {
+        if (bbIn[i]==NULL) continue;
+        for (size_t j=0; j<count; j++) {
+          bbIn[i][offset+j]=sleepOut[i];
+        }
+      }
+    }
+    return;
+  }
+
+  uint64_t profBegin=divProfNow();
+  if (useSpans) {
+    dispatch->acquireSpans(spans,count);
+  } else {
+    for (int i=0; i<DIV_MAX_OUTPUTS; i++) {
+      if (i>=outs) {
         bbInMapped[i]=NULL;
       } else {
-        bbInMapped[i]=&bbIn[i][offset];
+        if (bbIn[i]==NULL) {
+          bbInMapped[i]=NULL;
+        } else {
+          bbInMapped[i]=&bbIn[i][offset];
+        }
       }
     }
+    dispatch->acquire(bbInMapped,count);
   }
-  dispatch->acquire(bbInMapped,count);
+  profAcquire+=divProfNow()-profBegin;
+
+  if (mayIdle) {
+    // count how long the output stays flat
+    bool flat=true;
+    for (int i=0; i<outs && flat; i++) {
+      if (useSpans) {
+        if (spans[i].len!=spanLen[i]) flat=false;
+      } else if (bbIn[i]!=NULL) {
+        for (size_t j=0; j<count; j++) {
+          if (bbIn[i][offset+j]!=sleepOut[i]) {
+            flat=false;
+            break;
+          }
+        }
+      }
+    }
+    if (flat) {
+      dispatch->sleepIdle+=count;
+    } else {
+      dispatch->sleepIdle=0;
+    }
+  }
+  for (int i=0; i<outs; i++) {
+    if (useSpans) {
+      sleepOut[i]=spans[i].last;
+    } else if (bbIn[i]!=NULL && count>0) {
+      sleepOut[i]=bbIn[i][offset+count-1];
+    }
+  }
+}
+
+void DivDispatchContainer::pushAhead(size_t count, unsigned int stamp) {
+  if (aheadCount>=DIV_MAX_TICK_AHEAD) {
+    logE("tick-ahead segment overflow!");
+    return;
+  }
+  aheadPos[aheadCount]=runPos;
+  aheadLen[aheadCount]=count;
+  aheadStamp[aheadCount]=stamp;
+  aheadCount++;
+  runLeft-=count;
+  runPos+=count;
+}
+
+void DivDispatchContainer::acquireAhead() {
+  for (int i=0; i<aheadCount; i++) {
+    dispatch->setAcquireStamp(aheadStamp[i]);
+    acquire(aheadPos[i],aheadLen[i]);
+  }
+  aheadCount=0;
 }
 
 void DivDispatchContainer::flush(size_t count) {
@@ -172,16 +278,43 @@ void DivDispatchContainer::flush(size_t count) {
 void DivDispatchContainer::fillBuf(size_t runtotal, size_t offset, size_t size) {
   CHECK_MISSING_BUFS;
 
+  uint64_t profBegin=divProfNow();
+  bool useSpans=dispatch->getSpansSupported();
+
   if (dcOffCompensation && runtotal>0) {
     dcOffCompensation=false;
     if (hiPass) {
       for (int i=0; i<outs; i++) {
         if (bbIn[i]==NULL) continue;
-        prevSample[i]=bbIn[i][0];
+        if (useSpans) {
+          // the first sample is the current value unless it changes right away
+          prevSample[i]=(spans[i].len>0 && spans[i].pos[0]==0)?spans[i].val[0]:temp[i];
+        } else {
+          prevSample[i]=bbIn[i][0];
+        }
       }
     }
   }
-  if (lowQuality) {
+  if (useSpans) {
+    // constant stretches cost nothing here
+    for (int i=0; i<outs; i++) {
+      DivSpanBuffer& s=spans[i];
+      if (bb[i]==NULL) continue;
+      if (lowQuality) {
+        for (size_t j=0; j<s.len; j++) {
+          blip_add_delta_fast(bb[i],s.pos[j],s.val[j]-prevSample[i]);
+          prevSample[i]=s.val[j];
+        }
+      } else {
+        for (size_t j=0; j<s.len; j++) {
+          blip_add_delta(bb[i],s.pos[j],s.val[j]-prevSample[i]);
+          prevSample[i]=s.val[j];
+        }
+      }
+      temp[i]=s.last;
+      s.len=0;
+    }
+  } else if (lowQuality) {
     for (int i=0; i<outs; i++) {
       if (bbIn[i]==NULL) continue;
       if (bb[i]==NULL) continue;
@@ -211,6 +344,7 @@ void DivDispatchContainer::fillBuf(size_t runtotal, size_t offset, size_t size)
     blip_end_frame(bb[i],runtotal);
     blip_read_samples(bb[i],bbOut[i]+offset,size,0);
   }
+  profFill+=divProfNow()-profBegin;
   /*if (totalRead<(int)size && totalRead>0) {
     for (size_t i=totalRead; i<size; i++) {
       bbOut[0][i]=bbOut[0][totalRead-1];//bbOut[0][totalRead];
@@ -223,7 +357,10 @@ void DivDispatchContainer::clear() {
     if (bb[i]!=NULL) blip_clear(bb[i]);
     temp[i]=0;
     prevSample[i]=0;
+    spans[i].last=0;
+    sleepOut[i]=0;
   }
+  dispatch->sleepIdle=0;
 
   if (dispatch->getDCOffRequired() && hiPass) {
     dcOffCompensation=true;
@@ -665,6 +802,8 @@ void DivDispatchContainer::init(DivSystem sys, DivEngine* eng, int chanCount, do
       break;
   }
   dispatch->init(eng,chanCount,gotRate,flags);
+  // set by the engine on every buffer
+  sleepEnabled=false;
 
   // initialize output buffers
   int outs=dispatch->getOutputCount();
@@ -679,6 +818,9 @@ void DivDispatchContainer::init(DivSystem sys, DivEngine* eng, int chanCount, do
 
     bbIn[i]=new short[bbInLen];
     bbOut[i]=new short[bbInLen];
+    spans[i].pos=new unsigned int[bbInLen];
+    spans[i].val=bbIn[i];
+    spans[i].len=0;
     memset(bbIn[i],0,bbInLen*sizeof(short));
     memset(bbOut[i],0,bbInLen*sizeof(short));
     blip_set_dc(bb[i],hiPass);
@@ -700,6 +842,13 @@ void DivDispatchContainer::quit() {
       delete[] bbIn[i];
       bbIn[i]=NULL;
     }
+    if (spans[i].pos!=NULL) {
+      delete[] spans[i].pos;
+      spans[i].pos=NULL;
+    }
+    spans[i].val=NULL;
+    spans[i].len=0;
+    spans[i].last=0;
     if (bb[i]!=NULL) {
       blip_delete(bb[i]);
       bb[i]=NULL;
@@ -24,6 +24,7 @@
 #include "instrument.h"
 #include "safeReader.h"
 #include "workPool.h"
+#include "renderAhead.h"
 #include "../ta-log.h"
 #include "../fileutils.h"
 #ifdef HAVE_SDL2
@@ -41,7 +42,7 @@
 #include <fmt/printf.h>
 
 void process(void* u, float** in, float** out, int inChans, int outChans, unsigned int size) {
-  ((DivEngine*)u)->nextBuf(in,out,inChans,outChans,size);
+  ((DivEngine*)u)->processAudio(in,out,inChans,outChans,size);
 }
 
 const char* DivEngine::getEffectDesc(unsigned char effect, int chan, bool notNull) {
@@ -250,6 +251,7 @@ double DivEngine::benchmarkPlayback() {
   prevOrder=0;
   remainingLoops=1;
   playSub(false);
+  profiler.reset();
 
   std::chrono::high_resolution_clock::time_point timeStart=std::chrono::high_resolution_clock::now();
 
@@ -268,6 +270,14 @@ double DivEngine::benchmarkPlayback() {
   return t;
 }
 
+String DivEngine::getProfilerJSON() {
+  const char* chipNames[DIV_MAX_CHIPS];
+  for (int i=0; i<song.systemLen; i++) {
+    chipNames[i]=getSystemName(song.system[i]);
+  }
+  return profiler.toJSON(chipNames,song.systemLen);
+}
+
 double DivEngine::benchmarkSeek() {
   double t[20];
   curOrder=curSubSong->ordersLen-1;
@@ -408,6 +418,19 @@ void DivEngine::renderSamplesP(int whichSample) {
   BUSY_END;
 }
 
+struct DivSampleRenderTask {
+  DivSong* song;
+  unsigned int formatMask;
+  int first, stride;
+  int rendered;
+  DivSampleRenderTask():
+    song(NULL),
+    formatMask(0),
+    first(0),
+    stride(1),
+    rendered(0) {}
+};
+
 void DivEngine::renderSamples(int whichSample) {
   sPreview.sample=-1;
   sPreview.pos=0;
@@ -424,22 +447,75 @@ void DivEngine::renderSamples(int whichSample) {
   }
 
   // step 1: render samples
+  // samples are independent of each other, so they are rendered in parallel.
+  // formats which are up to date are skipped.
+  int rendered=0;
   if (whichSample==-1) {
-    for (int i=0; i<song.sampleLen; i++) {
-      song.sample[i]->render(formatMask);
+    unsigned int howManyThreads=std::thread::hardware_concurrency();
+    if (howManyThreads>(unsigned int)song.sampleLen) howManyThreads=song.sampleLen;
+    if (howManyThreads<2) {
+      for (int i=0; i<song.sampleLen; i++) {
+        rendered+=song.sample[i]->render(formatMask);
+      }
+    } else {
+      // each task renders every Nth sample
+      unsigned int taskCount=MIN(howManyThreads*4,(unsigned int)song.sampleLen);
+      DivSampleRenderTask* tasks=new DivSampleRenderTask[taskCount];
+      DivWorkPool* pool=new DivWorkPool(howManyThreads);
+      for (unsigned int i=0; i<taskCount; i++) {
+        tasks[i].song=&song;
+        tasks[i].formatMask=formatMask;
+        tasks[i].first=i;
+        tasks[i].stride=taskCount;
+        pool->push([](void* d) {
+          DivSampleRenderTask* t=(DivSampleRenderTask*)d;
+          for (int j=t->first; j<t->song->sampleLen; j+=t->stride) {
+            t->rendered+=t->song->sample[j]->render(t->formatMask);
+          }
+        },&tasks[i]);
+      }
+      pool->wait();
+      delete pool;
+      for (unsigned int i=0; i<taskCount; i++) {
+        rendered+=tasks[i].rendered;
+      }
+      delete[] tasks;
     }
   } else if (whichSample>=0 && whichSample<song.sampleLen) {
-    song.sample[whichSample]->render(formatMask);
+    rendered+=song.sample[whichSample]->render(formatMask);
   }
+  logD("%d sample formats rendered",rendered);
 
   // step 2: render samples to dispatch
+  // identical chips share the memory of the first one
   for (int i=0; i<song.systemLen; i++) {
-    if (disCont[i].dispatch!=NULL) {
-      disCont[i].dispatch->renderSamples(i);
+    if (disCont[i].dispatch==NULL) continue;
+    bool shared=false;
+    for (int j=0; j<i; j++) {
+      if (!isSampleLayoutEqual(i,j)) continue;
+      if (disCont[i].dispatch->shareSamples(disCont[j].dispatch)) {
+        logV("chip %d shares sample memory with chip %d",i,j);
+        shared=true;
+      }
+      break;
     }
+    if (!shared) disCont[i].dispatch->renderSamples(i);
   }
 }
 
+bool DivEngine::isSampleLayoutEqual(int a, int b) {
+  if (disCont[a].dispatch==NULL || disCont[b].dispatch==NULL) return false;
+  if (song.system[a]!=song.system[b]) return false;
+  if (song.systemFlags[a].toString()!=song.systemFlags[b].toString()) return false;
+  for (int i=0; i<song.sampleLen; i++) {
+    DivSample* s=song.sample[i];
+    for (int j=0; j<DIV_MAX_SAMPLE_TYPE; j++) {
+      if (s->renderOn[j][a]!=s->renderOn[j][b]) return false;
+    }
+  }
+  return true;
+}
+
 String DivEngine::decodeSysDesc(String desc) {
   DivConfig newDesc;
   bool hasVal=false;
@@ -671,6 +747,7 @@ void DivEngine::changeSong(size_t songIndex) {
   curRow=0;
   prevOrder=0;
   prevRow=0;
+  clearCheckpoints();
 }
 
 void DivEngine::moveAsset(std::vector<DivAssetDir>& dir, int before, int after) {
@@ -1319,6 +1396,19 @@ String DivEngine::getWarnings() {
 }
 
 String DivEngine::getPlaybackDebugInfo() {
+  unsigned int poolThreads=0, poolSteals=0, poolParks=0, poolInlined=0;
+  unsigned long long poolIdleTime=0;
+  unsigned int aheadLatency=0, aheadUnderruns=0;
+  unsigned long long aheadMissed=0;
+  size_t aheadFill=0;
+  if (renderPool!=NULL) {
+    poolThreads=renderPool->getThreadCount();
+    renderPool->getStats(poolSteals,poolParks,poolInlined,poolIdleTime);
+  }
+  if (renderAhead!=NULL) {
+    aheadLatency=renderAhead->getLatency();
+    renderAhead->getStats(aheadUnderruns,aheadMissed,aheadFill);
+  }
   return fmt::sprintf(
     "curOrder: %d\n"
     "prevOrder: %d\n"
@@ -1350,11 +1440,22 @@ String DivEngine::getPlaybackDebugInfo() {
     "extValue: %d\n"
     "tempoAccum: %d\n"
     "totalProcessed: %d\n"
-    "bufferPos: %d\n",
+    "bufferPos: %d\n"
+    "renderPool threads: %d\n"
+    "renderPool steals: %d\n"
+    "renderPool parks: %d\n"
+    "renderPool inlined: %d\n"
+    "renderPool idle time: %.2fms\n"
+    "renderAhead latency: %d\n"
+    "renderAhead fill: %d\n"
+    "renderAhead underruns: %d\n"
+    "renderAhead missed frames: %d\n",
     curOrder,prevOrder,curRow,prevRow,ticks,subticks,totalLoops,lastLoopPos,nextSpeed,divider,cycles,clockDrift,
     midiClockCycles,midiClockDrift,midiTimeCycles,midiTimeDrift,changeOrd,changePos,totalSeconds,totalTicks,
     totalTicksR,curMidiClock,curMidiTime,totalCmds,lastCmds,cmdsPerSecond,globalPitch,
-    (int)extValue,(int)tempoAccum,(int)totalProcessed,(int)bufferPos
+    (int)extValue,(int)tempoAccum,(int)totalProcessed,(int)bufferPos,
+    poolThreads,poolSteals,poolParks,poolInlined,(double)poolIdleTime/1000000.0,
+    aheadLatency,(int)aheadFill,aheadUnderruns,(int)aheadMissed
   );
 }
 
@@ -1454,7 +1555,25 @@ DivSamplePos DivEngine::getSamplePos(int chan) {
 
 DivDispatchOscBuffer* DivEngine::getOscBuffer(int chan) {
   if (chan<0 || chan>=chans) return NULL;
-  return disCont[dispatchOfChan[chan]].dispatch->getOscBuffer(dispatchChanOfChan[chan]);
+  DivDispatchOscBuffer* buf=disCont[dispatchOfChan[chan]].dispatch->getOscBuffer(dispatchChanOfChan[chan]);
+  if (buf==NULL) return NULL;
+  if (!buf->isEnabled()) return NULL;
+  return buf;
+}
+
+void DivEngine::applyOscTaps() {
+  for (int i=0; i<chans; i++) {
+    if (disCont[dispatchOfChan[i]].dispatch==NULL) continue;
+    DivDispatchOscBuffer* buf=disCont[dispatchOfChan[i]].dispatch->getOscBuffer(dispatchChanOfChan[i]);
+    if (buf!=NULL) buf->setEnabled(oscTapsEnabled);
+  }
+}
+
+void DivEngine::enableOscTaps(bool enable) {
+  BUSY_BEGIN;
+  oscTapsEnabled=enable;
+  applyOscTaps();
+  BUSY_END;
 }
 
 void DivEngine::enableCommandStream(bool enable) {
@@ -1521,7 +1640,18 @@ void DivEngine::playSub(bool preserveDrift, int goalRow) {
   memset(walked,0,8192);
   for (int i=0; i<song.systemLen; i++) disCont[i].dispatch->setSkipRegisterWrites(true);
   logV("goal: %d goalRow: %d",goal,goalRow);
+  if (checkpointsDirty.exchange(false)) clearCheckpoints();
+  bool useCheckpoints=(!preserveDrift && goal>0 && canCheckpoint());
+  int maxOrder=0;
+  unsigned int step=0;
+  if (useCheckpoints) {
+    if (loadCheckpoint(goal,maxOrder,step)) {
+      logV("resuming from checkpoint at order %d",curOrder);
+    }
+  }
   while (playing && curOrder<goal) {
+    int lastOrder=curOrder;
+    step++;
     if (nextTick(preserveDrift)) {
       skipping=false;
       cmdStream.clear();
@@ -1535,6 +1665,10 @@ void DivEngine::playSub(bool preserveDrift, int goalRow) {
       runMidiClock(cycles);
       runMidiTime(cycles);
     }
+    if (useCheckpoints && curOrder!=lastOrder) {
+      saveCheckpoint(maxOrder,step);
+    }
+    if (curOrder>maxOrder) maxOrder=curOrder;
   }
   int oldOrder=curOrder;
   while (playing && (curRow<goalRow || ticks>1)) {
@@ -1594,6 +1728,163 @@ void DivEngine::playSub(bool preserveDrift, int goalRow) {
   logV("playSub() took %dµs",std::chrono::duration_cast<std::chrono::microseconds>(timeEnd-timeStart).count());
 }
 
+bool DivEngine::canCheckpoint() {
+  if (curSubSong==NULL) return false;
+  for (int i=0; i<song.systemLen; i++) {
+    if (disCont[i].dispatch==NULL) return false;
+    if (!disCont[i].dispatch->getStateSupported()) return false;
+  }
+  return true;
+}
+
+void DivEngine::saveCheckpoint(int maxOrder, unsigned int step) {
+  if (curOrder<0 || curOrder>=DIV_MAX_PATTERNS) return;
+  if ((int)checkpoints.size()<=curOrder) {
+    checkpoints.resize(curOrder+1,NULL);
+  }
+  if (checkpoints[curOrder]!=NULL) return;
+
+  DivPlaybackCheckpoint* c=new DivPlaybackCheckpoint;
+  c->order=curOrder;
+  c->maxOrder=maxOrder;
+  c->step=step;
+
+  c->subticks=subticks;
+  c->ticks=ticks;
+  c->curRow=curRow;
+  c->curOrder=curOrder;
+  c->prevRow=prevRow;
+  c->prevOrder=prevOrder;
+  c->lastLoopPos=lastLoopPos;
+  c->nextSpeed=nextSpeed;
+  c->elapsedBars=elapsedBars;
+  c->elapsedBeats=elapsedBeats;
+  c->curSpeed=curSpeed;
+  c->divider=divider;
+  c->cycles=cycles;
+  c->clockDrift=clockDrift;
+  c->midiClockCycles=midiClockCycles;
+  c->midiClockDrift=midiClockDrift;
+  c->midiTimeCycles=midiTimeCycles;
+  c->midiTimeDrift=midiTimeDrift;
+  c->changeOrd=changeOrd;
+  c->changePos=changePos;
+  c->totalSeconds=totalSeconds;
+  c->totalTicks=totalTicks;
+  c->totalTicksR=totalTicksR;
+  c->curMidiClock=curMidiClock;
+  c->curMidiTime=curMidiTime;
+  c->globalPitch=globalPitch;
+  c->curMidiTimePiece=curMidiTimePiece;
+  c->curMidiTimeCode=curMidiTimeCode;
+  c->extValue=extValue;
+  c->pendingMetroTick=pendingMetroTick;
+  c->arpLen=curSubSong->arpLen;
+  c->endOfSong=endOfSong;
+  c->shallStopSched=shallStopSched;
+  c->firstTick=firstTick;
+  c->extValuePresent=extValuePresent;
+  c->speeds=speeds;
+  c->tempoAccum=tempoAccum;
+  c->chan.assign(chan,chan+chans);
+  memcpy(c->walked,walked,8192);
+
+  memset(c->dispatch,0,DIV_MAX_CHIPS*sizeof(DivDispatch*));
+  memset(c->dispatchState,0,DIV_MAX_CHIPS*sizeof(void*));
+  for (int i=0; i<song.systemLen; i++) {
+    c->dispatch[i]=disCont[i].dispatch;
+    c->dispatchState[i]=disCont[i].dispatch->getState();
+  }
+
+  checkpoints[curOrder]=c;
+}
+
+bool DivEngine::loadCheckpoint(int goal, int& maxOrder, unsigned int& step) {
+  DivPlaybackCheckpoint* best=NULL;
+  // a checkpoint leads to the goal if the walk never reached it before
+  for (size_t i=0; i<checkpoints.size(); i++) {
+    DivPlaybackCheckpoint* c=checkpoints[i];
+    if (c==NULL) continue;
+    if (c->order>goal || c->maxOrder>=goal) continue;
+    if (best==NULL || c->step>best->step) best=c;
+  }
+  if (best==NULL) return false;
+
+  // make sure the chips are still the same
+  if ((int)best->chan.size()!=chans) return false;
+  for (int i=0; i<song.systemLen; i++) {
+    if (best->dispatch[i]!=disCont[i].dispatch) return false;
+    if (best->dispatchState[i]==NULL) return false;
+  }
+
+  subticks=best->subticks;
+  ticks=best->ticks;
+  curRow=best->curRow;
+  curOrder=best->curOrder;
+  prevRow=best->prevRow;
+  prevOrder=best->prevOrder;
+  lastLoopPos=best->lastLoopPos;
+  nextSpeed=best->nextSpeed;
+  elapsedBars=best->elapsedBars;
+  elapsedBeats=best->elapsedBeats;
+  curSpeed=best->curSpeed;
+  divider=best->divider;
+  cycles=best->cycles;
+  clockDrift=best->clockDrift;
+  midiClockCycles=best->midiClockCycles;
+  midiClockDrift=best->midiClockDrift;
+  midiTimeCycles=best->midiTimeCycles;
+  midiTimeDrift=best->midiTimeDrift;
+  changeOrd=best->changeOrd;
+  changePos=best->changePos;
+  totalSeconds=best->totalSeconds;
+  totalTicks=best->totalTicks;
+  totalTicksR=best->totalTicksR;
+  curMidiClock=best->curMidiClock;
+  curMidiTime=best->curMidiTime;
+  globalPitch=best->globalPitch;
+  curMidiTimePiece=best->curMidiTimePiece;
+  curMidiTimeCode=best->curMidiTimeCode;
+  extValue=best->extValue;
+  pendingMetroTick=best->pendingMetroTick;
+  curSubSong->arpLen=best->arpLen;
+  endOfSong=best->endOfSong;
+  shallStopSched=best->shallStopSched;
+  firstTick=best->firstTick;
+  extValuePresent=best->extValuePresent;
+  speeds=best->speeds;
+  tempoAccum=best->tempoAccum;
+  for (int i=0; i<chans; i++) {
+    chan[i]=best->chan[i];
+  }
+  memcpy(walked,best->walked,8192);
+
+  for (int i=0; i<song.systemLen; i++) {
+    disCont[i].dispatch->setState(best->dispatchState[i]);
+  }
+
+  maxOrder=MAX(best->maxOrder,best->order);
+  step=best->step;
+  return true;
+}
+
+void DivEngine::clearCheckpoints() {
+  for (DivPlaybackCheckpoint* c: checkpoints) {
+    if (c==NULL) continue;
+    for (int i=0; i<DIV_MAX_CHIPS; i++) {
+      if (c->dispatch[i]!=NULL && c->dispatchState[i]!=NULL) {
+        c->dispatch[i]->freeState(c->dispatchState[i]);
+      }
+    }
+    delete c;
+  }
+  checkpoints.clear();
+}
+
+void DivEngine::invalidateCheckpoints() {
+  checkpointsDirty=true;
+}
+
 /*
 int DivEngine::calcBaseFreq(double clock, double divider, int note, bool period) {
   double base=(period?(song.tuning*0.0625):song.tuning)*pow(2.0,(float)(note+3)/12.0);
@@ -1893,11 +2184,7 @@ void DivEngine::stop() {
   // reset all chan oscs
   for (int i=0; i<chans; i++) {
     DivDispatchOscBuffer* buf=disCont[dispatchOfChan[i]].dispatch->getOscBuffer(dispatchChanOfChan[i]);
-    if (buf!=NULL) {
-      memset(buf->data,0,65536*sizeof(short));
-      buf->needle=0;
-      buf->readNeedle=0;
-    }
+    if (buf!=NULL) buf->reset();
   }
   BUSY_END;
 }
@@ -1968,6 +2255,8 @@ void DivEngine::recalcChans() {
   checkAssetDir(song.waveDir,song.wave.size());
   checkAssetDir(song.sampleDir,song.sample.size());
 
+  applyOscTaps();
+
   hasLoadedSomething=true;
 }
 
@@ -2002,6 +2291,10 @@ void DivEngine::reset() {
     disCont[i].dispatch->reset();
     disCont[i].clear();
   }
+  for (DivExportStem* i: stems) {
+    i->cont.dispatch->reset();
+    i->cont.clear();
+  }
 }
 
 void DivEngine::syncReset() {
@@ -2838,7 +3131,7 @@ void DivEngine::deepCloneOrder(int pos, bool where) {
         order[i]=j;
         DivPattern* oldPat=curPat[i].getPattern(origOrd,false);
         DivPattern* pat=curPat[i].getPattern(j,true);
-        memcpy(pat->data,oldPat->data,DIV_MAX_ROWS*DIV_MAX_COLS*sizeof(short));
+        pat->data=oldPat->data;
         logD("found at %d",j);
         didNotFind=false;
         break;
@@ -3307,6 +3600,8 @@ void DivEngine::updateSysFlags(int system, bool restart, bool render) {
   BUSY_BEGIN_SOFT;
   disCont[system].dispatch->setFlags(song.systemFlags[system]);
   disCont[system].setRates(got.rate);
+  // the chip rate may have changed
+  disCont[system].reserve(metroBufLen);
   if (render) renderSamples();
 
   // patchbay
@@ -3364,6 +3659,10 @@ void DivEngine::setConsoleMode(bool enable) {
   consoleMode=enable;
 }
 
+void DivEngine::setExportThreads(unsigned int count) {
+  exportThreads=count;
+}
+
 bool DivEngine::switchMaster(bool full) {
   logI("switching output...");
   deinitAudioBackend(true);
@@ -3380,6 +3679,7 @@ bool DivEngine::switchMaster(bool full) {
       disCont[i].setRates(got.rate);
       disCont[i].setQuality(lowQuality,dcHiPass);
     }
+    reserveBuffers(got.bufsize);
     if (!output->setRun(true)) {
       logE("error while activating audio!");
       return false;
@@ -3510,12 +3810,46 @@ void DivEngine::initDispatch(bool isRender) {
     saveLock.unlock();
   }
   recalcChans();
+  reserveBuffers(got.bufsize);
   BUSY_END;
 }
 
+void DivEngine::initRenderPool() {
+  if (renderPool!=NULL) return;
+  unsigned int howManyThreads=song.systemLen;
+  if (howManyThreads<2) howManyThreads=0;
+  if (howManyThreads>renderPoolThreads) howManyThreads=renderPoolThreads;
+  renderPool=new DivWorkPool(howManyThreads);
+}
+
+void DivEngine::reserveBuffers(unsigned int size) {
+  if (size<1) size=1;
+  if (metroTickLen<size) {
+    if (metroTick!=NULL) delete[] metroTick;
+    metroTick=new unsigned char[size];
+    metroTickLen=size;
+  }
+  if (metroBufLen<size) {
+    if (metroBuf!=NULL) delete[] metroBuf;
+    metroBuf=new float[size];
+    metroBufLen=size;
+  }
+  for (int i=0; i<song.systemLen; i++) {
+    disCont[i].reserve(size);
+  }
+  for (DivExportStem* i: stems) {
+    i->cont.reserve(size);
+  }
+  if (cmdStream.capacity()<DIV_CMD_STREAM_MAX) {
+    cmdStream.reserve(DIV_CMD_STREAM_MAX);
+  }
+  initRenderPool();
+}
+
 void DivEngine::quitDispatch() {
   BUSY_BEGIN;
   logV("terminating dispatch...");
+  clearCheckpoints();
   for (int i=0; i<song.systemLen; i++) {
     disCont[i].quit();
   }
@@ -3596,6 +3930,10 @@ bool DivEngine::initAudioBackend() {
   if (previewVol<0.0f) previewVol=0.0f;
   if (previewVol>1.0f) previewVol=1.0f;
   renderPoolThreads=getConfInt("renderPoolThreads",0);
+  chipSleep=getConfInt("chipSleep",0);
+  tickAhead=getConfInt("renderTickAhead",0);
+  renderAheadPeriods=getConfInt("renderAhead",0);
+  if (renderAheadPeriods>DIV_RENDER_AHEAD_MAX) renderAheadPeriods=DIV_RENDER_AHEAD_MAX;
 
   if (lowLatency) logI("using low latency mode.");
 
@@ -3682,6 +4020,11 @@ bool DivEngine::initAudioBackend() {
     memset(oscBuf[i],0,32768*sizeof(float));
   }
 
+  if (renderAheadPeriods>0) {
+    logI("using render-ahead thread (%d periods).",renderAheadPeriods);
+    renderAhead=new DivRenderAhead(this,got.outChans,got.rate,got.bufsize,renderAheadPeriods);
+  }
+
   logI("initializing MIDI.");
   if (output->initMidi(false)) {
     midiIns=output->midiIn->listDevices();
@@ -3722,6 +4065,10 @@ bool DivEngine::deinitAudioBackend(bool dueToSwitchMaster) {
   if (output!=NULL) {
     logI("closing audio output.");
     output->quit();
+    if (renderAhead!=NULL) {
+      delete renderAhead;
+      renderAhead=NULL;
+    }
     if (output->midiIn) {
       if (output->midiIn->isDeviceOpen()) {
         logI("closing MIDI input.");
@@ -3785,6 +4132,14 @@ bool DivEngine::preInit(bool noSafeMode) {
   return wantSafe;
 }
 
+void DivEngine::preInitFrom(const DivEngine& base) {
+  if (!systemsRegistered) registerSystems();
+
+  configPath=base.configPath;
+  configFile=base.configFile;
+  conf=base.conf;
+}
+
 void DivEngine::everythingOK() {
   // TODO: re-enable with a better approach
   // see issue #1581
@@ -3843,8 +4198,9 @@ bool DivEngine::init() {
   samp_bbIn=new short[32768];
   samp_bbInLen=32768;
 
-  metroBuf=new float[8192];
-  metroBufLen=8192;
+  // patchbay compilation storage (the audio thread may not allocate)
+  mixRoutes.resize(DIV_MAX_MIX_ROUTES);
+  mixPatchbay.reserve(DIV_MAX_MIX_ROUTES);
 
   logV("setting blip rate of samp_bb (%f)",got.rate);
   
@@ -3886,11 +4242,13 @@ bool DivEngine::init() {
   return true;
 }
 
-bool DivEngine::quit() {
+bool DivEngine::quit(bool saveConfig) {
   deinitAudioBackend();
   quitDispatch();
-  logI("saving config.");
-  saveConf();
+  if (saveConfig) {
+    logI("saving config.");
+    saveConf();
+  }
   active=false;
   for (int i=0; i<DIV_MAX_OUTPUTS; i++) {
     if (oscBuf[i]!=NULL) delete[] oscBuf[i];
@@ -3900,6 +4258,11 @@ bool DivEngine::quit() {
     metroBuf=NULL;
     metroBufLen=0;
   }
+  if (metroTick!=NULL) {
+    delete[] metroTick;
+    metroTick=NULL;
+    metroTickLen=0;
+  }
   if (yrw801ROM!=NULL) delete[] yrw801ROM;
   if (tg100ROM!=NULL) delete[] tg100ROM;
   if (mu5ROM!=NULL) delete[] mu5ROM;
@@ -28,6 +28,7 @@
 #include "dataErrors.h"
 #include "safeWriter.h"
 #include "cmdStream.h"
+#include "profiler.h"
 #include "../audio/taAudio.h"
 #include "blip_buf.h"
 #include <functional>
@@ -36,6 +37,7 @@
 #include "../fixedQueue.h"
 
 class DivWorkPool;
+class DivRenderAhead;
 
 #define addWarning(x) \
   if (warnings.empty()) { \
@@ -52,6 +54,9 @@ class DivWorkPool;
 #define EXTERN_BUSY_BEGIN_SOFT e->softLocked=true; e->isBusy.lock();
 #define EXTERN_BUSY_END e->isBusy.unlock(); e->softLocked=false;
 
+// commands kept for getCommandStream(). reserved ahead, as they're logged from the audio thread.
+#define DIV_CMD_STREAM_MAX 2000
+
 //#define DIV_UNSTABLE
 
 #define DIV_VERSION "0.6.1"
@@ -98,7 +103,6 @@ enum DivMIDIModes {
 };
 
 struct DivChannelState {
-  std::vector<DivDelayedCommand> delayed;
   int note, oldNote, lastIns, pitch, portaSpeed, portaNote;
   int volume, volSpeed, cut, rowDelay, volMax;
   int delayOrder, delayRow, retrigSpeed, retrigTick;
@@ -197,6 +201,41 @@ struct DivNoteEvent {
     fromMIDI(false) {}
 };
 
+/**
+ * a snapshot of playback state, taken during a seek when entering an order.
+ * used by playSub() to skip most of the walk from the beginning of the song.
+ * playback control (playing, halted, stepPlay, loop counts and stop requests)
+ * belongs to the caller and is not part of it.
+ */
+struct DivPlaybackCheckpoint {
+  // order this checkpoint was taken at
+  int order;
+  // highest order reached before this checkpoint
+  int maxOrder;
+  // how many ticks were walked to get here
+  unsigned int step;
+
+  int subticks, ticks, curRow, curOrder, prevRow, prevOrder, lastLoopPos, nextSpeed, elapsedBars, elapsedBeats, curSpeed;
+  double divider;
+  int cycles;
+  double clockDrift;
+  int midiClockCycles;
+  double midiClockDrift;
+  int midiTimeCycles;
+  double midiTimeDrift;
+  int changeOrd, changePos, totalSeconds, totalTicks, totalTicksR, curMidiClock, curMidiTime, globalPitch;
+  int curMidiTimePiece, curMidiTimeCode;
+  unsigned char extValue, pendingMetroTick, arpLen;
+  bool endOfSong, shallStopSched, firstTick, extValuePresent;
+  DivGroovePattern speeds;
+  short tempoAccum;
+  std::vector<DivChannelState> chan;
+  unsigned char walked[8192];
+
+  DivDispatch* dispatch[DIV_MAX_CHIPS];
+  void* dispatchState[DIV_MAX_CHIPS];
+};
+
 struct DivDispatchContainer {
   DivDispatch* dispatch;
   blip_buffer_t* bb[DIV_MAX_OUTPUTS];
@@ -205,17 +244,34 @@ struct DivDispatchContainer {
   short* bbInMapped[DIV_MAX_OUTPUTS];
   short* bbIn[DIV_MAX_OUTPUTS];
   short* bbOut[DIV_MAX_OUTPUTS];
-  bool lowQuality, dcOffCompensation, hiPass;
+  // changes in each output, if the dispatch supports spans. values are kept in bbIn
+  DivSpanBuffer spans[DIV_MAX_OUTPUTS];
+  // held output of a sleeping chip
+  short sleepOut[DIV_MAX_OUTPUTS];
+  bool lowQuality, dcOffCompensation, hiPass, sleepEnabled;
   double rateMemory;
 
   // used in multi-thread
   int cycles;
   unsigned int size;
 
+  // time spent in acquire() and fillBuf() during the current buffer (nanoseconds)
+  uint64_t profAcquire, profFill;
+
+  // used in tick-ahead mode
+  size_t aheadPos[DIV_MAX_TICK_AHEAD];
+  size_t aheadLen[DIV_MAX_TICK_AHEAD];
+  unsigned int aheadStamp[DIV_MAX_TICK_AHEAD];
+  int aheadCount;
+
   void setRates(double gotRate);
   void setQuality(bool lowQual, bool dcHiPass);
   void grow(size_t size);
+  // make room for buffers of up to this many output samples
+  void reserve(size_t size);
   void acquire(size_t offset, size_t count);
+  void pushAhead(size_t count, unsigned int stamp);
+  void acquireAhead();
   void flush(size_t count);
   void fillBuf(size_t runtotal, size_t offset, size_t size);
   void clear();
@@ -231,18 +287,75 @@ struct DivDispatchContainer {
     lowQuality(false),
     dcOffCompensation(false),
     hiPass(true),
+    sleepEnabled(false),
     rateMemory(0.0),
     cycles(0),
-    size(0) {
+    size(0),
+    profAcquire(0),
+    profFill(0),
+    aheadCount(0) {
     memset(bb,0,DIV_MAX_OUTPUTS*sizeof(blip_buffer_t*));
     memset(temp,0,DIV_MAX_OUTPUTS*sizeof(int));
     memset(prevSample,0,DIV_MAX_OUTPUTS*sizeof(int));
+    memset(sleepOut,0,DIV_MAX_OUTPUTS*sizeof(short));
     memset(bbIn,0,DIV_MAX_OUTPUTS*sizeof(short*));
     memset(bbInMapped,0,DIV_MAX_OUTPUTS*sizeof(short*));
     memset(bbOut,0,DIV_MAX_OUTPUTS*sizeof(short*));
   }
 };
 
+/**
+ * a copy of a chip which only plays some of its channels.
+ * it receives the same commands and ticks as the chip it mirrors, so that
+ * per-channel stems can be rendered in a single pass.
+ */
+struct DivExportStem {
+  DivDispatchContainer cont;
+  // chip index
+  int sys;
+  // engine channels heard in this stem (inclusive)
+  int firstChan, lastChan;
+  // mixed stereo output
+  float* out[2];
+  size_t outLen;
+
+  DivExportStem():
+    sys(0),
+    firstChan(0),
+    lastChan(0),
+    outLen(0) {
+    out[0]=NULL;
+    out[1]=NULL;
+  }
+};
+
+// every chip output to every system output, plus sample preview and metronome
+#define DIV_MAX_MIX_ROUTES ((DIV_MAX_CHIPS*16+2)*DIV_MAX_OUTPUTS)
+// how many values the compiled patchbay depends on (see updateMixRoutes())
+#define DIV_MIX_PARAMS (5+DIV_MAX_CHIPS*5)
+
+/**
+ * a patchbay connection to a system output, compiled for mixing.
+ */
+struct DivMixRoute {
+  // chip index, or the patchbay port set of the sample preview (0xffd) or metronome (0xffe)
+  unsigned short src;
+  unsigned char srcSub;
+  unsigned char dest;
+  // includes the conversion from 16-bit for chip and preview outputs
+  float gain;
+  DivMixRoute(unsigned short s, unsigned char ss, unsigned char d, float g):
+    src(s),
+    srcSub(ss),
+    dest(d),
+    gain(g) {}
+  DivMixRoute():
+    src(0),
+    srcSub(0),
+    dest(0),
+    gain(0.0f) {}
+};
+
 struct DivEffectContainer {
   DivEffect* effect;
   float* in[DIV_MAX_OUTPUTS];
@@ -387,6 +500,10 @@ enum DivChanTypes {
 
 extern const char* cmdName[];
 
+// several DivEngine instances may live in one process, each one driven by its own thread.
+// the only state they share are the system definitions and lookup tables (built once, read-only
+// afterwards) and the log.
+// create the first instance with preInit() and additional ones with preInitFrom().
 class DivEngine {
   DivDispatchContainer disCont[DIV_MAX_CHIPS];
   TAAudio* output;
@@ -411,6 +528,7 @@ class DivEngine {
   bool forceMono;
   bool clampSamples;
   bool cmdStreamEnabled;
+  bool oscTapsEnabled;
   bool softLocked;
   bool firstTick;
   bool skipping;
@@ -517,8 +635,36 @@ class DivEngine {
   size_t totalProcessed;
 
   unsigned int renderPoolThreads;
+  bool chipSleep;
+  unsigned int exportThreads;
   DivWorkPool* renderPool;
 
+  // tick-ahead rendering
+  bool tickAhead;
+  unsigned int tickAheadStamp;
+
+  // render-ahead thread
+  unsigned int renderAheadPeriods;
+  DivRenderAhead* renderAhead;
+
+  // per-channel chip copies (stem export)
+  std::vector<DivExportStem*> stems;
+
+  // compiled patchbay (see mix.cpp). allocated in init() so that the audio
+  // thread never has to.
+  std::vector<DivMixRoute> mixRoutes;
+  // first route of each system output (sorted by destination)
+  unsigned int mixRouteStart[DIV_MAX_OUTPUTS+1];
+  // what the routes were compiled from
+  std::vector<unsigned int> mixPatchbay;
+  bool mixPatchbayValid;
+  float mixParams[DIV_MIX_PARAMS], mixParamsNext[DIV_MIX_PARAMS];
+  int mixParamsLen;
+
+  // seek checkpoints (indexed by order)
+  std::vector<DivPlaybackCheckpoint*> checkpoints;
+  std::atomic<bool> checkpointsDirty;
+
   // MIDI stuff
   std::function<int(const TAMidiMessage&)> midiCallback=[](const TAMidiMessage&) -> int {return -2;};
 
@@ -529,18 +675,49 @@ class DivEngine {
   void performVGMWrite(SafeWriter* w, DivSystem sys, DivRegWrite& write, int streamOff, double* loopTimer, double* loopFreq, int* loopSample, bool* sampleDir, bool isSecond, int* pendingFreq, int* playingSample, int* setPos, unsigned int* sampleOff8, unsigned int* sampleLen8, size_t bankOffset, bool directStream);
   // returns true if end of song.
   bool nextTick(bool noAccum=false, bool inhibitLowLat=false);
+  // render pending tick-ahead segments of all chips.
+  void renderTickAhead();
   bool perSystemEffect(int ch, unsigned char effect, unsigned char effectVal);
   bool perSystemPostEffect(int ch, unsigned char effect, unsigned char effectVal);
   bool perSystemPreEffect(int ch, unsigned char effect, unsigned char effectVal);
   void recalcChans();
+  // whether two chips would render the same sample memory
+  bool isSampleLayoutEqual(int a, int b);
   void reset();
   void playSub(bool preserveDrift, int goalRow=0);
+  // whether every chip in the song can save its state
+  bool canCheckpoint();
+  // take a checkpoint at the current order if there isn't one
+  void saveCheckpoint(int maxOrder, unsigned int step);
+  // restore the furthest checkpoint which leads to the goal order
+  bool loadCheckpoint(int goal, int& maxOrder, unsigned int& step);
+  void clearCheckpoints();
+  // create a chip copy for each channel (or group of linked channels)
+  void initStems();
+  void quitStems();
+  // create the render pool for playback if it doesn't exist
+  void initRenderPool();
+  // allocate everything nextBuf() needs for buffers of up to this size, so that it doesn't allocate
+  void reserveBuffers(unsigned int size);
+  // set up the render pool for offline export
+  void initExportPool();
+  void quitExportPool();
+  // mix the output of every stem
+  void mixStems(unsigned int size);
+  // recompile the patchbay routes if routing, volume or panning changed
+  void updateMixRoutes(int outChans, bool mustPlay);
+  // mix the patchbay into the output, then feed the oscilloscope and apply force mono/clamping
+  void mixOutputs(float** out, int outChans, unsigned int size, bool mustPlay);
   void runMidiClock(int totalCycles=1);
   void runMidiTime(int totalCycles=1);
   bool shallSwitchCores();
 
   void testFunction();
 
+  // inflate a compressed song into a single buffer. returns NULL if it isn't compressed.
+  unsigned char* inflateSong(const unsigned char* f, size_t slen, size_t& len);
+  // load from a buffer. the buffer is freed afterwards if owned.
+  bool loadInternal(unsigned char* f, size_t slen, bool owned);
   bool loadDMF(unsigned char* file, size_t len);
   bool loadFur(unsigned char* file, size_t len);
   bool loadMod(unsigned char* file, size_t len);
@@ -568,6 +745,8 @@ class DivEngine {
   bool initAudioBackend();
   bool deinitAudioBackend(bool dueToSwitchMaster=false);
 
+  // fills sysDefs and the file maps. runs once per process (see registerSystems).
+  static void buildSysDefs();
   void registerSystems();
   void initSongWithDesc(const char* description, bool inBase64=true, bool oldVol=false);
 
@@ -615,9 +794,13 @@ class DivEngine {
     int tickMult;
     int lastNBIns, lastNBOuts, lastNBSize;
     std::atomic<size_t> processTime;
+    // per-stage and per-chip timing of nextBuf()
+    DivProfiler profiler;
 
     void runExportThread();
     void nextBuf(float** in, float** out, int inChans, int outChans, unsigned int size);
+    // called by the audio backend. pulls from the render-ahead ring if enabled.
+    void processAudio(float** in, float** out, int inChans, int outChans, unsigned int size);
     DivInstrument* getIns(int index, DivInstrumentType fallbackType=DIV_INS_FM);
     DivWavetable* getWave(int index);
     DivSample* getSample(int index);
@@ -627,15 +810,18 @@ class DivEngine {
     // start fresh
     void createNew(const char* description, String sysName, bool inBase64=true);
     void createNewFromDefaults();
-    // load a file.
+    // load a file. takes ownership of the buffer.
     bool load(unsigned char* f, size_t length);
+    // load a file from disk. it is mapped rather than read where possible.
+    bool loadFile(const String& path);
     // play a binary command stream.
     bool playStream(unsigned char* f, size_t length);
     // save as .dmf.
     SafeWriter* saveDMF(unsigned char version);
     // save as .fur.
     // if notPrimary is true then the song will not be altered
-    SafeWriter* saveFur(bool notPrimary=false, bool newPatternFormat=true);
+    // if blockPtrs is not NULL, the start of every instrument, wavetable, sample and pattern block is stored in it.
+    SafeWriter* saveFur(bool notPrimary=false, bool newPatternFormat=true, std::vector<size_t>* blockPtrs=NULL);
     // build a ROM file (TODO).
     // specify system to build ROM for.
     std::vector<DivROMExportOutput> buildROM(DivROMExportOptions sys);
@@ -684,6 +870,9 @@ class DivEngine {
     double benchmarkPlayback();
     double benchmarkSeek();
 
+    // get the profiler statistics (since the last benchmark) as JSON
+    String getProfilerJSON();
+
     // returns the minimum VGM version which may carry the specified system, or 0 if none.
     int minVGMVersion(DivSystem which);
 
@@ -743,6 +932,9 @@ class DivEngine {
     // play to row (returns whether successful)
     bool playToRow(int row);
 
+    // discard seek checkpoints after editing the song (may be called from any thread)
+    void invalidateCheckpoints();
+
     // play by one row
     void stepOne(int row);
 
@@ -1051,9 +1243,15 @@ class DivEngine {
     // get sample position
     DivSamplePos getSamplePos(int chan);
 
-    // get osc buffer
+    // get osc buffer. returns NULL if oscilloscope taps are disabled.
     DivDispatchOscBuffer* getOscBuffer(int chan);
 
+    // enable per-channel oscilloscope taps (disabled by default)
+    void enableOscTaps(bool enable);
+
+    // apply the osc tap setting to all channels
+    void applyOscTaps();
+
     // enable command stream dumping
     void enableCommandStream(bool enable);
 
@@ -1084,6 +1282,10 @@ class DivEngine {
     // set the console mode.
     void setConsoleMode(bool enable);
 
+    // set the number of render threads used during audio export.
+    // 0 means one per core if multi-threaded rendering is enabled, or none otherwise.
+    void setExportThreads(unsigned int count);
+
     // get metronome
     bool getMetronome();
 
@@ -1236,6 +1438,10 @@ class DivEngine {
     // pre-initialize the engine. returns whether Furnace should run in safe mode.
     bool preInit(bool noSafeMode=true);
 
+    // pre-initialize an additional engine using the configuration of another one.
+    // does not touch the config directory or the log file.
+    void preInitFrom(const DivEngine& base);
+
     // initialize the engine.
     bool init();
 
@@ -1243,7 +1449,7 @@ class DivEngine {
     void everythingOK();
 
     // terminate the engine.
-    bool quit();
+    bool quit(bool saveConfig=true);
 
     unsigned char* yrw801ROM;
     unsigned char* tg100ROM;
@@ -1270,6 +1476,7 @@ class DivEngine {
       halted(false),
       forceMono(false),
       cmdStreamEnabled(false),
+      oscTapsEnabled(false),
       softLocked(false),
       firstTick(false),
       skipping(false),
@@ -1352,7 +1559,16 @@ class DivEngine {
       previewVol(1.0f),
       totalProcessed(0),
       renderPoolThreads(0),
+      chipSleep(false),
+      exportThreads(0),
       renderPool(NULL),
+      tickAhead(false),
+      tickAheadStamp(0),
+      renderAheadPeriods(0),
+      renderAhead(NULL),
+      mixPatchbayValid(false),
+      mixParamsLen(0),
+      checkpointsDirty(false),
       curOrders(NULL),
       curPat(NULL),
       tempIns(NULL),
@@ -1378,14 +1594,11 @@ class DivEngine {
       memset(reversePitchTable,0,4096*sizeof(int));
       memset(pitchTable,0,4096*sizeof(int));
       memset(effectSlotMap,-1,4096*sizeof(short));
-      memset(sysDefs,0,DIV_MAX_CHIP_DEFS*sizeof(void*));
       memset(walked,0,8192);
       memset(oscBuf,0,DIV_MAX_OUTPUTS*(sizeof(float*)));
-
-      for (int i=0; i<DIV_MAX_CHIP_DEFS; i++) {
-        sysFileMapFur[i]=DIV_SYSTEM_NULL;
-        sysFileMapDMF[i]=DIV_SYSTEM_NULL;
-      }
+      memset(mixRouteStart,0,(DIV_MAX_OUTPUTS+1)*sizeof(unsigned int));
+      memset(mixParams,0,DIV_MIX_PARAMS*sizeof(float));
+      memset(mixParamsNext,0,DIV_MIX_PARAMS*sizeof(float));
 
       changeSong(0);
     }
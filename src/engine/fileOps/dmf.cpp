@@ -608,7 +608,7 @@ bool DivEngine::loadDMF(unsigned char* file, size_t len) {
               ins->std.algMacro.val[j]=-(ins->std.volMacro.val[j]-18);
             }
             ins->std.volMacro.len=0;
-            memset(ins->std.volMacro.val,0,256*sizeof(int));
+            ins->std.volMacro.val.clear();
           }
           for (int j=0; j<ins->std.dutyMacro.len; j++) {
             ins->std.dutyMacro.val[j]-=12;
@@ -1046,6 +1046,7 @@ bool DivEngine::loadDMF(unsigned char* file, size_t len) {
     BUSY_BEGIN_SOFT;
     saveLock.lock();
     song.unload();
+    ds.fitPatterns();
     song=ds;
     changeSong(0);
     recalcChans();
@@ -1513,13 +1514,10 @@ SafeWriter* DivEngine::saveDMF(unsigned char version) {
           w->writeS(pat->data[k][1]); // octave
         }
         w->writeS(pat->data[k][3]); // volume
-#ifdef TA_BIG_ENDIAN
+        // effects (rows aren't plain short arrays anymore, so write one by one)
         for (int l=0; l<curPat[i].effectCols*2; l++) {
           w->writeS(pat->data[k][4+l]);
         }
-#else
-        w->write(&pat->data[k][4],2*curPat[i].effectCols*2); // effects
-#endif
         w->writeS(pat->data[k][2]); // instrument
       }
     }
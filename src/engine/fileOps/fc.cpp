@@ -683,6 +683,7 @@ bool DivEngine::loadFC(unsigned char* file, size_t len) {
     BUSY_BEGIN_SOFT;
     saveLock.lock();
     song.unload();
+    ds.fitPatterns();
     song=ds;
     changeSong(0);
     recalcChans();
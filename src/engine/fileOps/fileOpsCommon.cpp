@@ -18,14 +18,99 @@
  */
 
 #include "fileOpsCommon.h"
+#include "../../fileutils.h"
+#include <errno.h>
+#include <string.h>
 
-bool DivEngine::load(unsigned char* f, size_t slen) {
+unsigned char* DivEngine::inflateSong(const unsigned char* f, size_t slen, size_t& len) {
+  z_stream zl;
+  memset(&zl,0,sizeof(z_stream));
+
+  zl.avail_in=slen;
+  zl.next_in=(Bytef*)f;
+  zl.zalloc=NULL;
+  zl.zfree=NULL;
+  zl.opaque=NULL;
+
+  int nextErr;
+  nextErr=inflateInit(&zl);
+  if (nextErr!=Z_OK) {
+    if (zl.msg==NULL) {
+      logD("zlib error: unknown! %d",nextErr);
+    } else {
+      logD("zlib error: %s",zl.msg);
+    }
+    inflateEnd(&zl);
+    lastError="not a .dmf/.fur song";
+    return NULL;
+  }
+
+  // inflate into a single buffer, starting from a guess of the final size.
+  // if it's too small, double it.
+  size_t cap=slen*DIV_INFLATE_RATIO;
+  if (cap<DIV_READ_SIZE) cap=DIV_READ_SIZE;
+  unsigned char* buf=new unsigned char[cap];
+  len=0;
+  while (true) {
+    if (len>=cap) {
+      logV("growing inflate buffer to %d",cap*2);
+      unsigned char* newBuf=new unsigned char[cap*2];
+      memcpy(newBuf,buf,len);
+      delete[] buf;
+      buf=newBuf;
+      cap*=2;
+    }
+    zl.next_out=buf+len;
+    zl.avail_out=cap-len;
+
+    nextErr=inflate(&zl,Z_SYNC_FLUSH);
+    if (nextErr!=Z_OK && nextErr!=Z_STREAM_END) {
+      if (zl.msg==NULL) {
+        logD("zlib error: unknown error! %d",nextErr);
+        lastError="unknown decompression error";
+      } else {
+        logD("zlib inflate: %s",zl.msg);
+        lastError=fmt::sprintf("decompression error: %s",zl.msg);
+      }
+      delete[] buf;
+      inflateEnd(&zl);
+      return NULL;
+    }
+    len=cap-zl.avail_out;
+    if (nextErr==Z_STREAM_END) {
+      break;
+    }
+  }
+  nextErr=inflateEnd(&zl);
+  if (nextErr!=Z_OK) {
+    if (zl.msg==NULL) {
+      logD("zlib end error: unknown error! %d",nextErr);
+      lastError="unknown decompression finish error";
+    } else {
+      logD("zlib end: %s",zl.msg);
+      lastError=fmt::sprintf("decompression finish error: %s",zl.msg);
+    }
+    delete[] buf;
+    return NULL;
+  }
+
+  if (len<1) {
+    logD("compressed too small!");
+    lastError="file too small";
+    delete[] buf;
+    return NULL;
+  }
+  logD("inflated %d bytes into %d (buffer size %d)",slen,len,cap);
+  return buf;
+}
+
+bool DivEngine::loadInternal(unsigned char* f, size_t slen, bool owned) {
   unsigned char* file;
   size_t len;
   if (slen<18) {
     logE("too small!");
     lastError="file is too small";
-    delete[] f;
+    if (owned) delete[] f;
     return false;
   }
 
@@ -33,117 +118,84 @@ bool DivEngine::load(unsigned char* f, size_t slen) {
 
   // step 1: try loading as a zlib-compressed file
   logD("trying zlib...");
-  try {
-    z_stream zl;
-    memset(&zl,0,sizeof(z_stream));
-
-    zl.avail_in=slen;
-    zl.next_in=(Bytef*)f;
-    zl.zalloc=NULL;
-    zl.zfree=NULL;
-    zl.opaque=NULL;
-
-    int nextErr;
-    nextErr=inflateInit(&zl);
-    if (nextErr!=Z_OK) {
-      if (zl.msg==NULL) {
-        logD("zlib error: unknown! %d",nextErr);
-      } else {
-        logD("zlib error: %s",zl.msg);
-      }
-      inflateEnd(&zl);
-      lastError="not a .dmf/.fur song";
-      throw NotZlibException(0);
-    }
+  file=inflateSong(f,slen,len);
+  if (file==NULL) {
+    logD("not zlib. loading as raw...");
+  }
 
-    std::vector<InflateBlock*> blocks;
-    while (true) {
-      InflateBlock* ib=new InflateBlock(DIV_READ_SIZE);
-      zl.next_out=ib->buf;
-      zl.avail_out=ib->len;
-
-      nextErr=inflate(&zl,Z_SYNC_FLUSH);
-      if (nextErr!=Z_OK && nextErr!=Z_STREAM_END) {
-        if (zl.msg==NULL) {
-          logD("zlib error: unknown error! %d",nextErr);
-          lastError="unknown decompression error";
-        } else {
-          logD("zlib inflate: %s",zl.msg);
-          lastError=fmt::sprintf("decompression error: %s",zl.msg);
-        }
-        for (InflateBlock* i: blocks) delete i;
-        blocks.clear();
-        delete ib;
-        inflateEnd(&zl);
-        throw NotZlibException(0);
-      }
-      ib->blockSize=ib->len-zl.avail_out;
-      blocks.push_back(ib);
-      if (nextErr==Z_STREAM_END) {
-        break;
-      }
-    }
-    nextErr=inflateEnd(&zl);
-    if (nextErr!=Z_OK) {
-      if (zl.msg==NULL) {
-        logD("zlib end error: unknown error! %d",nextErr);
-        lastError="unknown decompression finish error";
+  // step 2: try loading as .fur or .dmf
+  const unsigned char* magic=(file==NULL)?f:file;
+  size_t magicLen=(file==NULL)?slen:len;
+  if (magicLen>=18 && (
+      memcmp(magic,DIV_DMF_MAGIC,16)==0 ||
+      memcmp(magic,DIV_FTM_MAGIC,18)==0 ||
+      memcmp(magic,DIV_FUR_MAGIC,16)==0 ||
+      memcmp(magic,DIV_FC13_MAGIC,4)==0 ||
+      memcmp(magic,DIV_FC14_MAGIC,4)==0)) {
+    // the loaders take ownership of the buffer
+    if (file==NULL) {
+      if (owned) {
+        file=f;
       } else {
-        logD("zlib end: %s",zl.msg);
-        lastError=fmt::sprintf("decompression finish error: %s",zl.msg);
+        file=new unsigned char[slen];
+        memcpy(file,f,slen);
       }
-      for (InflateBlock* i: blocks) delete i;
-      blocks.clear();
-      throw NotZlibException(0);
+      len=slen;
+    } else if (owned) {
+      delete[] f;
     }
 
-    size_t finalSize=0;
-    size_t curSeek=0;
-    for (InflateBlock* i: blocks) {
-      finalSize+=i->blockSize;
+    if (memcmp(file,DIV_DMF_MAGIC,16)==0) {
+      return loadDMF(file,len); 
+    } else if (memcmp(file,DIV_FTM_MAGIC,18)==0) {
+      return loadFTM(file,len);
+    } else if (memcmp(file,DIV_FUR_MAGIC,16)==0) {
+      return loadFur(file,len);
     }
-    if (finalSize<1) {
-      logD("compressed too small!");
-      lastError="file too small";
-      for (InflateBlock* i: blocks) delete i;
-      blocks.clear();
-      throw NotZlibException(0);
-    }
-    file=new unsigned char[finalSize];
-    for (InflateBlock* i: blocks) {
-      memcpy(&file[curSeek],i->buf,i->blockSize);
-      curSeek+=i->blockSize;
-      delete i;
-    }
-    blocks.clear();
-    len=finalSize;
-    delete[] f;
-  } catch (NotZlibException& e) {
-    logD("not zlib. loading as raw...");
-    file=f;
-    len=slen;
-  }
-
-  // step 2: try loading as .fur or .dmf
-  if (memcmp(file,DIV_DMF_MAGIC,16)==0) {
-    return loadDMF(file,len); 
-  } else if (memcmp(file,DIV_FTM_MAGIC,18)==0) {
-    return loadFTM(file,len);
-  } else if (memcmp(file,DIV_FUR_MAGIC,16)==0) {
-    return loadFur(file,len);
-  } else if (memcmp(file,DIV_FC13_MAGIC,4)==0 || memcmp(file,DIV_FC14_MAGIC,4)==0) {
     return loadFC(file,len);
   }
+  if (file!=NULL) delete[] file;
 
   // step 3: try loading as .mod
   if (loadMod(f,slen)) {
-    delete[] f;
+    if (owned) delete[] f;
     return true;
   }
   
   // step 4: not a valid file
   logE("not a valid module!");
   lastError="not a compatible song";
-  delete[] file;
+  if (owned) delete[] f;
   return false;
 }
+
+bool DivEngine::load(unsigned char* f, size_t slen) {
+  return loadInternal(f,slen,true);
+}
+
+bool DivEngine::loadFile(const String& path) {
+  unsigned char* f=NULL;
+  size_t len=0;
+  bool mapped=false;
+  size_t rssBefore=getPeakRSS();
+
+  int result=mapFile(path.c_str(),f,len,mapped);
+  if (result<0) {
+    lastError=strerror(-result);
+    return false;
+  }
+  if (f==NULL) {
+    lastError="file is empty";
+    return false;
+  }
+  logD("%s %s (%d bytes)",mapped?"mapped":"read",path,len);
+
+  bool ret=loadInternal(f,len,false);
+  unmapFile(f,len,mapped);
+
+  size_t rssAfter=getPeakRSS();
+  if (rssAfter>0) {
+    logI("peak memory usage: %dMB (%dMB before loading)",(int)(rssAfter>>20),(int)(rssBefore>>20));
+  }
+  return ret;
+}
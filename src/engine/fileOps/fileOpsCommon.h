@@ -23,28 +23,10 @@
 #include <zlib.h>
 #include <fmt/printf.h>
 
+// smallest guess for the size of an inflated song
 #define DIV_READ_SIZE 131072
-
-struct InflateBlock {
-  unsigned char* buf;
-  size_t len;
-  size_t blockSize;
-  InflateBlock(size_t s) {
-    buf=new unsigned char[s];
-    len=s;
-    blockSize=0;
-  }
-  ~InflateBlock() {
-    delete[] buf;
-    len=0;
-  }
-};
-
-struct NotZlibException {
-  int what;
-  NotZlibException(int w):
-    what(w) {}
-};
+// guess of how much a song grows when inflated
+#define DIV_INFLATE_RATIO 4
 
 #define DIV_DMF_MAGIC ".DelekDefleMask."
 #define DIV_FUR_MAGIC "-Furnace module-"
@@ -18,6 +18,8 @@
  */
 
 #include "fileOpsCommon.h"
+#include "../workPool.h"
+#include <map>
 
 short newFormatNotes[180]={
   12, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, // -5
@@ -691,6 +693,168 @@ void DivEngine::convertOldFlags(unsigned int oldFlags, DivConfig& newFlags, DivS
   }
 }
 
+// a block which is decoded by a work thread after the pointer tables are read.
+struct FurBlock {
+  enum {
+    INS=0,
+    WAVE,
+    SAMPLE,
+    PATTERN
+  } type;
+  size_t pos, endPos;
+  void* target;
+  // patterns only. pos points past the header
+  unsigned int patPtr;
+  int patLen, effectCols, chan;
+  bool newFormat, readName;
+  // a later block which writes to the same pattern (-1 if none). decoded after this one
+  int next;
+  bool chained;
+  DivDataErrors result;
+  bool eof;
+  FurBlock():
+    type(INS),
+    pos(0),
+    endPos(0),
+    target(NULL),
+    patPtr(0),
+    patLen(0),
+    effectCols(0),
+    chan(0),
+    newFormat(false),
+    readName(false),
+    next(-1),
+    chained(false),
+    result(DIV_DATA_SUCCESS),
+    eof(false) {}
+};
+
+// a work thread task. decodes every step-th block starting at start.
+struct FurBlockTask {
+  std::vector<FurBlock>* blocks;
+  const unsigned char* file;
+  size_t len;
+  short version;
+  size_t start, step;
+};
+
+static void furReadPatternNew(SafeReader& reader, FurBlock& b) {
+  DivPattern* pat=(DivPattern*)b.target;
+  for (int j=0; j<b.patLen; j++) {
+    unsigned char mask=reader.readC();
+    unsigned short effectMask=0;
+
+    if (mask==0xff) break;
+    if (mask&128) {
+      j+=(mask&127)+1;
+      continue;
+    }
+
+    if (mask&32) {
+      effectMask|=(unsigned char)reader.readC();
+    }
+    if (mask&64) {
+      effectMask|=((unsigned short)reader.readC()&0xff)<<8;
+    }
+    if (mask&8) effectMask|=1;
+    if (mask&16) effectMask|=2;
+
+    if (mask&1) { // note
+      unsigned char note=reader.readC();
+      if (note==180) {
+        pat->data[j][0]=100;
+        pat->data[j][1]=0;
+      } else if (note==181) {
+        pat->data[j][0]=101;
+        pat->data[j][1]=0;
+      } else if (note==182) {
+        pat->data[j][0]=102;
+        pat->data[j][1]=0;
+      } else if (note<180) {
+        pat->data[j][0]=newFormatNotes[note];
+        pat->data[j][1]=newFormatOctaves[note];
+      } else {
+        pat->data[j][0]=0;
+        pat->data[j][1]=0;
+      }
+    }
+    if (mask&2) { // instrument
+      pat->data[j][2]=(unsigned char)reader.readC();
+    }
+    if (mask&4) { // volume
+      pat->data[j][3]=(unsigned char)reader.readC();
+    }
+    for (unsigned char k=0; k<16; k++) {
+      if (effectMask&(1<<k)) {
+        pat->data[j][4+k]=(unsigned char)reader.readC();
+      }
+    }
+  }
+}
+
+static void furReadPatternOld(SafeReader& reader, FurBlock& b) {
+  DivPattern* pat=(DivPattern*)b.target;
+  for (int j=0; j<b.patLen; j++) {
+    pat->data[j][0]=reader.readS();
+    pat->data[j][1]=reader.readS();
+    pat->data[j][2]=reader.readS();
+    pat->data[j][3]=reader.readS();
+    for (int k=0; k<b.effectCols; k++) {
+      pat->data[j][4+(k<<1)]=reader.readS();
+      pat->data[j][5+(k<<1)]=reader.readS();
+    }
+    if (pat->data[j][0]==0 && pat->data[j][1]!=0) {
+      logD("what? %d:%d:%d note %d octave %d",b.chan,b.patPtr,j,pat->data[j][0],pat->data[j][1]);
+      pat->data[j][0]=12;
+      pat->data[j][1]--;
+    }
+  }
+
+  if (b.readName) {
+    pat->name=reader.readString();
+  }
+}
+
+static void furReadBlock(FurBlockTask* t, FurBlock& b) {
+  SafeReader reader=SafeReader(t->file,t->len);
+  try {
+    reader.seek(b.pos,SEEK_SET);
+    switch (b.type) {
+      case FurBlock::INS:
+        b.result=((DivInstrument*)b.target)->readInsData(reader,t->version);
+        break;
+      case FurBlock::WAVE:
+        b.result=((DivWavetable*)b.target)->readWaveData(reader,t->version);
+        break;
+      case FurBlock::SAMPLE:
+        b.result=((DivSample*)b.target)->readSampleData(reader,t->version);
+        break;
+      case FurBlock::PATTERN:
+        if (b.newFormat) {
+          furReadPatternNew(reader,b);
+        } else {
+          furReadPatternOld(reader,b);
+        }
+        break;
+    }
+  } catch (EndOfFileException& e) {
+    b.eof=true;
+  }
+  b.endPos=reader.tell();
+}
+
+static void furReadBlocks(void* d) {
+  FurBlockTask* t=(FurBlockTask*)d;
+  std::vector<FurBlock>& blocks=*t->blocks;
+  for (size_t i=t->start; i<blocks.size(); i+=t->step) {
+    if (blocks[i].chained) continue;
+    // blocks which write to the same pattern go in file order
+    for (int j=i; j>=0; j=blocks[j].next) {
+      furReadBlock(t,blocks[j]);
+    }
+  }
+}
+
 bool DivEngine::loadFur(unsigned char* file, size_t len) {
   unsigned int insPtr[256];
   unsigned int wavePtr[256];
@@ -1611,82 +1775,72 @@ bool DivEngine::loadFur(unsigned char* file, size_t len) {
       }
     }
 
-    // read instruments
+    // the instruments, wavetables, samples and patterns are independent of each other.
+    // check the pointers and pattern headers here, then decode the rest in parallel.
+    std::vector<FurBlock> blocks;
+    blocks.reserve(ds.insLen+ds.waveLen+ds.sampleLen+patPtr.size());
+
     ds.ins.reserve(ds.insLen);
     for (int i=0; i<ds.insLen; i++) {
-      DivInstrument* ins=new DivInstrument;
       logD("reading instrument %d at %x...",i,insPtr[i]);
       if (!reader.seek(insPtr[i],SEEK_SET)) {
         logE("couldn't seek to instrument %d!",i);
         lastError=fmt::sprintf("couldn't seek to instrument %d!",i);
         ds.unload();
-        delete ins;
-        delete[] file;
-        return false;
-      }
-      
-      if (ins->readInsData(reader,ds.version)!=DIV_DATA_SUCCESS) {
-        lastError="invalid instrument header/data!";
-        ds.unload();
-        delete ins;
         delete[] file;
         return false;
       }
-
+      DivInstrument* ins=new DivInstrument;
       ds.ins.push_back(ins);
+
+      FurBlock b;
+      b.type=FurBlock::INS;
+      b.pos=insPtr[i];
+      b.target=ins;
+      blocks.push_back(b);
     }
 
-    // read wavetables
     ds.wave.reserve(ds.waveLen);
     for (int i=0; i<ds.waveLen; i++) {
-      DivWavetable* wave=new DivWavetable;
       logD("reading wavetable %d at %x...",i,wavePtr[i]);
       if (!reader.seek(wavePtr[i],SEEK_SET)) {
         logE("couldn't seek to wavetable %d!",i);
         lastError=fmt::sprintf("couldn't seek to wavetable %d!",i);
         ds.unload();
-        delete wave;
-        delete[] file;
-        return false;
-      }
-
-      if (wave->readWaveData(reader,ds.version)!=DIV_DATA_SUCCESS) {
-        lastError="invalid wavetable header/data!";
-        ds.unload();
-        delete wave;
         delete[] file;
         return false;
       }
-
+      DivWavetable* wave=new DivWavetable;
       ds.wave.push_back(wave);
+
+      FurBlock b;
+      b.type=FurBlock::WAVE;
+      b.pos=wavePtr[i];
+      b.target=wave;
+      blocks.push_back(b);
     }
 
-    // read samples
     ds.sample.reserve(ds.sampleLen);
     for (int i=0; i<ds.sampleLen; i++) {
-      DivSample* sample=new DivSample;
-
       if (!reader.seek(samplePtr[i],SEEK_SET)) {
         logE("couldn't seek to sample %d!",i);
         lastError=fmt::sprintf("couldn't seek to sample %d!",i);
         ds.unload();
-        delete sample;
         delete[] file;
         return false;
       }
-
-      if (sample->readSampleData(reader,ds.version)!=DIV_DATA_SUCCESS) {
-        lastError="invalid sample header/data!";
-        ds.unload();
-        delete sample;
-        delete[] file;
-        return false;
-      }
-
+      DivSample* sample=new DivSample;
       ds.sample.push_back(sample);
+
+      FurBlock b;
+      b.type=FurBlock::SAMPLE;
+      b.pos=samplePtr[i];
+      b.target=sample;
+      blocks.push_back(b);
     }
 
-    // read patterns
+    // pattern headers
+    std::map<DivPattern*,int> lastBlockOf;
     for (unsigned int i: patPtr) {
       bool isNewFormat=false;
       if (!reader.seek(i,SEEK_SET)) {
@@ -1711,93 +1865,18 @@ bool DivEngine::loadFur(unsigned char* file, size_t len) {
       }
       reader.readI();
 
+      int subs=0;
+      int chan=0;
+      int index=0;
       if (isNewFormat) {
-        int subs=(unsigned char)reader.readC();
-        int chan=(unsigned char)reader.readC();
-        int index=reader.readS();
+        subs=(unsigned char)reader.readC();
+        chan=(unsigned char)reader.readC();
+        index=reader.readS();
 
         logD("- %d, %d, %d (new)",subs,chan,index);
-
-        if (chan<0 || chan>=tchans) {
-          logE("pattern channel out of range!",i);
-          lastError="pattern channel out of range!";
-          ds.unload();
-          delete[] file;
-          return false;
-        }
-        if (index<0 || index>(DIV_MAX_PATTERNS-1)) {
-          logE("pattern index out of range!",i);
-          lastError="pattern index out of range!";
-          ds.unload();
-          delete[] file;
-          return false;
-        }
-        if (subs<0 || subs>=(int)ds.subsong.size()) {
-          logE("pattern subsong out of range!",i);
-          lastError="pattern subsong out of range!";
-          ds.unload();
-          delete[] file;
-          return false;
-        }
-
-        DivPattern* pat=ds.subsong[subs]->pat[chan].getPattern(index,true);
-        pat->name=reader.readString();
-
-        // read new pattern
-        for (int j=0; j<ds.subsong[subs]->patLen; j++) {
-          unsigned char mask=reader.readC();
-          unsigned short effectMask=0;
-
-          if (mask==0xff) break;
-          if (mask&128) {
-            j+=(mask&127)+1;
-            continue;
-          }
-
-          if (mask&32) {
-            effectMask|=(unsigned char)reader.readC();
-          }
-          if (mask&64) {
-            effectMask|=((unsigned short)reader.readC()&0xff)<<8;
-          }
-          if (mask&8) effectMask|=1;
-          if (mask&16) effectMask|=2;
-
-          if (mask&1) { // note
-            unsigned char note=reader.readC();
-            if (note==180) {
-              pat->data[j][0]=100;
-              pat->data[j][1]=0;
-            } else if (note==181) {
-              pat->data[j][0]=101;
-              pat->data[j][1]=0;
-            } else if (note==182) {
-              pat->data[j][0]=102;
-              pat->data[j][1]=0;
-            } else if (note<180) {
-              pat->data[j][0]=newFormatNotes[note];
-              pat->data[j][1]=newFormatOctaves[note];
-            } else {
-              pat->data[j][0]=0;
-              pat->data[j][1]=0;
-            }
-          }
-          if (mask&2) { // instrument
-            pat->data[j][2]=(unsigned char)reader.readC();
-          }
-          if (mask&4) { // volume
-            pat->data[j][3]=(unsigned char)reader.readC();
-          }
-          for (unsigned char k=0; k<16; k++) {
-            if (effectMask&(1<<k)) {
-              pat->data[j][4+k]=(unsigned char)reader.readC();
-            }
-          }
-        }
       } else {
-        int chan=reader.readS();
-        int index=reader.readS();
-        int subs=0;
+        chan=reader.readS();
+        index=reader.readS();
         if (ds.version>=95) {
           subs=reader.readS();
         } else {
@@ -1806,50 +1885,108 @@ bool DivEngine::loadFur(unsigned char* file, size_t len) {
         reader.readS();
 
         logD("- %d, %d, %d (old)",subs,chan,index);
+      }
 
-        if (chan<0 || chan>=tchans) {
-          logE("pattern channel out of range!",i);
-          lastError="pattern channel out of range!";
-          ds.unload();
-          delete[] file;
-          return false;
-        }
-        if (index<0 || index>(DIV_MAX_PATTERNS-1)) {
-          logE("pattern index out of range!",i);
-          lastError="pattern index out of range!";
-          ds.unload();
-          delete[] file;
-          return false;
+      if (chan<0 || chan>=tchans) {
+        logE("pattern channel out of range!",i);
+        lastError="pattern channel out of range!";
+        ds.unload();
+        delete[] file;
+        return false;
+      }
+      if (index<0 || index>(DIV_MAX_PATTERNS-1)) {
+        logE("pattern index out of range!",i);
+        lastError="pattern index out of range!";
+        ds.unload();
+        delete[] file;
+        return false;
+      }
+      if (subs<0 || subs>=(int)ds.subsong.size()) {
+        logE("pattern subsong out of range!",i);
+        lastError="pattern subsong out of range!";
+        ds.unload();
+        delete[] file;
+        return false;
+      }
+
+      DivPattern* pat=ds.subsong[subs]->pat[chan].getPattern(index,true);
+      if (isNewFormat) {
+        pat->name=reader.readString();
+      }
+
+      FurBlock b;
+      b.type=FurBlock::PATTERN;
+      b.pos=reader.tell();
+      b.target=pat;
+      b.patPtr=i;
+      b.patLen=ds.subsong[subs]->patLen;
+      b.effectCols=ds.subsong[subs]->pat[chan].effectCols;
+      b.chan=chan;
+      b.newFormat=isNewFormat;
+      b.readName=(!isNewFormat && ds.version>=51);
+
+      // the same pattern may appear more than once
+      std::map<DivPattern*,int>::iterator prev=lastBlockOf.find(pat);
+      if (prev!=lastBlockOf.end()) {
+        blocks[prev->second].next=blocks.size();
+        b.chained=true;
+      }
+      lastBlockOf[pat]=blocks.size();
+      blocks.push_back(b);
+    }
+
+    // decode
+    if (!blocks.empty()) {
+      unsigned int howManyThreads=std::thread::hardware_concurrency();
+      if (howManyThreads>blocks.size()) howManyThreads=blocks.size();
+      if (howManyThreads<2) howManyThreads=0;
+      // a few tasks per thread so that big samples don't hold everyone up.
+      // not too many, as each thread only queues DIV_WORK_QUEUE_SIZE of them.
+      size_t taskCount=MAX(1,howManyThreads*4);
+      if (taskCount>blocks.size()) taskCount=blocks.size();
+
+      std::vector<FurBlockTask> tasks(taskCount);
+      DivWorkPool* pool=new DivWorkPool(howManyThreads);
+      logD("decoding %d blocks in %d tasks (%d threads)",(int)blocks.size(),(int)taskCount,howManyThreads);
+      for (size_t i=0; i<taskCount; i++) {
+        tasks[i].blocks=&blocks;
+        tasks[i].file=file;
+        tasks[i].len=len;
+        tasks[i].version=ds.version;
+        tasks[i].start=i;
+        tasks[i].step=taskCount;
+        pool->push(furReadBlocks,&tasks[i]);
+      }
+      pool->wait();
+      delete pool;
+
+      // report the first error in file order
+      for (FurBlock& i: blocks) {
+        if (i.eof) {
+          throw EndOfFileException(&reader,reader.size());
         }
-        if (subs<0 || subs>=(int)ds.subsong.size()) {
-          logE("pattern subsong out of range!",i);
-          lastError="pattern subsong out of range!";
+        if (i.result!=DIV_DATA_SUCCESS) {
+          switch (i.type) {
+            case FurBlock::INS:
+              lastError="invalid instrument header/data!";
+              break;
+            case FurBlock::WAVE:
+              lastError="invalid wavetable header/data!";
+              break;
+            case FurBlock::SAMPLE:
+              lastError="invalid sample header/data!";
+              break;
+            default:
+              break;
+          }
           ds.unload();
           delete[] file;
           return false;
         }
-
-        DivPattern* pat=ds.subsong[subs]->pat[chan].getPattern(index,true);
-        for (int j=0; j<ds.subsong[subs]->patLen; j++) {
-          pat->data[j][0]=reader.readS();
-          pat->data[j][1]=reader.readS();
-          pat->data[j][2]=reader.readS();
-          pat->data[j][3]=reader.readS();
-          for (int k=0; k<ds.subsong[subs]->pat[chan].effectCols; k++) {
-            pat->data[j][4+(k<<1)]=reader.readS();
-            pat->data[j][5+(k<<1)]=reader.readS();
-          }
-          if (pat->data[j][0]==0 && pat->data[j][1]!=0) {
-            logD("what? %d:%d:%d note %d octave %d",chan,i,j,pat->data[j][0],pat->data[j][1]);
-            pat->data[j][0]=12;
-            pat->data[j][1]--;
-          }
-        }
-
-        if (ds.version>=51) {
-          pat->name=reader.readString();
-        }
       }
+
+      // the reader would be past the last block
+      reader.seek(blocks.back().endPos,SEEK_SET);
     }
 
     if (reader.tell()<reader.size()) {
@@ -2056,6 +2193,7 @@ bool DivEngine::loadFur(unsigned char* file, size_t len) {
     BUSY_BEGIN_SOFT;
     saveLock.lock();
     song.unload();
+    ds.fitPatterns();
     song=ds;
     changeSong(0);
     recalcChans();
@@ -2078,7 +2216,7 @@ bool DivEngine::loadFur(unsigned char* file, size_t len) {
   return true;
 }
 
-SafeWriter* DivEngine::saveFur(bool notPrimary, bool newPatternFormat) {
+SafeWriter* DivEngine::saveFur(bool notPrimary, bool newPatternFormat, std::vector<size_t>* blockPtrs) {
   saveLock.lock();
   std::vector<int> subSongPtr;
   std::vector<int> sysFlagsPtr;
@@ -2646,13 +2784,10 @@ SafeWriter* DivEngine::saveFur(bool notPrimary, bool newPatternFormat) {
         w->writeS(pat->data[j][1]); // octave
         w->writeS(pat->data[j][2]); // instrument
         w->writeS(pat->data[j][3]); // volume
-#ifdef TA_BIG_ENDIAN
+        // effects (rows aren't plain short arrays anymore, so write one by one)
         for (int k=0; k<song.subsong[i.subsong]->pat[i.chan].effectCols*2; k++) {
           w->writeS(pat->data[j][4+k]);
         }
-#else
-        w->write(&pat->data[j][4],2*song.subsong[i.subsong]->pat[i.chan].effectCols*2); // effects
-#endif
       }
 
       w->writeString(pat->name,false);
@@ -2704,6 +2839,15 @@ SafeWriter* DivEngine::saveFur(bool notPrimary, bool newPatternFormat) {
     w->writeI(assetDirPtr[i]);
   }
 
+  if (blockPtrs!=NULL) {
+    blockPtrs->clear();
+    blockPtrs->reserve(insPtr.size()+wavePtr.size()+samplePtr.size()+patPtr.size());
+    for (int i: insPtr) blockPtrs->push_back(i);
+    for (int i: wavePtr) blockPtrs->push_back(i);
+    for (int i: samplePtr) blockPtrs->push_back(i);
+    for (int i: patPtr) blockPtrs->push_back(i);
+  }
+
   saveLock.unlock();
   return w;
 }
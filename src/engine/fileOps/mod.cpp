@@ -185,7 +185,7 @@ bool DivEngine::loadMod(unsigned char* file, size_t len) {
       }
       for (int row=0; row<64; row++) {
         for (int ch=0; ch<chCount; ch++) {
-          short* dstrow=chpats[ch]->data[row];
+          DivPatternRow dstrow=chpats[ch]->data[row];
           unsigned char data[4];
           reader.read(&data,4);
           // instrument
@@ -255,8 +255,10 @@ bool DivEngine::loadMod(unsigned char* file, size_t len) {
     logD("converting module...");
     for (int ch=0; ch<=chCount; ch++) {
       unsigned char fxCols=1;
+      // room for every effect we may write. trimmed after loading
+      ds.subsong[0]->pat[ch].effectCols=DIV_MAX_EFFECTS;
       for (int pat=0; pat<=patMax; pat++) {
-        auto* data=ds.subsong[0]->pat[ch].getPattern(pat,true)->data;
+        DivPatternData& data=ds.subsong[0]->pat[ch].getPattern(pat,true)->data;
         short lastPitchEffect=-1;
         short lastEffectState[5]={-1,-1,-1,-1,-1};
         short setEffectState[5]={-1,-1,-1,-1,-1};
@@ -266,7 +268,7 @@ bool DivEngine::loadMod(unsigned char* file, size_t len) {
           unsigned char curFxCol=0;
           short fxTyp=data[row][4];
           short fxVal=data[row][5];
-          auto writeFxCol=[data,row,&curFxCol](short typ, short val) {
+          auto writeFxCol=[&data,row,&curFxCol](short typ, short val) {
             data[row][4+curFxCol*2]=typ;
             data[row][5+curFxCol*2]=val;
             curFxCol++;
@@ -422,6 +424,7 @@ bool DivEngine::loadMod(unsigned char* file, size_t len) {
     BUSY_BEGIN_SOFT;
     saveLock.lock();
     song.unload();
+    ds.fitPatterns();
     song=ds;
     changeSong(0);
     recalcChans();
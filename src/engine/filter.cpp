@@ -21,6 +21,7 @@
 #include <math.h>
 #include "filter.h"
 #include "../ta-log.h"
+#include <mutex>
 
 float* DivFilterTables::cubicTable=NULL;
 float* DivFilterTables::sincTable=NULL;
@@ -28,10 +29,17 @@ float* DivFilterTables::sincTable8=NULL;
 float* DivFilterTables::sincIntegralTable=NULL;
 float* DivFilterTables::sincIntegralSmallTable=NULL;
 
+// the tables are built once on first use and shared (read-only) by every engine instance.
+static std::once_flag cubicTableOnce;
+static std::once_flag sincTableOnce;
+static std::once_flag sincTable8Once;
+static std::once_flag sincIntegralTableOnce;
+static std::once_flag sincIntegralSmallTableOnce;
+
 // portions from Schism Tracker (scripts/lutgen.c)
 // licensed under same license as this program.
 float* DivFilterTables::getCubicTable() {
-  if (cubicTable==NULL) {
+  std::call_once(cubicTableOnce,[]() {
     logD("initializing cubic spline table.");
     cubicTable=new float[4096];
 
@@ -42,12 +50,12 @@ float* DivFilterTables::getCubicTable() {
       cubicTable[2+(i<<2)]=-1.5*pow(x,3)+2.0*pow(x,2)+0.5*x;
       cubicTable[3+(i<<2)]=0.5*pow(x,3)-0.5*pow(x,2);
     }
-  }
+  });
   return cubicTable;
 }
 
 float* DivFilterTables::getSincTable() {
-  if (sincTable==NULL) {
+  std::call_once(sincTableOnce,[]() {
     logD("initializing sinc table.");
     sincTable=new float[65536];
 
@@ -62,12 +70,12 @@ float* DivFilterTables::getSincTable() {
       int mapped=((i&8191)<<3)|(i>>13);
       sincTable[mapped]*=pow(cos(M_PI*(double)i/131072.0),2.0);
     }
-  }
+  });
   return sincTable;
 }
 
 float* DivFilterTables::getSincTable8() {
-  if (sincTable8==NULL) {
+  std::call_once(sincTable8Once,[]() {
     logD("initializing sinc table (8).");
     sincTable8=new float[32768];
 
@@ -82,12 +90,12 @@ float* DivFilterTables::getSincTable8() {
       int mapped=((i&8191)<<2)|(i>>13);
       sincTable8[mapped]*=pow(cos(M_PI*(double)i/65536.0),2.0);
     }
-  }
+  });
   return sincTable8;
 }
 
 float* DivFilterTables::getSincIntegralTable() {
-  if (sincIntegralTable==NULL) {
+  std::call_once(sincIntegralTableOnce,[]() {
     logD("initializing sinc integral table.");
     sincIntegralTable=new float[65536];
 
@@ -104,12 +112,12 @@ float* DivFilterTables::getSincIntegralTable() {
       int mapped=((i&8191)<<3)|(i>>13);
       sincIntegralTable[mapped]*=pow(cos(M_PI*(double)i/131072.0),2.0);
     }
-  }
+  });
   return sincIntegralTable;
 }
 
 float* DivFilterTables::getSincIntegralSmallTable() {
-  if (sincIntegralSmallTable==NULL) {
+  std::call_once(sincIntegralSmallTableOnce,[]() {
     logD("initializing small sinc integral table.");
     sincIntegralSmallTable=new float[512];
 
@@ -126,6 +134,6 @@ float* DivFilterTables::getSincIntegralSmallTable() {
       int mapped=((i&63)<<3)|(i>>6);
       sincIntegralSmallTable[mapped]*=pow(cos(M_PI*(double)i/1024.0),2.0);
     }
-  }
+  });
   return sincIntegralSmallTable;
 }
\ No newline at end of file
@@ -25,6 +25,223 @@
 
 const DivInstrument defaultIns;
 
+static const size_t macroDataSize[4]={
+  1, 1, 2, 4
+};
+
+static unsigned char macroDataTypeFor(int minVal, int maxVal) {
+  if (minVal>=0 && maxVal<=255) return DIV_MACRO_DATA_U8;
+  if (minVal>=-128 && maxVal<=127) return DIV_MACRO_DATA_S8;
+  if (minVal>=-32768 && maxVal<=32767) return DIV_MACRO_DATA_S16;
+  return DIV_MACRO_DATA_S32;
+}
+
+static inline bool macroDataFits(unsigned char type, int v) {
+  switch (type) {
+    case DIV_MACRO_DATA_U8:
+      return (v>=0 && v<=255);
+    case DIV_MACRO_DATA_S8:
+      return (v>=-128 && v<=127);
+    case DIV_MACRO_DATA_S16:
+      return (v>=-32768 && v<=32767);
+  }
+  return true;
+}
+
+static inline void macroDataStore(void* data, unsigned char type, int pos, int v) {
+  switch (type) {
+    case DIV_MACRO_DATA_U8:
+      ((unsigned char*)data)[pos]=v;
+      break;
+    case DIV_MACRO_DATA_S8:
+      ((signed char*)data)[pos]=v;
+      break;
+    case DIV_MACRO_DATA_S16:
+      ((short*)data)[pos]=v;
+      break;
+    default:
+      ((int*)data)[pos]=v;
+      break;
+  }
+}
+
+void DivMacroData::reshape(int newCap, unsigned char newType) {
+  void* newData=NULL;
+  if (newCap>0) {
+    newData=malloc(newCap*macroDataSize[newType]);
+    for (int i=0; i<newCap; i++) {
+      macroDataStore(newData,newType,i,get(i));
+    }
+  }
+  if (data!=NULL) free(data);
+  data=newData;
+  cap=newCap;
+  type=newType;
+}
+
+void DivMacroData::set(int pos, int v) {
+  if (pos<0 || pos>=256) return;
+  if (pos<cap && macroDataFits(type,v)) {
+    macroDataStore(data,type,pos,v);
+    return;
+  }
+  // nothing to do when writing 0 past the end
+  if (pos>=cap && v==0) return;
+
+  int newCap=cap;
+  if (pos>=cap) {
+    newCap=8;
+    while (newCap<=pos) newCap<<=1;
+  }
+  unsigned char newType=type;
+  if (!macroDataFits(type,v)) {
+    int minVal=v;
+    int maxVal=v;
+    for (int i=0; i<cap; i++) {
+      int x=get(i);
+      if (x<minVal) minVal=x;
+      if (x>maxVal) maxVal=x;
+    }
+    newType=macroDataTypeFor(minVal,maxVal);
+  }
+  reshape(newCap,newType);
+  macroDataStore(data,type,pos,v);
+}
+
+void DivMacroData::copyTo(int* dest, int count) const {
+  for (int i=0; i<count; i++) {
+    dest[i]=get(i);
+  }
+}
+
+void DivMacroData::setFrom(const int* src, int count) {
+  for (int i=0; i<count; i++) {
+    set(i,src[i]);
+  }
+}
+
+void DivMacroData::clear() {
+  if (isFull()) {
+    // keep the storage as someone may be reading it
+    memset(data,0,256*sizeof(int));
+    return;
+  }
+  if (data!=NULL) free(data);
+  data=NULL;
+  cap=0;
+  type=DIV_MACRO_DATA_U8;
+}
+
+void DivMacroData::reserveFull() {
+  if (isFull()) return;
+  reshape(256,DIV_MACRO_DATA_S32);
+}
+
+size_t DivMacroData::getMemUsage() const {
+  return cap*macroDataSize[type];
+}
+
+DivMacroData& DivMacroData::operator=(const DivMacroData& other) {
+  if (this==&other) return *this;
+  if (isFull()) {
+    // write in place
+    for (int i=0; i<256; i++) {
+      ((int*)data)[i]=other.get(i);
+    }
+    return *this;
+  }
+  if (data!=NULL) free(data);
+  data=NULL;
+  cap=other.cap;
+  type=other.type;
+  if (cap>0) {
+    data=malloc(cap*macroDataSize[type]);
+    memcpy(data,other.data,cap*macroDataSize[type]);
+  }
+  return *this;
+}
+
+DivMacroData::DivMacroData(const DivMacroData& other):
+  data(NULL),
+  cap(0),
+  type(DIV_MACRO_DATA_U8) {
+  *this=other;
+}
+
+DivMacroData::~DivMacroData() {
+  if (data!=NULL) free(data);
+  data=NULL;
+}
+
+static DivInstrumentMacro DivInstrumentSTD::* const stdMacroList[]={
+  &DivInstrumentSTD::volMacro,
+  &DivInstrumentSTD::arpMacro,
+  &DivInstrumentSTD::dutyMacro,
+  &DivInstrumentSTD::waveMacro,
+  &DivInstrumentSTD::pitchMacro,
+  &DivInstrumentSTD::ex1Macro,
+  &DivInstrumentSTD::ex2Macro,
+  &DivInstrumentSTD::ex3Macro,
+  &DivInstrumentSTD::algMacro,
+  &DivInstrumentSTD::fbMacro,
+  &DivInstrumentSTD::fmsMacro,
+  &DivInstrumentSTD::amsMacro,
+  &DivInstrumentSTD::panLMacro,
+  &DivInstrumentSTD::panRMacro,
+  &DivInstrumentSTD::phaseResetMacro,
+  &DivInstrumentSTD::ex4Macro,
+  &DivInstrumentSTD::ex5Macro,
+  &DivInstrumentSTD::ex6Macro,
+  &DivInstrumentSTD::ex7Macro,
+  &DivInstrumentSTD::ex8Macro
+};
+
+static DivInstrumentMacro DivInstrumentSTD::OpMacro::* const opMacroList[]={
+  &DivInstrumentSTD::OpMacro::amMacro,
+  &DivInstrumentSTD::OpMacro::arMacro,
+  &DivInstrumentSTD::OpMacro::drMacro,
+  &DivInstrumentSTD::OpMacro::multMacro,
+  &DivInstrumentSTD::OpMacro::rrMacro,
+  &DivInstrumentSTD::OpMacro::slMacro,
+  &DivInstrumentSTD::OpMacro::tlMacro,
+  &DivInstrumentSTD::OpMacro::dt2Macro,
+  &DivInstrumentSTD::OpMacro::rsMacro,
+  &DivInstrumentSTD::OpMacro::dtMacro,
+  &DivInstrumentSTD::OpMacro::d2rMacro,
+  &DivInstrumentSTD::OpMacro::ssgMacro,
+  &DivInstrumentSTD::OpMacro::damMacro,
+  &DivInstrumentSTD::OpMacro::dvbMacro,
+  &DivInstrumentSTD::OpMacro::egtMacro,
+  &DivInstrumentSTD::OpMacro::kslMacro,
+  &DivInstrumentSTD::OpMacro::susMacro,
+  &DivInstrumentSTD::OpMacro::vibMacro,
+  &DivInstrumentSTD::OpMacro::wsMacro,
+  &DivInstrumentSTD::OpMacro::ksrMacro
+};
+
+void DivInstrumentSTD::reserveFull() {
+  for (DivInstrumentMacro DivInstrumentSTD::* i: stdMacroList) {
+    (this->*i).val.reserveFull();
+  }
+  for (int j=0; j<4; j++) {
+    for (DivInstrumentMacro DivInstrumentSTD::OpMacro::* i: opMacroList) {
+      (opMacros[j].*i).val.reserveFull();
+    }
+  }
+}
+
+bool DivInstrumentSTD::isFull() {
+  for (DivInstrumentMacro DivInstrumentSTD::* i: stdMacroList) {
+    if (!(this->*i).val.isFull()) return false;
+  }
+  for (int j=0; j<4; j++) {
+    for (DivInstrumentMacro DivInstrumentSTD::OpMacro::* i: opMacroList) {
+      if (!(opMacros[j].*i).val.isFull()) return false;
+    }
+  }
+  return true;
+}
+
 #define _C(x) x==other.x
 
 bool DivInstrumentFM::operator==(const DivInstrumentFM& other) {
@@ -2154,7 +2371,7 @@ DivDataErrors DivInstrument::readInsDataNew(SafeReader& reader, short version, b
 
   // <187 C64 cutoff macro compatibility
   if (type==DIV_INS_C64 && volIsCutoff && version<187) {
-    memcpy(&std.algMacro,&std.volMacro,sizeof(DivInstrumentMacro));
+    std.algMacro=std.volMacro;
     std.algMacro.macroType=DIV_MACRO_ALG;
     std.volMacro=DivInstrumentMacro(DIV_MACRO_VOL,true);
 
@@ -2906,7 +3123,7 @@ DivDataErrors DivInstrument::readInsDataOld(SafeReader &reader, short version) {
 
   // <187 C64 cutoff macro compatibility
   if (type==DIV_INS_C64 && volIsCutoff && version<187) {
-    memcpy(&std.algMacro,&std.volMacro,sizeof(DivInstrumentMacro));
+    std.algMacro=std.volMacro;
     std.algMacro.macroType=DIV_MACRO_ALG;
     std.volMacro=DivInstrumentMacro(DIV_MACRO_VOL,true);
 
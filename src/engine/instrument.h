@@ -246,20 +246,151 @@ struct DivInstrumentFM {
   }
 };
 
+enum DivMacroDataType: unsigned char {
+  DIV_MACRO_DATA_U8=0,
+  DIV_MACRO_DATA_S8,
+  DIV_MACRO_DATA_S16,
+  DIV_MACRO_DATA_S32
+};
+
+/**
+ * macro values.
+ * only the positions up to the last non-zero one are stored, using the
+ * narrowest element type which fits every value. reading past that returns 0.
+ * set(), clear() and assignment may reallocate unless reserveFull() is in
+ * effect, so do them under the engine lock if the instrument may be playing.
+ */
+class DivMacroData {
+  void* data;
+  unsigned short cap;
+  unsigned char type;
+
+  void reshape(int newCap, unsigned char newType);
+
+  public:
+    /**
+     * reference to a single value, so that the usual val[x]=y works.
+     */
+    class Ref {
+      DivMacroData& d;
+      int pos;
+      public:
+        operator int() const {
+          return d.get(pos);
+        }
+        Ref& operator=(int v) {
+          d.set(pos,v);
+          return *this;
+        }
+        Ref& operator=(const Ref& other) {
+          d.set(pos,other.d.get(other.pos));
+          return *this;
+        }
+        Ref& operator+=(int v) {
+          d.set(pos,d.get(pos)+v);
+          return *this;
+        }
+        Ref& operator-=(int v) {
+          d.set(pos,d.get(pos)-v);
+          return *this;
+        }
+        Ref& operator&=(int v) {
+          d.set(pos,d.get(pos)&v);
+          return *this;
+        }
+        Ref& operator|=(int v) {
+          d.set(pos,d.get(pos)|v);
+          return *this;
+        }
+        Ref& operator^=(int v) {
+          d.set(pos,d.get(pos)^v);
+          return *this;
+        }
+        Ref(DivMacroData& data, int p):
+          d(data),
+          pos(p) {}
+    };
+
+    /**
+     * get a value.
+     */
+    int get(int pos) const {
+      if (pos<0 || pos>=cap) return 0;
+      switch (type) {
+        case DIV_MACRO_DATA_U8:
+          return ((const unsigned char*)data)[pos];
+        case DIV_MACRO_DATA_S8:
+          return ((const signed char*)data)[pos];
+        case DIV_MACRO_DATA_S16:
+          return ((const short*)data)[pos];
+      }
+      return ((const int*)data)[pos];
+    }
+
+    /**
+     * set a value. this may reallocate the storage.
+     * @param pos position (0-255).
+     */
+    void set(int pos, int v);
+
+    /**
+     * copy values into an int array.
+     */
+    void copyTo(int* dest, int count) const;
+
+    /**
+     * set values from an int array.
+     */
+    void setFrom(const int* src, int count);
+
+    /**
+     * set every value to 0 and free the storage.
+     */
+    void clear();
+
+    /**
+     * allocate all 256 positions at full width, so that set() will never
+     * reallocate afterwards. used while editing the macro.
+     */
+    void reserveFull();
+
+    /**
+     * whether reserveFull() is in effect.
+     */
+    bool isFull() const {
+      return cap==256 && type==DIV_MACRO_DATA_S32;
+    }
+
+    /**
+     * get the number of bytes used by the values.
+     */
+    size_t getMemUsage() const;
+
+    int operator[](int pos) const {
+      return get(pos);
+    }
+    Ref operator[](int pos) {
+      return Ref(*this,pos);
+    }
+
+    DivMacroData& operator=(const DivMacroData& other);
+    DivMacroData(const DivMacroData& other);
+    DivMacroData():
+      data(NULL),
+      cap(0),
+      type(DIV_MACRO_DATA_U8) {}
+    ~DivMacroData();
+};
+
 // this is getting out of hand
 struct DivInstrumentMacro {
-  int val[256];
+  DivMacroData val;
   unsigned int mode;
   unsigned char open;
   unsigned char len, delay, speed, loop, rel;
   // 0-31: normal
   // 32+: operator (top 3 bits select operator, starting from 1)
   unsigned char macroType;
-  
-  // the following variables are used by the GUI and not saved in the file
-  int vScroll, vZoom;
-  int typeMemory[16];
-  unsigned char lenMemory;
 
   explicit DivInstrumentMacro(unsigned char initType, bool initOpen=false):
     mode(0),
@@ -269,12 +400,7 @@ struct DivInstrumentMacro {
     speed(1),
     loop(255),
     rel(255),
-    macroType(initType),
-    vScroll(0),
-    vZoom(-1),
-    lenMemory(0) {
-    memset(val,0,256*sizeof(int));
-    memset(typeMemory,0,16*sizeof(int));
+    macroType(initType) {
   }
 };
 
@@ -374,6 +500,16 @@ struct DivInstrumentSTD {
       opMacros[i].ksrMacro.macroType=DIV_MACRO_OP_KSR+(i<<5);
     }
   }
+
+  /**
+   * make sure no macro reallocates when edited (see DivMacroData::reserveFull()).
+   */
+  void reserveFull();
+
+  /**
+   * whether reserveFull() is in effect for every macro.
+   */
+  bool isFull();
 };
 
 struct DivInstrumentGB {
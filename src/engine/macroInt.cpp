@@ -22,21 +22,21 @@
 #include "engine.h"
 #include "../ta-log.h"
 
-#define ADSR_LOW source.val[0]
-#define ADSR_HIGH source.val[1]
-#define ADSR_AR source.val[2]
-#define ADSR_HT source.val[3]
-#define ADSR_DR source.val[4]
-#define ADSR_SL source.val[5]
-#define ADSR_ST source.val[6]
-#define ADSR_SR source.val[7]
-#define ADSR_RR source.val[8]
-
-#define LFO_SPEED source.val[11]
-#define LFO_WAVE source.val[12]
-#define LFO_PHASE source.val[13]
-#define LFO_LOOP source.val[14]
-#define LFO_GLOBAL source.val[15]
+#define ADSR_LOW source.val.get(0)
+#define ADSR_HIGH source.val.get(1)
+#define ADSR_AR source.val.get(2)
+#define ADSR_HT source.val.get(3)
+#define ADSR_DR source.val.get(4)
+#define ADSR_SL source.val.get(5)
+#define ADSR_ST source.val.get(6)
+#define ADSR_SR source.val.get(7)
+#define ADSR_RR source.val.get(8)
+
+#define LFO_SPEED source.val.get(11)
+#define LFO_WAVE source.val.get(12)
+#define LFO_PHASE source.val.get(13)
+#define LFO_LOOP source.val.get(14)
+#define LFO_GLOBAL source.val.get(15)
 
 void DivMacroStruct::prepare(DivInstrumentMacro& source, DivEngine* e) {
   has=had=actualHad=will=true;
@@ -87,7 +87,7 @@ void DivMacroStruct::doMacro(DivInstrumentMacro& source, bool released, bool tic
   if (has) {
     if (type==0) { // sequence
       lastPos=pos;
-      val=source.val[pos++];
+      val=source.val.get(pos++);
       if (pos>source.rel && !released) {
         if (source.loop<source.len && source.loop<source.rel) {
           pos=source.loop;
@@ -483,7 +483,7 @@ void DivMacroInt::init(DivInstrument* which) {
       macroList[i]->prepare(*macroSource[i],e);
       // check ADSR mode
       if ((macroSource[i]->open&6)==2) {
-        if (macroSource[i]->val[8]>0) {
+        if (macroSource[i]->val.get(8)>0) {
           hasRelease=true;
         }
       } else if (macroSource[i]->rel<macroSource[i]->len) {
@@ -0,0 +1,325 @@
+/**
+ * Furnace Tracker - multi-system chiptune tracker
+ * Copyright (C) 2021-2024 tildearrow and contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "engine.h"
+#include "../ta-log.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP>=2)
+#define DIV_MIX_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define DIV_MIX_NEON
+#include <arm_neon.h>
+#endif
+
+// the output is mixed in blocks of this many samples, so that every pass
+// after the first one works on data which is still in cache.
+#define DIV_MIX_BLOCK 256
+
+// dest+=src*gain (16-bit source)
+static inline void mixShort(float* dest, const short* src, float gain, unsigned int len) {
+  unsigned int i=0;
+#if defined(DIV_MIX_SSE2)
+  const __m128 g=_mm_set1_ps(gain);
+  for (; i+8<=len; i+=8) {
+    __m128i s=_mm_loadu_si128((const __m128i*)(src+i));
+    __m128 lo=_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s,s),16));
+    __m128 hi=_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(s,s),16));
+    _mm_storeu_ps(dest+i,_mm_add_ps(_mm_loadu_ps(dest+i),_mm_mul_ps(lo,g)));
+    _mm_storeu_ps(dest+i+4,_mm_add_ps(_mm_loadu_ps(dest+i+4),_mm_mul_ps(hi,g)));
+  }
+#elif defined(DIV_MIX_NEON)
+  const float32x4_t g=vdupq_n_f32(gain);
+  for (; i+8<=len; i+=8) {
+    int16x8_t s=vld1q_s16(src+i);
+    float32x4_t lo=vcvtq_f32_s32(vmovl_s16(vget_low_s16(s)));
+    float32x4_t hi=vcvtq_f32_s32(vmovl_s16(vget_high_s16(s)));
+    vst1q_f32(dest+i,vaddq_f32(vld1q_f32(dest+i),vmulq_f32(lo,g)));
+    vst1q_f32(dest+i+4,vaddq_f32(vld1q_f32(dest+i+4),vmulq_f32(hi,g)));
+  }
+#endif
+  for (; i<len; i++) {
+    dest[i]+=(float)src[i]*gain;
+  }
+}
+
+// dest+=src*gain (float source)
+static inline void mixFloat(float* dest, const float* src, float gain, unsigned int len) {
+  unsigned int i=0;
+#if defined(DIV_MIX_SSE2)
+  const __m128 g=_mm_set1_ps(gain);
+  for (; i+4<=len; i+=4) {
+    _mm_storeu_ps(dest+i,_mm_add_ps(_mm_loadu_ps(dest+i),_mm_mul_ps(_mm_loadu_ps(src+i),g)));
+  }
+#elif defined(DIV_MIX_NEON)
+  const float32x4_t g=vdupq_n_f32(gain);
+  for (; i+4<=len; i+=4) {
+    vst1q_f32(dest+i,vaddq_f32(vld1q_f32(dest+i),vmulq_f32(vld1q_f32(src+i),g)));
+  }
+#endif
+  for (; i<len; i++) {
+    dest[i]+=src[i]*gain;
+  }
+}
+
+// averages every channel into the first one, then copies it back
+static inline void foldMono(float** out, int outChans, unsigned int pos, unsigned int len) {
+  const float div=1.0f/(float)outChans;
+  float* first=out[0]+pos;
+  for (int j=1; j<outChans; j++) {
+    mixFloat(first,out[j]+pos,1.0f,len);
+  }
+  unsigned int i=0;
+#if defined(DIV_MIX_SSE2)
+  const __m128 d=_mm_set1_ps(div);
+  for (; i+4<=len; i+=4) {
+    _mm_storeu_ps(first+i,_mm_mul_ps(_mm_loadu_ps(first+i),d));
+  }
+#elif defined(DIV_MIX_NEON)
+  const float32x4_t d=vdupq_n_f32(div);
+  for (; i+4<=len; i+=4) {
+    vst1q_f32(first+i,vmulq_f32(vld1q_f32(first+i),d));
+  }
+#endif
+  for (; i<len; i++) {
+    first[i]*=div;
+  }
+  for (int j=1; j<outChans; j++) {
+    memcpy(out[j]+pos,first,len*sizeof(float));
+  }
+}
+
+// clamps to -1.0..1.0
+static inline void clampBuf(float* buf, unsigned int len) {
+  unsigned int i=0;
+#if defined(DIV_MIX_SSE2)
+  const __m128 lo=_mm_set1_ps(-1.0f);
+  const __m128 hi=_mm_set1_ps(1.0f);
+  for (; i+4<=len; i+=4) {
+    _mm_storeu_ps(buf+i,_mm_min_ps(_mm_max_ps(_mm_loadu_ps(buf+i),lo),hi));
+  }
+#elif defined(DIV_MIX_NEON)
+  const float32x4_t lo=vdupq_n_f32(-1.0f);
+  const float32x4_t hi=vdupq_n_f32(1.0f);
+  for (; i+4<=len; i+=4) {
+    vst1q_f32(buf+i,vminq_f32(vmaxq_f32(vld1q_f32(buf+i),lo),hi));
+  }
+#endif
+  for (; i<len; i++) {
+    if (buf[i]<-1.0f) buf[i]=-1.0f;
+    if (buf[i]>1.0f) buf[i]=1.0f;
+  }
+}
+
+// volume of a chip output going to a system output
+static float getChipOutVol(DivSong& song, DivDispatch* disp, int sys, unsigned char destSubPort) {
+  float vol=song.systemVol[sys]*disp->getPostAmp()*song.masterVol;
+
+  switch (destSubPort&3) {
+    case 0:
+      vol*=MIN(1.0f,1.0f-song.systemPan[sys])*MIN(1.0f,1.0f+song.systemPanFR[sys]);
+      break;
+    case 1:
+      vol*=MIN(1.0f,1.0f+song.systemPan[sys])*MIN(1.0f,1.0f+song.systemPanFR[sys]);
+      break;
+    case 2:
+      vol*=MIN(1.0f,1.0f-song.systemPan[sys])*MIN(1.0f,1.0f-song.systemPanFR[sys]);
+      break;
+    case 3:
+      vol*=MIN(1.0f,1.0f+song.systemPan[sys])*MIN(1.0f,1.0f-song.systemPanFR[sys]);
+      break;
+  }
+  return vol;
+}
+
+void DivEngine::mixStems(unsigned int size) {
+  bool mustPlay=playing && !halted;
+  for (DivExportStem* i: stems) {
+    if (i->outLen<size) {
+      for (int j=0; j<2; j++) {
+        if (i->out[j]!=NULL) delete[] i->out[j];
+        i->out[j]=new float[size];
+      }
+      i->outLen=size;
+    }
+    memset(i->out[0],0,size*sizeof(float));
+    memset(i->out[1],0,size*sizeof(float));
+    if (!mustPlay) continue;
+
+    // only the chip outputs which go to the first two system outputs
+    for (unsigned int j: song.patchbay) {
+      const unsigned short srcPort=j>>16;
+      const unsigned short destPort=j&0xffff;
+      if ((srcPort>>4)!=i->sys) continue;
+      if ((destPort>>4)!=0x000) continue;
+      const unsigned char srcSubPort=srcPort&15;
+      const unsigned char destSubPort=destPort&15;
+      if (destSubPort>=2) continue;
+      if (srcSubPort>=i->cont.dispatch->getOutputCount()) continue;
+
+      float vol=getChipOutVol(song,i->cont.dispatch,i->sys,destSubPort);
+      mixShort(i->out[destSubPort],i->cont.bbOut[srcSubPort],vol/32768.0f,size);
+    }
+  }
+}
+
+// compile a patchbay connection. returns false if it doesn't go anywhere.
+static bool compileMixRoute(DivSong& song, DivDispatchContainer* disCont, unsigned int i, int outChans, bool mustPlay, float previewVol, DivMixRoute& route) {
+  const unsigned short srcPort=i>>16;
+  const unsigned short destPort=i&0xffff;
+
+  const unsigned short srcPortSet=srcPort>>4;
+  const unsigned short destPortSet=destPort>>4;
+  const unsigned char srcSubPort=srcPort&15;
+  const unsigned char destSubPort=destPort&15;
+
+  // only system outputs for now
+  if (destPortSet!=0x000) return false;
+  if (destSubPort>=outChans) return false;
+
+  if (srcPortSet<song.systemLen && mustPlay) {
+    // chip outputs
+    if (disCont[srcPortSet].dispatch==NULL) return false;
+    if (srcSubPort>=disCont[srcPortSet].dispatch->getOutputCount()) return false;
+    float vol=getChipOutVol(song,disCont[srcPortSet].dispatch,srcPortSet,destSubPort);
+    if (vol==0.0f) return false;
+    route=DivMixRoute(srcPortSet,srcSubPort,destSubPort,vol/32768.0f);
+    return true;
+  } else if (srcPortSet==0xffd) {
+    // sample preview
+    route=DivMixRoute(srcPortSet,0,destSubPort,previewVol/32768.0f);
+    return true;
+  } else if (srcPortSet==0xffe && mustPlay) {
+    // metronome
+    route=DivMixRoute(srcPortSet,0,destSubPort,1.0f);
+    return true;
+  }
+  return false;
+}
+
+// runs on the audio thread, so nothing in here may allocate.
+void DivEngine::updateMixRoutes(int outChans, bool mustPlay) {
+  // gather everything the routes depend on.
+  // this is cheap compared to mixing, and catches changes from anywhere.
+  int paramsLen=0;
+  mixParamsNext[paramsLen++]=outChans;
+  mixParamsNext[paramsLen++]=mustPlay;
+  mixParamsNext[paramsLen++]=song.systemLen;
+  mixParamsNext[paramsLen++]=song.masterVol;
+  mixParamsNext[paramsLen++]=previewVol;
+  for (int i=0; i<song.systemLen && i<DIV_MAX_CHIPS; i++) {
+    mixParamsNext[paramsLen++]=song.systemVol[i];
+    mixParamsNext[paramsLen++]=song.systemPan[i];
+    mixParamsNext[paramsLen++]=song.systemPanFR[i];
+    if (disCont[i].dispatch!=NULL) {
+      mixParamsNext[paramsLen++]=disCont[i].dispatch->getPostAmp();
+      mixParamsNext[paramsLen++]=disCont[i].dispatch->getOutputCount();
+    } else {
+      mixParamsNext[paramsLen++]=0;
+      mixParamsNext[paramsLen++]=0;
+    }
+  }
+
+  bool changed=(paramsLen!=mixParamsLen || !mixPatchbayValid || song.patchbay!=mixPatchbay);
+  for (int i=0; i<paramsLen && !changed; i++) {
+    if (mixParamsNext[i]!=mixParams[i]) changed=true;
+  }
+  if (!changed) return;
+  memcpy(mixParams,mixParamsNext,paramsLen*sizeof(float));
+  mixParamsLen=paramsLen;
+  // the copy is only kept if it fits in the reserved storage.
+  // otherwise the routes are compiled again on every buffer.
+  if (song.patchbay.size()<=mixPatchbay.capacity()) {
+    mixPatchbay.assign(song.patchbay.begin(),song.patchbay.end());
+    mixPatchbayValid=true;
+  } else {
+    mixPatchbayValid=false;
+  }
+
+  // count the routes going to each output...
+  unsigned int count[DIV_MAX_OUTPUTS];
+  memset(count,0,DIV_MAX_OUTPUTS*sizeof(unsigned int));
+  DivMixRoute route;
+  for (unsigned int i: song.patchbay) {
+    if (compileMixRoute(song,disCont,i,outChans,mustPlay,previewVol,route)) count[route.dest]++;
+  }
+  unsigned int total=0;
+  for (int i=0; i<DIV_MAX_OUTPUTS; i++) {
+    mixRouteStart[i]=total;
+    total+=count[i];
+    if (total>mixRoutes.size()) total=mixRoutes.size();
+  }
+  mixRouteStart[DIV_MAX_OUTPUTS]=total;
+
+  // ...then put them in place, keeping the patchbay order within an output
+  unsigned int pos[DIV_MAX_OUTPUTS];
+  memcpy(pos,mixRouteStart,DIV_MAX_OUTPUTS*sizeof(unsigned int));
+  for (unsigned int i: song.patchbay) {
+    if (!compileMixRoute(song,disCont,i,outChans,mustPlay,previewVol,route)) continue;
+    if (pos[route.dest]>=mixRouteStart[route.dest+1]) continue;
+    mixRoutes[pos[route.dest]++]=route;
+  }
+}
+
+void DivEngine::mixOutputs(float** out, int outChans, unsigned int size, bool mustPlay) {
+  updateMixRoutes(outChans,mustPlay);
+
+  for (unsigned int pos=0; pos<size; pos+=DIV_MIX_BLOCK) {
+    const unsigned int len=MIN(DIV_MIX_BLOCK,size-pos);
+
+    // patchbay
+    for (int j=0; j<outChans; j++) {
+      float* dest=out[j]+pos;
+      for (unsigned int r=mixRouteStart[j]; r<mixRouteStart[j+1]; r++) {
+        const DivMixRoute& route=mixRoutes[r];
+        if (route.src==0xffd) {
+          mixShort(dest,samp_bbOut+pos,route.gain,len);
+        } else if (route.src==0xffe) {
+          mixFloat(dest,metroBuf+pos,route.gain,len);
+        } else {
+          mixShort(dest,disCont[route.src].bbOut[route.srcSub]+pos,route.gain,len);
+        }
+      }
+    }
+
+    // dump to oscillator buffer
+    const unsigned int oscFirst=MIN(len,(unsigned int)(32768-oscWritePos));
+    for (int j=0; j<outChans; j++) {
+      if (oscBuf[j]==NULL) continue;
+      memcpy(oscBuf[j]+oscWritePos,out[j]+pos,oscFirst*sizeof(float));
+      if (oscFirst<len) {
+        memcpy(oscBuf[j],out[j]+pos+oscFirst,(len-oscFirst)*sizeof(float));
+      }
+    }
+    oscWritePos=(oscWritePos+len)&32767;
+
+    // force mono audio (if enabled)
+    if (forceMono && outChans>1) {
+      foldMono(out,outChans,pos,len);
+    }
+
+    // clamp output (if enabled)
+    if (clampSamples) {
+      for (int j=0; j<outChans; j++) {
+        clampBuf(out[j]+pos,len);
+      }
+    }
+  }
+  oscSize=size;
+}
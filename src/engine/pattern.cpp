@@ -20,16 +20,114 @@
 #include "engine.h"
 #include "../ta-log.h"
 
-static DivPattern emptyPat;
+static DivPattern emptyPat(0,0);
 
-DivPattern::DivPattern() {
+short& divPatternDummy(int col) {
+  static thread_local short dummy;
+  dummy=(col==0 || col==1)?0:-1;
+  return dummy;
+}
+
+DivPatternData::DivPatternData(int r, int c):
+  buf(NULL),
+  rows(0),
+  cols(0) {
+  resize(r,c);
+}
+
+DivPatternData::DivPatternData(const DivPatternData& other):
+  buf(NULL),
+  rows(0),
+  cols(0) {
+  *this=other;
+}
+
+DivPatternData::~DivPatternData() {
+  if (buf!=NULL) {
+    delete[] buf;
+    buf=NULL;
+  }
+}
+
+DivPatternData& DivPatternData::operator=(const DivPatternData& other) {
+  if (this==&other) return *this;
+  if (rows!=other.rows || cols!=other.cols) {
+    if (buf!=NULL) delete[] buf;
+    buf=NULL;
+    rows=other.rows;
+    cols=other.cols;
+    if (rows*cols>0) buf=new short[rows*cols];
+  }
+  if (buf!=NULL) memcpy(buf,other.buf,rows*cols*sizeof(short));
+  return *this;
+}
+
+bool DivPatternData::operator==(const DivPatternData& other) const {
+  if (rows==other.rows && cols==other.cols) {
+    if (buf==NULL) return true;
+    return memcmp(buf,other.buf,rows*cols*sizeof(short))==0;
+  }
+  int maxRows=MAX(rows,other.rows);
+  int maxCols=MAX(cols,other.cols);
+  for (int i=0; i<maxRows; i++) {
+    DivPatternRow a=(*this)[i];
+    DivPatternRow b=other[i];
+    for (int j=0; j<maxCols; j++) {
+      if (a[j]!=b[j]) return false;
+    }
+  }
+  return true;
+}
+
+void DivPatternData::resize(int newRows, int newCols) {
+  if (newRows<0) newRows=0;
+  if (newRows>DIV_MAX_ROWS) newRows=DIV_MAX_ROWS;
+  if (newCols<0) newCols=0;
+  if (newCols>DIV_MAX_COLS) newCols=DIV_MAX_COLS;
+  if (newRows==rows && newCols==cols) return;
+
+  short* newBuf=NULL;
+  if (newRows*newCols>0) {
+    newBuf=new short[newRows*newCols];
+    for (int i=0; i<newRows; i++) {
+      DivPatternRow oldRow=(*this)[i];
+      for (int j=0; j<newCols; j++) {
+        newBuf[i*newCols+j]=oldRow[j];
+      }
+    }
+  }
+  if (buf!=NULL) delete[] buf;
+  buf=newBuf;
+  rows=newRows;
+  cols=newCols;
+}
+
+void DivPatternData::clear() {
+  for (int i=0; i<rows; i++) {
+    short* row=buf+i*cols;
+    for (int j=0; j<cols; j++) {
+      row[j]=(j<2)?0:-1;
+    }
+  }
+}
+
+size_t DivPatternData::getMemUsage() const {
+  return rows*cols*sizeof(short);
+}
+
+DivPattern::DivPattern(int rows, int cols):
+  data(rows,cols) {
   clear();
 }
 
+// the size a pattern in this channel should have
+#define CHANNEL_PAT_ROWS ((patLen==NULL)?DIV_MAX_ROWS:CLAMP(*patLen,1,DIV_MAX_ROWS))
+#define CHANNEL_PAT_COLS (4+2*CLAMP(effectCols,1,DIV_MAX_EFFECTS))
+
 DivPattern* DivChannelData::getPattern(int index, bool create) {
   if (data[index]==NULL) {
     if (create) {
-      data[index]=new DivPattern;
+      data[index]=new DivPattern(CHANNEL_PAT_ROWS,CHANNEL_PAT_COLS);
     } else {
       return &emptyPat;
     }
@@ -45,7 +143,7 @@ std::vector<std::pair<int,int>> DivChannelData::optimize() {
       for (int j=0; j<DIV_MAX_PATTERNS; j++) {
         if (j==i) continue;
         if (data[j]==NULL) continue;
-        if (memcmp(data[i]->data,data[j]->data,DIV_MAX_ROWS*DIV_MAX_COLS*sizeof(short))==0) {
+        if (data[i]->data==data[j]->data) {
           delete data[j];
           data[j]=NULL;
           logV("%d == %d",i,j);
@@ -75,6 +173,30 @@ std::vector<std::pair<int,int>> DivChannelData::rearrange() {
   return ret;
 }
 
+void DivChannelData::fitPatterns(bool shrink) {
+  int rows=CHANNEL_PAT_ROWS;
+  int cols=CHANNEL_PAT_COLS;
+  for (int i=0; i<DIV_MAX_PATTERNS; i++) {
+    if (data[i]==NULL) continue;
+    DivPatternData& d=data[i]->data;
+    if (shrink) {
+      d.resize(rows,cols);
+    } else {
+      d.resize(MAX(d.getRows(),rows),MAX(d.getCols(),cols));
+    }
+  }
+}
+
+size_t DivChannelData::getMemUsage(int* count) {
+  size_t ret=0;
+  for (int i=0; i<DIV_MAX_PATTERNS; i++) {
+    if (data[i]==NULL) continue;
+    ret+=sizeof(DivPattern)+data[i]->data.getMemUsage();
+    if (count!=NULL) (*count)++;
+  }
+  return ret;
+}
+
 void DivChannelData::wipePatterns() {
   for (int i=0; i<DIV_MAX_PATTERNS; i++) {
     if (data[i]!=NULL) {
@@ -86,18 +208,15 @@ void DivChannelData::wipePatterns() {
 
 void DivPattern::copyOn(DivPattern* dest) {
   dest->name=name;
-  memcpy(dest->data,data,sizeof(data));
+  dest->data=data;
 }
 
 void DivPattern::clear() {
-  memset(data,-1,DIV_MAX_ROWS*DIV_MAX_COLS*sizeof(short));
-  for (int i=0; i<DIV_MAX_ROWS; i++) {
-    data[i][0]=0;
-    data[i][1]=0;
-  }
+  data.clear();
 }
 
 DivChannelData::DivChannelData():
-  effectCols(1) {
+  effectCols(1),
+  patLen(NULL) {
   memset(data,0,DIV_MAX_PATTERNS*sizeof(void*));
 }
@@ -20,9 +20,83 @@
 #include "safeReader.h"
 #include "../pch.h"
 
+/**
+ * get a scratch value for an out-of-range pattern access.
+ * it holds the empty value for that column and writes to it are lost.
+ */
+short& divPatternDummy(int col);
+
+/**
+ * a row in a pattern.
+ * out-of-range columns read as empty and ignore writes.
+ */
+class DivPatternRow {
+  short* row;
+  int cols;
+  public:
+    short& operator[](int col) const {
+      if (col>=0 && col<cols) return row[col];
+      return divPatternDummy(col);
+    }
+    DivPatternRow(short* r, int c):
+      row(r),
+      cols(c) {}
+};
+
+/**
+ * pattern data, sized to a number of rows and columns.
+ * out-of-range rows read as empty and ignore writes.
+ */
+class DivPatternData {
+  short* buf;
+  unsigned short rows;
+  unsigned char cols;
+
+  public:
+    DivPatternRow operator[](int row) const {
+      if (row>=0 && row<rows) return DivPatternRow(buf+row*cols,cols);
+      return DivPatternRow(NULL,0);
+    }
+
+    int getRows() const {
+      return rows;
+    }
+    int getCols() const {
+      return cols;
+    }
+
+    /**
+     * change the size, keeping the data that fits.
+     * not thread-safe! use a mutex!
+     * @param newRows number of rows (up to DIV_MAX_ROWS).
+     * @param newCols number of columns (up to DIV_MAX_COLS).
+     */
+    void resize(int newRows, int newCols);
+
+    /**
+     * set everything to empty.
+     */
+    void clear();
+
+    /**
+     * get the number of bytes used by the data.
+     */
+    size_t getMemUsage() const;
+
+    /**
+     * compare contents. the size doesn't matter.
+     */
+    bool operator==(const DivPatternData& other) const;
+
+    DivPatternData& operator=(const DivPatternData& other);
+    DivPatternData(const DivPatternData& other);
+    DivPatternData(int r, int c);
+    ~DivPatternData();
+};
+
 struct DivPattern {
   String name;
-  short data[DIV_MAX_ROWS][DIV_MAX_COLS];
+  DivPatternData data;
 
   /**
    * clear the pattern.
@@ -34,7 +108,13 @@ struct DivPattern {
    * @param dest the destination pattern.
    */
   void copyOn(DivPattern* dest);
-  DivPattern();
+
+  /**
+   * create a pattern.
+   * @param rows number of rows.
+   * @param cols number of columns (4 plus 2 per effect).
+   */
+  DivPattern(int rows=DIV_MAX_ROWS, int cols=DIV_MAX_COLS);
 };
 
 struct DivChannelData {
@@ -48,11 +128,16 @@ struct DivChannelData {
   // 4-5+: effect/effect value
   // do NOT access directly unless you know what you're doing!
   DivPattern* data[DIV_MAX_PATTERNS];
+  // pattern length of the subsong this channel belongs to (set by DivSubSong).
+  // new patterns are sized to this and effectCols.
+  const int* patLen;
 
   /**
    * get a pattern from this channel, or the empty pattern if not initialized.
    * @param index the pattern ID.
    * @param create whether to initialize a new pattern if not init'ed. always use true if you're going to modify it!
+   * an existing pattern is never resized here, as playback may be reading it.
+   * after raising the pattern length or effect columns, call fitPatterns() under the engine lock.
    * @return a DivPattern.
    */
   DivPattern* getPattern(int index, bool create);
@@ -71,6 +156,19 @@ struct DivChannelData {
    */
   std::vector<std::pair<int,int>> rearrange();
 
+  /**
+   * resize patterns to the pattern length and effect columns.
+   * not thread-safe! use a mutex!
+   * @param shrink whether to discard data past them as well. otherwise patterns only grow.
+   */
+  void fitPatterns(bool shrink=false);
+
+  /**
+   * get the memory used by patterns in this channel.
+   * @param count if not NULL, the number of patterns is added to it.
+   */
+  size_t getMemUsage(int* count=NULL);
+
   /**
    * destroy all patterns on this DivChannelData.
    */
@@ -23,6 +23,9 @@
 void DivDispatch::acquire(short** buf, size_t len) {
 }
 
+void DivDispatch::acquireSpans(DivSpanBuffer* out, size_t len) {
+}
+
 void DivDispatch::fillStream(std::vector<DivDelayedWrite>& stream, int sRate, size_t len) {
 }
 
@@ -69,6 +72,10 @@ int DivDispatch::getRegisterPoolDepth() {
   return 8;
 }
 
+bool DivDispatch::getStateSupported() {
+  return false;
+}
+
 void* DivDispatch::getState() {
   return NULL;
 }
@@ -76,6 +83,9 @@ void* DivDispatch::getState() {
 void DivDispatch::setState(void* state) {
 }
 
+void DivDispatch::freeState(void* state) {
+}
+
 void DivDispatch::muteChannel(int ch, bool mute) {
 }
 
@@ -127,6 +137,30 @@ bool DivDispatch::getWantPreNote() {
   return false;
 }
 
+bool DivDispatch::getTickAheadSupported() {
+  return false;
+}
+
+bool DivDispatch::getTickAheadQueueFull() {
+  return false;
+}
+
+bool DivDispatch::getSpansSupported() {
+  return false;
+}
+
+bool DivDispatch::canSleep() {
+  return false;
+}
+
+void DivDispatch::setWriteStamp(unsigned int stamp) {
+  writeStamp=stamp;
+}
+
+void DivDispatch::setAcquireStamp(unsigned int stamp) {
+  acquireStamp=stamp;
+}
+
 int DivDispatch::getClockRangeMin() {
   return MIN_CUSTOM_CLOCK;
 }
@@ -208,6 +242,10 @@ void DivDispatch::renderSamples(int sysID) {
   
 }
 
+bool DivDispatch::shareSamples(DivDispatch* from) {
+  return false;
+}
+
 void DivDispatch::notifyPitchTable() {
 }
 
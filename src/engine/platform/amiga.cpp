@@ -80,7 +80,7 @@ const char** DivPlatformAmiga::getRegisterSheet() {
   }
 
 void DivPlatformAmiga::acquire(short** buf, size_t len) {
-  thread_local int outL, outR, output;
+  int outL, outR, output;
 
   for (size_t h=0; h<len; h++) {
     if (--delay<0) delay=0;
@@ -118,8 +118,8 @@ void DivPlatformAmiga::acquire(short** buf, size_t len) {
           if (amiga.audByte[i]) {
             // read next samples
             if (!amiga.incLoc[i]) {
-              amiga.audDat[0][i]=sampleMem[(amiga.dmaLoc[i])&chipMask];
-              amiga.audDat[1][i]=sampleMem[(amiga.dmaLoc[i]+1)&chipMask];
+              amiga.audDat[0][i]=sampleMem.read((amiga.dmaLoc[i])&chipMask);
+              amiga.audDat[1][i]=sampleMem.read((amiga.dmaLoc[i]+1)&chipMask);
               amiga.incLoc[i]=true;
             }
 
@@ -182,9 +182,9 @@ void DivPlatformAmiga::acquire(short** buf, size_t len) {
           outL+=(output*sep2)>>7;
           outR+=(output*sep1)>>7;
         }
-        oscBuf[i]->data[oscBuf[i]->needle++]=(amiga.nextOut[i]*MIN(64,amiga.audVol[i]&127))<<1;
+        oscBuf[i]->putSample((amiga.nextOut[i]*MIN(64,amiga.audVol[i]&127))<<1);
       } else {
-        oscBuf[i]->data[oscBuf[i]->needle++]=0;
+        oscBuf[i]->putSample(0);
       }
     }
 
@@ -359,7 +359,7 @@ void DivPlatformAmiga::rWrite(unsigned short addr, unsigned short val) {
 
 void DivPlatformAmiga::updateWave(int ch) {
   for (int i=0; i<MIN(256,(chan[ch].audLen<<1)); i++) {
-    sampleMem[(ch<<8)|i]=chan[ch].ws.output[i]^0x80;
+    sampleMem.getData()[(ch<<8)|i]=chan[ch].ws.output[i]^0x80;
   }
 }
 
@@ -905,7 +905,7 @@ int DivPlatformAmiga::getRegisterPoolDepth() {
 }
 
 const void* DivPlatformAmiga::getSampleMem(int index) {
-  return index == 0 ? sampleMem : NULL;
+  return index == 0 ? sampleMem.getData() : NULL;
 }
 
 size_t DivPlatformAmiga::getSampleMemCapacity(int index) {
@@ -923,7 +923,7 @@ bool DivPlatformAmiga::isSampleLoaded(int index, int sample) {
 }
 
 void DivPlatformAmiga::renderSamples(int sysID) {
-  memset(sampleMem,0,2097152);
+  sampleMem.clear();
   memset(sampleOff,0,256*sizeof(unsigned int));
   memset(sampleLoaded,0,256*sizeof(bool));
 
@@ -946,7 +946,8 @@ void DivPlatformAmiga::renderSamples(int sysID) {
     int actualLength=MIN((int)(getSampleMemCapacity()-memPos),length);
     if (actualLength>0) {
       sampleOff[i]=memPos;
-      memcpy(&sampleMem[memPos],s->data8,actualLength);
+      sampleMem.grow(memPos+actualLength);
+      memcpy(&sampleMem.getData()[memPos],s->data8,actualLength);
       memPos+=actualLength;
     }
     // align memPos to short
@@ -954,6 +955,7 @@ void DivPlatformAmiga::renderSamples(int sysID) {
     sampleLoaded[i]=true;
   }
   sampleMemLen=memPos;
+  sampleMem.fit(memPos);
 }
 
 int DivPlatformAmiga::init(DivEngine* p, int channels, int sugRate, const DivConfig& flags) {
@@ -976,7 +978,9 @@ int DivPlatformAmiga::init(DivEngine* p, int channels, int sugRate, const DivCon
     }
   }
 
-  sampleMem=new unsigned char[2097152];
+  // the wavetable area is always there
+  sampleMem.init(2097152);
+  sampleMem.grow(1026);
   sampleMemLen=0;
 
   setFlags(flags);
@@ -985,7 +989,7 @@ int DivPlatformAmiga::init(DivEngine* p, int channels, int sugRate, const DivCon
 }
 
 void DivPlatformAmiga::quit() {
-  delete[] sampleMem;
+  sampleMem.quit();
   for (int i=0; i<4; i++) {
     delete oscBuf[i];
   }
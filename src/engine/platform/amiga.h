@@ -23,6 +23,7 @@
 #include "../dispatch.h"
 #include "../../fixedQueue.h"
 #include "../waveSynth.h"
+#include "../sampleMem.h"
 
 class DivPlatformAmiga: public DivDispatch {
   struct Channel: public SharedChannel<signed char> {
@@ -113,7 +114,7 @@ class DivPlatformAmiga: public DivDispatch {
 
   unsigned short regPool[256];
 
-  unsigned char* sampleMem;
+  DivSampleMem sampleMem;
   size_t sampleMemLen;
 
   int sep1, sep2;
@@ -52,7 +52,7 @@ const char** DivPlatformArcade::getRegisterSheet() {
 }
 
 void DivPlatformArcade::acquire_nuked(short** buf, size_t len) {
-  thread_local int o[2];
+  int o[2];
 
   for (size_t h=0; h<len; h++) {
     for (int i=0; i<8; i++) {
@@ -77,7 +77,7 @@ void DivPlatformArcade::acquire_nuked(short** buf, size_t len) {
 
     for (int i=0; i<8; i++) {
       int chOut=(int16_t)fm.ch_out[i];
-      oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(chOut<<1,-32768,32767);
+      oscBuf[i]->putSample(CLAMP(chOut<<1,-32768,32767));
     }
 
     if (o[0]<-32768) o[0]=-32768;
@@ -92,7 +92,7 @@ void DivPlatformArcade::acquire_nuked(short** buf, size_t len) {
 }
 
 void DivPlatformArcade::acquire_ymfm(short** buf, size_t len) {
-  thread_local int os[2];
+  int os[2];
 
   ymfm::ym2151::fm_engine* fme=fm_ymfm->debug_engine();
 
@@ -113,7 +113,7 @@ void DivPlatformArcade::acquire_ymfm(short** buf, size_t len) {
 
     for (int i=0; i<8; i++) {
       int chOut=fme->debug_channel(i)->debug_output(0)+fme->debug_channel(i)->debug_output(1);
-      oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(chOut,-32768,32767);
+      oscBuf[i]->putSample(CLAMP(chOut,-32768,32767));
     }
 
     os[0]=out_ymfm.data[0];
@@ -91,7 +91,7 @@ void DivPlatformC140::acquire_219(short** buf, size_t len) {
     buf[1][h]=c219.rout;
 
     for (int i=0; i<totalChans; i++) {
-      oscBuf[i]->data[oscBuf[i]->needle++]=(c219.voice[i].lout+c219.voice[i].rout)>>10;
+      oscBuf[i]->putSample((c219.voice[i].lout+c219.voice[i].rout)>>10);
     }
   }
 }
@@ -120,7 +120,7 @@ void DivPlatformC140::acquire_140(short** buf, size_t len) {
     buf[1][h]=c140.rout;
 
     for (int i=0; i<totalChans; i++) {
-      oscBuf[i]->data[oscBuf[i]->needle++]=(c140.voice[i].lout+c140.voice[i].rout)>>10;
+      oscBuf[i]->putSample((c140.voice[i].lout+c140.voice[i].rout)>>10);
     }
   }
 }
@@ -554,7 +554,7 @@ float DivPlatformC140::getPostAmp() {
 }
 
 const void* DivPlatformC140::getSampleMem(int index) {
-  return index == 0 ? sampleMem : NULL;
+  return index == 0 ? sampleMem.getData() : NULL;
 }
 
 size_t DivPlatformC140::getSampleMemCapacity(int index) {
@@ -580,7 +580,7 @@ bool DivPlatformC140::isSampleLoaded(int index, int sample) {
 }
 
 void DivPlatformC140::renderSamples(int sysID) {
-  memset(sampleMem,0,is219?524288:16777216);
+  sampleMem.clear();
   memset(sampleOff,0,256*sizeof(unsigned int));
   memset(sampleLoaded,0,256*sizeof(bool));
 
@@ -611,6 +611,8 @@ void DivPlatformC140::renderSamples(int sysID) {
         length=getSampleMemCapacity()-memPos;
         logW("out of C219 memory for sample %d!",i);
       }
+      sampleMem.grow(memPos+length);
+      unsigned char* mem=sampleMem.getData();
       if (s->depth==DIV_SAMPLE_DEPTH_C219) {
         unsigned char next=0;
         unsigned int sPos=0;
@@ -623,7 +625,7 @@ void DivPlatformC140::renderSamples(int sysID) {
               }
             }
           }
-          sampleMem[(memPos+i)^1]=next;
+          mem[(memPos+i)^1]=next;
         }
       } else {
         signed char next=0;
@@ -637,7 +639,7 @@ void DivPlatformC140::renderSamples(int sysID) {
               }
             }
           }
-          sampleMem[(memPos+i)^1]=next;
+          mem[(memPos+i)^1]=next;
         }
       }
       sampleOff[i]=memPos>>1;
@@ -661,14 +663,16 @@ void DivPlatformC140::renderSamples(int sysID) {
         length=getSampleMemCapacity()-memPos;
         logW("out of C140 memory for sample %d!",i);
       }
+      sampleMem.grow(memPos+length);
+      unsigned char* mem=sampleMem.getData();
       if (s->depth==DIV_SAMPLE_DEPTH_MULAW) {
         for (unsigned int i=0; i<length; i+=2) {
           if ((i>>1)>=s->lengthMuLaw) break;
           unsigned char x=s->dataMuLaw[i>>1]^0xff;
           if (x&0x80) x^=15;
           unsigned char c140Mu=(x&0x80)|((x&15)<<3)|((x&0x70)>>4);
-          sampleMem[i+memPos]=0;
-          sampleMem[1+i+memPos]=c140Mu;
+          mem[i+memPos]=0;
+          mem[1+i+memPos]=c140Mu;
         }
       } else {
         short next=0;
@@ -682,8 +686,8 @@ void DivPlatformC140::renderSamples(int sysID) {
               }
             }
           }
-          sampleMem[memPos+i]=((unsigned short)next);
-          sampleMem[memPos+i+1]=((unsigned short)next)>>8;
+          mem[memPos+i]=((unsigned short)next);
+          mem[memPos+i+1]=((unsigned short)next)>>8;
         }
       }
       sampleOff[i]=memPos>>1;
@@ -692,6 +696,30 @@ void DivPlatformC140::renderSamples(int sysID) {
     }
   }
   sampleMemLen=memPos+256;
+  sampleMem.grow(sampleMemLen);
+  sampleMem.fit(sampleMemLen);
+  updateSampleMem();
+}
+
+bool DivPlatformC140::shareSamples(DivDispatch* from) {
+  DivPlatformC140* other=(DivPlatformC140*)from;
+  if (other->is219!=is219) return false;
+  sampleMem.share(other->sampleMem);
+  sampleMemLen=other->sampleMemLen;
+  memcpy(sampleOff,other->sampleOff,256*sizeof(unsigned int));
+  memcpy(sampleLoaded,other->sampleLoaded,256*sizeof(bool));
+  updateSampleMem();
+  return true;
+}
+
+void DivPlatformC140::updateSampleMem() {
+  if (is219) {
+    c219.sample_mem=(signed char*)sampleMem.getData();
+    c219.sample_mem_len=sampleMem.getLen();
+  } else {
+    c140.sample_mem=(short*)sampleMem.getData();
+    c140.sample_mem_len=sampleMem.getLen()>>1;
+  }
 }
 
 void DivPlatformC140::set219(bool is_219) {
@@ -738,15 +766,14 @@ int DivPlatformC140::init(DivEngine* p, int channels, int sugRate, const DivConf
     isMuted[i]=false;
     oscBuf[i]=new DivDispatchOscBuffer;
   }
-  sampleMem=new unsigned char[is219?524288:16777216];
+  sampleMem.init(is219?524288:16777216);
   sampleMemLen=0;
   if (is219) {
     c219_init(&c219);
-    c219.sample_mem=(signed char*)sampleMem;
   } else {
     c140_init(&c140);
-    c140.sample_mem=(short*)sampleMem;
   }
+  updateSampleMem();
   setFlags(flags);
   reset();
 
@@ -754,7 +781,7 @@ int DivPlatformC140::init(DivEngine* p, int channels, int sugRate, const DivConf
 }
 
 void DivPlatformC140::quit() {
-  delete[] sampleMem;
+  sampleMem.quit();
   for (int i=0; i<totalChans; i++) {
     delete oscBuf[i];
   }
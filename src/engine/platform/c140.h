@@ -21,6 +21,7 @@
 #define _C140_H
 
 #include "../dispatch.h"
+#include "../sampleMem.h"
 #include "sound/c140_c219.h"
 #include "../../fixedQueue.h"
 
@@ -62,7 +63,7 @@ class DivPlatformC140: public DivDispatch {
   unsigned char groupBank[4];
   unsigned char bankType;
 
-  unsigned char* sampleMem;
+  DivSampleMem sampleMem;
   size_t sampleMemLen;
   struct QueuedWrite {
     unsigned short addr;
@@ -80,6 +81,7 @@ class DivPlatformC140: public DivDispatch {
 
   void acquire_219(short** buf, size_t len);
   void acquire_140(short** buf, size_t len);
+  void updateSampleMem();
 
   public:
     void acquire(short** buf, size_t len);
@@ -107,6 +109,7 @@ class DivPlatformC140: public DivDispatch {
     size_t getSampleMemUsage(int index = 0);
     bool isSampleLoaded(int index, int sample);
     void renderSamples(int chipID);
+    bool shareSamples(DivDispatch* from);
     int getClockRangeMin();
     int getClockRangeMax();
     void set219(bool is_219);
@@ -100,51 +100,98 @@ short DivPlatformC64::runFakeFilter(unsigned char ch, int in) {
   return CLAMP(fout,-32768,32767);
 }
 
-void DivPlatformC64::acquire(short** buf, size_t len) {
-  int dcOff=(sidCore)?0:sid->get_dc(0);
+void DivPlatformC64::applyWrite() {
+  QueuedWrite w=writes.front();
+  if (sidCore==2) {
+    dSID_write(sid_d,w.addr,w.val);
+  } else if (sidCore==1) {
+    sid_fp->write(w.addr,w.val);
+  } else {
+    sid->write(w.addr,w.val);
+  }
+  regPool[w.addr&0x1f]=w.val;
+  writes.pop();
+}
+
+// one queued write is applied per sample in every core.
+void DivPlatformC64::acquire_dSID(short* buf, size_t len) {
   for (size_t i=0; i<len; i++) {
-    if (!writes.empty()) {
-      QueuedWrite w=writes.front();
-      if (sidCore==2) {
-        dSID_write(sid_d,w.addr,w.val);
-      } else if (sidCore==1) {
-        sid_fp->write(w.addr,w.val);
-      } else {
-        sid->write(w.addr,w.val);
-      }
-      regPool[w.addr&0x1f]=w.val;
-      writes.pop();
+    if (!writes.empty()) applyWrite();
+    double o=dSID_render(sid_d);
+    buf[i]=32767*CLAMP(o,-1.0,1.0);
+    if (++writeOscBuf>=4) {
+      writeOscBuf=0;
+      oscBuf[0]->putSample(sid_d->lastOut[0]);
+      oscBuf[1]->putSample(sid_d->lastOut[1]);
+      oscBuf[2]->putSample(sid_d->lastOut[2]);
     }
-    if (sidCore==2) {
-      double o=dSID_render(sid_d);
-      buf[0][i]=32767*CLAMP(o,-1.0,1.0);
-      if (++writeOscBuf>=4) {
-        writeOscBuf=0;
-        oscBuf[0]->data[oscBuf[0]->needle++]=sid_d->lastOut[0];
-        oscBuf[1]->data[oscBuf[1]->needle++]=sid_d->lastOut[1];
-        oscBuf[2]->data[oscBuf[2]->needle++]=sid_d->lastOut[2];
-      }
-    } else if (sidCore==1) {
-      sid_fp->clock(4,&buf[0][i]);
-      if (++writeOscBuf>=4) {
-        writeOscBuf=0;
-        oscBuf[0]->data[oscBuf[0]->needle++]=runFakeFilter(0,(sid_fp->lastChanOut[0]-dcOff)>>5);
-        oscBuf[1]->data[oscBuf[1]->needle++]=runFakeFilter(1,(sid_fp->lastChanOut[1]-dcOff)>>5);
-        oscBuf[2]->data[oscBuf[2]->needle++]=runFakeFilter(2,(sid_fp->lastChanOut[2]-dcOff)>>5);
-      }
-    } else {
-      sid->clock();
-      buf[0][i]=sid->output();
-      if (++writeOscBuf>=16) {
-        writeOscBuf=0;
-        oscBuf[0]->data[oscBuf[0]->needle++]=runFakeFilter(0,(sid->last_chan_out[0]-dcOff)>>5);
-        oscBuf[1]->data[oscBuf[1]->needle++]=runFakeFilter(1,(sid->last_chan_out[1]-dcOff)>>5);
-        oscBuf[2]->data[oscBuf[2]->needle++]=runFakeFilter(2,(sid->last_chan_out[2]-dcOff)>>5);
-      }
+  }
+}
+
+void DivPlatformC64::acquire_reSIDfp(short* buf, size_t len) {
+  for (size_t i=0; i<len; i++) {
+    if (!writes.empty()) applyWrite();
+    sid_fp->clock(4,&buf[i]);
+    if (++writeOscBuf>=4) {
+      writeOscBuf=0;
+      oscBuf[0]->putSample(runFakeFilter(0,sid_fp->lastChanOut[0]>>5));
+      oscBuf[1]->putSample(runFakeFilter(1,sid_fp->lastChanOut[1]>>5));
+      oscBuf[2]->putSample(runFakeFilter(2,sid_fp->lastChanOut[2]>>5));
     }
   }
 }
 
+void DivPlatformC64::acquire_reSID(short* buf, size_t len) {
+  int dcOff=sid->get_dc(0);
+  for (size_t i=0; i<len; i++) {
+    if (!writes.empty()) applyWrite();
+    sid->clock();
+    buf[i]=sid->output();
+    if (++writeOscBuf>=16) {
+      writeOscBuf=0;
+      oscBuf[0]->putSample(runFakeFilter(0,(sid->last_chan_out[0]-dcOff)>>5));
+      oscBuf[1]->putSample(runFakeFilter(1,(sid->last_chan_out[1]-dcOff)>>5));
+      oscBuf[2]->putSample(runFakeFilter(2,(sid->last_chan_out[2]-dcOff)>>5));
+    }
+  }
+}
+
+// reSID at the output rate. the chip is clocked many cycles at once.
+// writes are still applied one cycle apart.
+void DivPlatformC64::acquire_reSIDFast(short* buf, size_t len) {
+  int dcOff=sid->get_dc(0);
+  size_t i=0;
+  while (i<len) {
+    cycle_count delta=0x40000000;
+    if (!writes.empty()) {
+      applyWrite();
+      delta=1;
+    }
+    if (sid->clock(delta,&buf[i],1)<1) continue;
+    i++;
+    oscBuf[0]->putSample(runFakeFilter(0,(sid->last_chan_out[0]-dcOff)>>5));
+    oscBuf[1]->putSample(runFakeFilter(1,(sid->last_chan_out[1]-dcOff)>>5));
+    oscBuf[2]->putSample(runFakeFilter(2,(sid->last_chan_out[2]-dcOff)>>5));
+  }
+}
+
+void DivPlatformC64::acquire(short** buf, size_t len) {
+  switch (sidCore) {
+    case 1:
+      acquire_reSIDfp(buf[0],len);
+      break;
+    case 2:
+      acquire_dSID(buf[0],len);
+      break;
+    case 3:
+      acquire_reSIDFast(buf[0],len);
+      break;
+    default:
+      acquire_reSID(buf[0],len);
+      break;
+  }
+}
+
 void DivPlatformC64::updateFilter() {
   rWrite(0x15,filtCut&7);
   rWrite(0x16,filtCut>>3);
@@ -725,7 +772,14 @@ void DivPlatformC64::setFlags(const DivConfig& flags) {
   for (int i=0; i<3; i++) {
     oscBuf[i]->rate=rate/16;
   }
-  if (sidCore>0) {
+  if (sidCore==3) {
+    // reSID does the resampling
+    rate=outRate;
+    for (int i=0; i<3; i++) {
+      oscBuf[i]->rate=rate;
+    }
+    sid->set_sampling_parameters(chipClock,SAMPLE_FAST,rate);
+  } else if (sidCore>0) {
     rate/=4;
     if (sidCore==1) sid_fp->setSamplingParameters(chipClock,reSIDfp::DECIMATE,rate,0);
   }
@@ -761,6 +815,7 @@ int DivPlatformC64::init(DivEngine* p, int channels, int sugRate, const DivConfi
   dumpWrites=false;
   skipRegisterWrites=false;
   needInitTables=true;
+  outRate=sugRate;
   writeOscBuf=0;
   for (int i=0; i<3; i++) {
     isMuted[i]=false;
@@ -76,6 +76,8 @@ class DivPlatformC64: public DivDispatch {
   unsigned char writeOscBuf;
   unsigned char sidCore;
   int filtCut, resetTime, initResetTime;
+  // output rate, used by the resampling core
+  int outRate;
 
   bool keyPriority, sidIs6581, needInitTables, no1EUpdate, multiplyRel;
   unsigned char chanOrder[3];
@@ -91,8 +93,11 @@ class DivPlatformC64: public DivDispatch {
 
   inline short runFakeFilter(unsigned char ch, int in);
 
-  void acquire_classic(short* bufL, short* bufR, size_t start, size_t len);
-  void acquire_fp(short* bufL, short* bufR, size_t start, size_t len);
+  void applyWrite();
+  void acquire_reSID(short* buf, size_t len);
+  void acquire_reSIDFast(short* buf, size_t len);
+  void acquire_reSIDfp(short* buf, size_t len);
+  void acquire_dSID(short* buf, size_t len);
 
   void updateFilter();
   public:
@@ -106,33 +106,33 @@ void DivPlatformDave::acquire(short** buf, size_t len) {
     unsigned short nextR=next>>16;
     
     if ((regPool[7]&0x18)==0x18) {
-      oscBuf[0]->data[oscBuf[0]->needle++]=0;
-      oscBuf[1]->data[oscBuf[1]->needle++]=0;
-      oscBuf[2]->data[oscBuf[2]->needle++]=0;
-      oscBuf[3]->data[oscBuf[3]->needle++]=0;
-      oscBuf[4]->data[oscBuf[4]->needle++]=dave->chn0_left<<9;
-      oscBuf[5]->data[oscBuf[5]->needle++]=dave->chn0_right<<9;
+      oscBuf[0]->putSample(0);
+      oscBuf[1]->putSample(0);
+      oscBuf[2]->putSample(0);
+      oscBuf[3]->putSample(0);
+      oscBuf[4]->putSample(dave->chn0_left<<9);
+      oscBuf[5]->putSample(dave->chn0_right<<9);
     } else if (regPool[7]&0x08) {
-      oscBuf[0]->data[oscBuf[0]->needle++]=dave->chn0_state?(dave->chn0_right<<8):0;
-      oscBuf[1]->data[oscBuf[1]->needle++]=dave->chn1_state?(dave->chn1_right<<8):0;
-      oscBuf[2]->data[oscBuf[2]->needle++]=dave->chn2_state?(dave->chn2_right<<8):0;
-      oscBuf[3]->data[oscBuf[3]->needle++]=dave->chn3_state?(dave->chn3_right<<8):0;
-      oscBuf[4]->data[oscBuf[4]->needle++]=dave->chn0_left<<9;
-      oscBuf[5]->data[oscBuf[5]->needle++]=0;
+      oscBuf[0]->putSample(dave->chn0_state?(dave->chn0_right<<8):0);
+      oscBuf[1]->putSample(dave->chn1_state?(dave->chn1_right<<8):0);
+      oscBuf[2]->putSample(dave->chn2_state?(dave->chn2_right<<8):0);
+      oscBuf[3]->putSample(dave->chn3_state?(dave->chn3_right<<8):0);
+      oscBuf[4]->putSample(dave->chn0_left<<9);
+      oscBuf[5]->putSample(0);
     } else if (regPool[7]&0x10) {
-      oscBuf[0]->data[oscBuf[0]->needle++]=dave->chn0_state?(dave->chn0_left<<8):0;
-      oscBuf[1]->data[oscBuf[1]->needle++]=dave->chn1_state?(dave->chn1_left<<8):0;
-      oscBuf[2]->data[oscBuf[2]->needle++]=dave->chn2_state?(dave->chn2_left<<8):0;
-      oscBuf[3]->data[oscBuf[3]->needle++]=dave->chn3_state?(dave->chn3_left<<8):0;
-      oscBuf[4]->data[oscBuf[4]->needle++]=0;
-      oscBuf[5]->data[oscBuf[5]->needle++]=dave->chn0_right<<9;
+      oscBuf[0]->putSample(dave->chn0_state?(dave->chn0_left<<8):0);
+      oscBuf[1]->putSample(dave->chn1_state?(dave->chn1_left<<8):0);
+      oscBuf[2]->putSample(dave->chn2_state?(dave->chn2_left<<8):0);
+      oscBuf[3]->putSample(dave->chn3_state?(dave->chn3_left<<8):0);
+      oscBuf[4]->putSample(0);
+      oscBuf[5]->putSample(dave->chn0_right<<9);
     } else {
-      oscBuf[0]->data[oscBuf[0]->needle++]=dave->chn0_state?((dave->chn0_left+dave->chn0_right)<<8):0;
-      oscBuf[1]->data[oscBuf[1]->needle++]=dave->chn1_state?((dave->chn1_left+dave->chn1_right)<<8):0;
-      oscBuf[2]->data[oscBuf[2]->needle++]=dave->chn2_state?((dave->chn2_left+dave->chn2_right)<<8):0;
-      oscBuf[3]->data[oscBuf[3]->needle++]=dave->chn3_state?((dave->chn3_left+dave->chn3_right)<<8):0;
-      oscBuf[4]->data[oscBuf[4]->needle++]=0;
-      oscBuf[5]->data[oscBuf[5]->needle++]=0;
+      oscBuf[0]->putSample(dave->chn0_state?((dave->chn0_left+dave->chn0_right)<<8):0);
+      oscBuf[1]->putSample(dave->chn1_state?((dave->chn1_left+dave->chn1_right)<<8):0);
+      oscBuf[2]->putSample(dave->chn2_state?((dave->chn2_left+dave->chn2_right)<<8):0);
+      oscBuf[3]->putSample(dave->chn3_state?((dave->chn3_left+dave->chn3_right)<<8):0);
+      oscBuf[4]->putSample(0);
+      oscBuf[5]->putSample(0);
     }
     
     buf[0][h]=(short)nextL;
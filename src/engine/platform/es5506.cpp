@@ -166,7 +166,7 @@ void DivPlatformES5506::acquire(short** buf, size_t len) {
       buf[(o<<1)|1][h]=es5506.rout(o);
     }
     for (int i=chanMax; i>=0; i--) {
-      oscBuf[i]->data[oscBuf[i]->needle++]=(es5506.voice_lout(i)+es5506.voice_rout(i))>>5;
+      oscBuf[i]->putSample((es5506.voice_lout(i)+es5506.voice_rout(i))>>5);
     }
   }
 }
@@ -1186,7 +1186,7 @@ int DivPlatformES5506::getRegisterPoolSize() {
   return 4*16*128; // 7 bit page x 16 registers per page x 32 bit per registers
 }
 const void* DivPlatformES5506::getSampleMem(int index) {
-  return index == 0 ? sampleMem : NULL;
+  return index == 0 ? sampleMem.getData() : NULL;
 }
 
 size_t DivPlatformES5506::getSampleMemCapacity(int index) {
@@ -1204,7 +1204,7 @@ bool DivPlatformES5506::isSampleLoaded(int index, int sample) {
 }
 
 void DivPlatformES5506::renderSamples(int sysID) {
-  memset(sampleMem,0,getSampleMemCapacity());
+  sampleMem.clear();
   memset(sampleOffES5506,0,256*sizeof(unsigned int));
   memset(sampleLoaded,0,256*sizeof(bool));
 
@@ -1228,21 +1228,33 @@ void DivPlatformES5506::renderSamples(int sysID) {
       logW("out of ES5506 memory for sample %d!",i);
       break;
     }
+    sampleMem.grow(memPos+length);
     if (memPos+length>=(getSampleMemCapacity()-128)) {
-      memcpy(sampleMem+(memPos/sizeof(short)),s->data16,(getSampleMemCapacity()-128)-memPos);
+      memcpy(sampleMem.getData()+memPos,s->data16,(getSampleMemCapacity()-128)-memPos);
       logW("out of ES5506 memory for sample %d!",i);
     } else {
-      memcpy(sampleMem+(memPos/sizeof(short)),s->data16,length);
+      memcpy(sampleMem.getData()+memPos,s->data16,length);
     }
     sampleOffES5506[i]=memPos;
     sampleLoaded[i]=true;
     memPos+=length;
   }
   sampleMemLen=memPos+256;
+  sampleMem.grow(sampleMemLen);
+  sampleMem.fit(sampleMemLen);
+}
+
+bool DivPlatformES5506::shareSamples(DivDispatch* from) {
+  DivPlatformES5506* other=(DivPlatformES5506*)from;
+  sampleMem.share(other->sampleMem);
+  sampleMemLen=other->sampleMemLen;
+  memcpy(sampleOffES5506,other->sampleOffES5506,256*sizeof(unsigned int));
+  memcpy(sampleLoaded,other->sampleLoaded,256*sizeof(bool));
+  return true;
 }
 
 int DivPlatformES5506::init(DivEngine* p, int channels, int sugRate, const DivConfig& flags) {
-  sampleMem=new signed short[getSampleMemCapacity()/sizeof(short)];
+  sampleMem.init(getSampleMemCapacity());
   sampleMemLen=0;
   parent=p;
   dumpWrites=false;
@@ -1262,7 +1274,7 @@ int DivPlatformES5506::init(DivEngine* p, int channels, int sugRate, const DivCo
 }
 
 void DivPlatformES5506::quit() {
-  delete[] sampleMem;
+  sampleMem.quit();
   for (int i=0; i<32; i++) {
     delete oscBuf[i];
   }
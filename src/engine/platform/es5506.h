@@ -25,6 +25,7 @@
 #include "../../fixedQueue.h"
 #include "../macroInt.h"
 #include "../sample.h"
+#include "../sampleMem.h"
 #include "vgsound_emu/src/es550x/es5506.hpp"
 
 class DivPlatformES5506: public DivDispatch, public es550x_intf {
@@ -225,7 +226,7 @@ class DivPlatformES5506: public DivDispatch, public es550x_intf {
   Channel chan[32];
   DivDispatchOscBuffer* oscBuf[32];
   bool isMuted[32];
-  signed short* sampleMem; // ES5506 uses 16 bit data bus for samples
+  DivSampleMem sampleMem; // ES5506 uses 16 bit data bus for samples
   size_t sampleMemLen;
   unsigned int sampleOffES5506[256];
   bool sampleLoaded[256];
@@ -287,8 +288,9 @@ class DivPlatformES5506: public DivDispatch, public es550x_intf {
     virtual void e_pin(bool state) override;     // E output
     virtual void irqb(bool state) override; // IRQB output
     virtual s16 read_sample(u8 bank, u32 address) override {
-      if (sampleMem==NULL) return 0;
-      return sampleMem[((bank&3)<<21)|(address&0x1fffff)];
+      size_t pos=((bank&3)<<21)|(address&0x1fffff);
+      if (pos>=(sampleMem.getLen()>>1)) return 0;
+      return ((signed short*)sampleMem.getData())[pos];
     }
 
     virtual void acquire(short** buf, size_t len) override;
@@ -316,6 +318,7 @@ class DivPlatformES5506: public DivDispatch, public es550x_intf {
     virtual size_t getSampleMemUsage(int index = 0) override;
     virtual bool isSampleLoaded(int index, int sample) override;
     virtual void renderSamples(int sysID) override;
+    virtual bool shareSamples(DivDispatch* from) override;
     virtual const char** getRegisterSheet() override;
     virtual int init(DivEngine* parent, int channels, int sugRate, const DivConfig& flags) override;
     virtual void quit() override;
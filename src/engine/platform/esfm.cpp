@@ -38,7 +38,7 @@
 #define KEY_ON_REGS_START (18*8*4)
 
 void DivPlatformESFM::acquire(short** buf, size_t len) {
-  thread_local short o[2];
+  short o[2];
   for (size_t h=0; h<len; h++) {
     if (!writes.empty()) {
       QueuedWrite& w=writes.front();
@@ -51,7 +51,7 @@ void DivPlatformESFM::acquire(short** buf, size_t len) {
 
     ESFM_generate(&chip,o);
     for (int c=0; c<18; c++) {
-      oscBuf[c]->data[oscBuf[c]->needle++]=ESFM_get_channel_output_native(&chip,c);
+      oscBuf[c]->putSample(ESFM_get_channel_output_native(&chip,c));
     }
 
     buf[0][h]=o[0];
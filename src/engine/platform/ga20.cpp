@@ -80,14 +80,14 @@ void DivPlatformGA20::acquire(short** buf, size_t len) {
     ga20.sound_stream_update(buffer,1);
     buf[0][h]=(signed int)(ga20Buf[0][h]+ga20Buf[1][h]+ga20Buf[2][h]+ga20Buf[3][h])>>2;
     for (int i=0; i<4; i++) {
-      oscBuf[i]->data[oscBuf[i]->needle++]=ga20Buf[i][h]>>1;
+      oscBuf[i]->putSample(ga20Buf[i][h]>>1);
     }
   }
 }
 
 u8 DivPlatformGA20::read_byte(u32 address) {
-  if ((sampleMem!=NULL) && (address<getSampleMemCapacity())) {
-    return sampleMem[address&0xfffff];
+  if (address<getSampleMemCapacity()) {
+    return sampleMem.read(address&0xfffff);
   }
   return 0;
 }
@@ -424,7 +424,7 @@ int DivPlatformGA20::getRegisterPoolSize() {
 }
 
 const void* DivPlatformGA20::getSampleMem(int index) {
-  return index == 0 ? sampleMem : NULL;
+  return index == 0 ? sampleMem.getData() : NULL;
 }
 
 size_t DivPlatformGA20::getSampleMemCapacity(int index) {
@@ -442,7 +442,7 @@ bool DivPlatformGA20::isSampleLoaded(int index, int sample) {
 }
 
 void DivPlatformGA20::renderSamples(int sysID) {
-  memset(sampleMem,0x00,getSampleMemCapacity());
+  sampleMem.clear();
   memset(sampleOffGA20,0,256*sizeof(unsigned int));
   memset(sampleLoaded,0,256*sizeof(bool));
 
@@ -458,13 +458,15 @@ void DivPlatformGA20::renderSamples(int sysID) {
     int actualLength=MIN((int)(getSampleMemCapacity()-memPos)-1,length);
     if (actualLength>0) {
       sampleOffGA20[i]=memPos;
+      sampleMem.grow(memPos+actualLength+1);
+      unsigned char* mem=sampleMem.getData();
       for (int j=0; j<actualLength; j++) {
         // convert to 8 bit unsigned
         unsigned char val=((unsigned char)(s->data8[j]))^0x80;
-        sampleMem[memPos++]=CLAMP(val,0x01,0xff);
+        mem[memPos++]=CLAMP(val,0x01,0xff);
       }
       // write end of sample marker
-      memset(&sampleMem[memPos],0x00,1);
+      memset(&mem[memPos],0x00,1);
       memPos+=1;
     }
     if ((memPos+MAX(actualLength,0))>=(getSampleMemCapacity()-1)) {
@@ -477,6 +479,17 @@ void DivPlatformGA20::renderSamples(int sysID) {
     memPos=(memPos+0xf)&~0xf;
   }
   sampleMemLen=memPos;
+  sampleMem.grow(memPos);
+  sampleMem.fit(memPos);
+}
+
+bool DivPlatformGA20::shareSamples(DivDispatch* from) {
+  DivPlatformGA20* other=(DivPlatformGA20*)from;
+  sampleMem.share(other->sampleMem);
+  sampleMemLen=other->sampleMemLen;
+  memcpy(sampleOffGA20,other->sampleOffGA20,256*sizeof(unsigned int));
+  memcpy(sampleLoaded,other->sampleLoaded,256*sizeof(bool));
+  return true;
 }
 
 int DivPlatformGA20::init(DivEngine* p, int channels, int sugRate, const DivConfig& flags) {
@@ -488,7 +501,7 @@ int DivPlatformGA20::init(DivEngine* p, int channels, int sugRate, const DivConf
     isMuted[i]=false;
     oscBuf[i]=new DivDispatchOscBuffer;
   }
-  sampleMem=new unsigned char[getSampleMemCapacity()];
+  sampleMem.init(getSampleMemCapacity());
   sampleMemLen=0;
   delay=0;
   setFlags(flags);
@@ -500,7 +513,7 @@ int DivPlatformGA20::init(DivEngine* p, int channels, int sugRate, const DivConf
 }
 
 void DivPlatformGA20::quit() {
-  delete[] sampleMem;
+  sampleMem.quit();
   for (int i=0; i<4; i++) {
     delete[] ga20Buf[i];
     delete oscBuf[i];
@@ -23,6 +23,7 @@
 #include "../dispatch.h"
 #include "../../fixedQueue.h"
 #include "../macroInt.h"
+#include "../sampleMem.h"
 #include "sound/ga20/iremga20.h"
 
 class DivPlatformGA20: public DivDispatch, public iremga20_intf {
@@ -63,7 +64,7 @@ class DivPlatformGA20: public DivDispatch, public iremga20_intf {
   short* ga20Buf[4];
   size_t ga20BufLen;
 
-  unsigned char* sampleMem;
+  DivSampleMem sampleMem;
   size_t sampleMemLen;
   iremga20_device ga20;
   unsigned char regPool[32];
@@ -98,6 +99,7 @@ class DivPlatformGA20: public DivDispatch, public iremga20_intf {
     virtual size_t getSampleMemUsage(int index = 0) override;
     virtual bool isSampleLoaded(int index, int sample) override;
     virtual void renderSamples(int chipID) override;
+    virtual bool shareSamples(DivDispatch* from) override;
     virtual int init(DivEngine* parent, int channels, int sugRate, const DivConfig& flags) override;
     virtual void quit() override;
     DivPlatformGA20():
@@ -22,8 +22,8 @@
 #include "../../ta-log.h"
 #include <math.h>
 
-#define rWrite(a,v) if (!skipRegisterWrites) {writes.push(QueuedWrite(a,v)); regPool[(a)&0x7f]=v; if (dumpWrites) {addWrite(a,v);} }
-#define immWrite(a,v) {writes.push(QueuedWrite(a,v)); regPool[(a)&0x7f]=v; if (dumpWrites) {addWrite(a,v);} }
+#define rWrite(a,v) if (!skipRegisterWrites) {writes.push(QueuedWrite(a,v,writeStamp)); regPool[(a)&0x7f]=v; if (dumpWrites) {addWrite(a,v);} }
+#define immWrite(a,v) {writes.push(QueuedWrite(a,v,writeStamp)); regPool[(a)&0x7f]=v; if (dumpWrites) {addWrite(a,v);} }
 
 #define CHIP_DIVIDER 16
 
@@ -64,7 +64,7 @@ const char** DivPlatformGB::getRegisterSheet() {
 
 void DivPlatformGB::acquire(short** buf, size_t len) {
   for (size_t i=0; i<len; i++) {
-    if (!writes.empty()) {
+    if (!writes.empty() && TICK_AHEAD_READY(writes.front())) {
       QueuedWrite& w=writes.front();
       GB_apu_write(gb,w.addr,w.val);
       writes.pop();
@@ -75,7 +75,7 @@ void DivPlatformGB::acquire(short** buf, size_t len) {
     buf[1][i]=gb->apu_output.final_sample.right;
 
     for (int i=0; i<4; i++) {
-      oscBuf[i]->data[oscBuf[i]->needle++]=(gb->apu_output.current_sample[i].left+gb->apu_output.current_sample[i].right)<<6;
+      oscBuf[i]->putSample((gb->apu_output.current_sample[i].left+gb->apu_output.current_sample[i].right)<<6);
     }
   }
 }
@@ -633,6 +633,46 @@ bool DivPlatformGB::getDCOffRequired() {
   return (model==GB_MODEL_AGB);
 }
 
+bool DivPlatformGB::getTickAheadSupported() {
+  return true;
+}
+
+bool DivPlatformGB::getTickAheadQueueFull() {
+  return TICK_AHEAD_QUEUE_FULL(writes);
+}
+
+bool DivPlatformGB::getStateSupported() {
+  return true;
+}
+
+void* DivPlatformGB::getState() {
+  State* s=new State;
+  for (int i=0; i<4; i++) {
+    s->chan[i]=chan[i];
+  }
+  s->ws=ws;
+  s->lastPan=lastPan;
+  s->antiClickPeriodCount=antiClickPeriodCount;
+  s->antiClickWavePos=antiClickWavePos;
+  return s;
+}
+
+void DivPlatformGB::setState(void* state) {
+  State* s=(State*)state;
+  if (s==NULL) return;
+  for (int i=0; i<4; i++) {
+    chan[i]=s->chan[i];
+  }
+  ws=s->ws;
+  lastPan=s->lastPan;
+  antiClickPeriodCount=s->antiClickPeriodCount;
+  antiClickWavePos=s->antiClickWavePos;
+}
+
+void DivPlatformGB::freeState(void* state) {
+  delete (State*)state;
+}
+
 void DivPlatformGB::notifyInsChange(int ins) {
   for (int i=0; i<4; i++) {
     if (chan[i].ins==ins) {
@@ -64,10 +64,17 @@ class DivPlatformGB: public DivDispatch {
   struct QueuedWrite {
     unsigned char addr;
     unsigned char val;
-    QueuedWrite(): addr(0), val(0) {}
-    QueuedWrite(unsigned char a, unsigned char v): addr(a), val(v) {}
+    unsigned int stamp;
+    QueuedWrite(): addr(0), val(0), stamp(0) {}
+    QueuedWrite(unsigned char a, unsigned char v, unsigned int s): addr(a), val(v), stamp(s) {}
   };
   FixedQueue<QueuedWrite,256> writes;
+  struct State {
+    Channel chan[4];
+    DivWaveSynth ws;
+    unsigned char lastPan;
+    int antiClickPeriodCount, antiClickWavePos;
+  };
 
   int antiClickPeriodCount, antiClickWavePos;
 
@@ -95,6 +102,12 @@ class DivPlatformGB: public DivDispatch {
     int getPortaFloor(int ch);
     int getOutputCount();
     bool getDCOffRequired();
+    bool getTickAheadSupported();
+    bool getTickAheadQueueFull();
+    bool getStateSupported();
+    void* getState();
+    void setState(void* state);
+    void freeState(void* state);
     void notifyInsChange(int ins);
     void notifyWaveChange(int wave);
     void notifyInsDeletion(void* ins);
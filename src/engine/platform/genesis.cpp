@@ -131,15 +131,48 @@ void DivPlatformGenesis::processDAC(int iRate) {
   }
 }
 
-void DivPlatformGenesis::acquire_nuked(short** buf, size_t len) {
-  thread_local short o[2];
-  thread_local int os[2];
+// clock one channel slot (one sixth of a sample)
+template<bool osc> inline void DivPlatformGenesis::clockNuked(int ch, int* os, bool isYM3438) {
+  short o[2];
+  OPN2_Clock(&fm,o);
+  if (isYM3438) {
+    os[0]+=CLAMP(o[0],-8192,8191);
+    os[1]+=CLAMP(o[1],-8192,8191);
+  } else {
+    os[0]+=o[0];
+    os[1]+=o[1];
+  }
+  if (osc) {
+    if (ch==5) {
+      if (fm.dacen) {
+        if (softPCM) {
+          oscBuf[5]->putSample(chan[5].dacOutput<<6);
+          oscBuf[6]->putSample(chan[6].dacOutput<<6);
+        } else {
+          oscBuf[ch]->putSample(((fm.dacdata^0x100)-0x100)<<6);
+          oscBuf[6]->putSample(0);
+        }
+      } else {
+        oscBuf[ch]->putSample(CLAMP(fm.ch_out[ch]<<(isYM3438?1:6),-32768,32767));
+        oscBuf[6]->putSample(0);
+      }
+    } else {
+      oscBuf[ch]->putSample(CLAMP(fm.ch_out[ch]<<(isYM3438?1:6),-32768,32767));
+    }
+  }
+}
+
+template<bool osc> void DivPlatformGenesis::acquire_nuked(short** buf, size_t len) {
+  int os[2];
+  const bool isYM3438=(chipType==2);
 
   for (size_t h=0; h<len; h++) {
     processDAC(rate);
 
     os[0]=0; os[1]=0;
-    for (int i=0; i<6; i++) {
+    int i=0;
+    // go slot by slot while there is something to write
+    for (; i<6; i++) {
       if (!writes.empty()) {
         QueuedWrite& w=writes.front();
         if (w.addrOrVal) {
@@ -170,40 +203,21 @@ void DivPlatformGenesis::acquire_nuked(short** buf, size_t len) {
           dacWrite=-1;
         }
         flushFirst=false;
+        // the queue stays empty until the next sample
+        if (writes.empty()) break;
       }
-      
-      OPN2_Clock(&fm,o);
-      if (chipType==2) {
-        os[0]+=CLAMP(o[0],-8192,8191);
-        os[1]+=CLAMP(o[1],-8192,8191);
-      } else {
-        os[0]+=o[0];
-        os[1]+=o[1];
-      }
-      //OPN2_Write(&fm,0,0);
-      if (i==5) {
-        if (fm.dacen) {
-          if (softPCM) {
-            oscBuf[5]->data[oscBuf[5]->needle++]=chan[5].dacOutput<<6;
-            oscBuf[6]->data[oscBuf[6]->needle++]=chan[6].dacOutput<<6;
-          } else {
-            oscBuf[i]->data[oscBuf[i]->needle++]=((fm.dacdata^0x100)-0x100)<<6;
-            oscBuf[6]->data[oscBuf[6]->needle++]=0;
-          }
-        } else {
-          oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(fm.ch_out[i]<<(chipType==2?1:6),-32768,32767);
-          oscBuf[6]->data[oscBuf[6]->needle++]=0;
-        }
-      } else {
-        oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(fm.ch_out[i]<<(chipType==2?1:6),-32768,32767);
-      }
+      clockNuked<osc>(i,os,isYM3438);
+    }
+    // then clock the rest without looking at the queue
+    for (; i<6; i++) {
+      clockNuked<osc>(i,os,isYM3438);
     }
     
-    if (chipType!=2) os[0]=(os[0]<<5);
+    if (!isYM3438) os[0]=(os[0]<<5);
     if (os[0]<-32768) os[0]=-32768;
     if (os[0]>32767) os[0]=32767;
 
-    if (chipType!=2) os[1]=(os[1]<<5);
+    if (!isYM3438) os[1]=(os[1]<<5);
     if (os[1]<-32768) os[1]=-32768;
     if (os[1]>32767) os[1]=32767;
   
@@ -212,10 +226,14 @@ void DivPlatformGenesis::acquire_nuked(short** buf, size_t len) {
   }
 }
 
-void DivPlatformGenesis::acquire_ymfm(short** buf, size_t len) {
-  thread_local int os[2];
+template<bool osc> void DivPlatformGenesis::acquire_ymfm(short** buf, size_t len) {
+  int os[2];
 
   ymfm::ym2612::fm_engine* fme=fm_ymfm->debug_engine();
+  ymfm::fm_channel<ymfm::opna_registers>* fmChan[6];
+  for (int i=0; i<6; i++) {
+    fmChan[i]=fme->debug_channel(i);
+  }
 
   for (size_t h=0; h<len; h++) {
     processDAC(rate);
@@ -256,25 +274,21 @@ void DivPlatformGenesis::acquire_ymfm(short** buf, size_t len) {
     os[1]=out_ymfm.data[1];
     //OPN2_Write(&fm,0,0);
 
-    for (int i=0; i<6; i++) {
-      int chOut=(fme->debug_channel(i)->debug_output(0)+fme->debug_channel(i)->debug_output(1))<<5;
-      if (chOut<-32768) chOut=-32768;
-      if (chOut>32767) chOut=32767;
-      if (i==5) {
-        if (fm_ymfm->debug_dac_enable()) {
-          if (softPCM) {
-            oscBuf[5]->data[oscBuf[5]->needle++]=chan[5].dacOutput<<6;
-            oscBuf[6]->data[oscBuf[6]->needle++]=chan[6].dacOutput<<6;
-          } else {
-            oscBuf[i]->data[oscBuf[i]->needle++]=((fm_ymfm->debug_dac_data()^0x100)-0x100)<<6;
-            oscBuf[6]->data[oscBuf[6]->needle++]=0;
-          }
+    if (osc) {
+      for (int i=0; i<5; i++) {
+        oscBuf[i]->putSample(CLAMP((fmChan[i]->debug_output(0)+fmChan[i]->debug_output(1))<<5,-32768,32767));
+      }
+      if (fm_ymfm->debug_dac_enable()) {
+        if (softPCM) {
+          oscBuf[5]->putSample(chan[5].dacOutput<<6);
+          oscBuf[6]->putSample(chan[6].dacOutput<<6);
         } else {
-          oscBuf[i]->data[oscBuf[i]->needle++]=chOut;
-          oscBuf[6]->data[oscBuf[6]->needle++]=0;
+          oscBuf[5]->putSample(((fm_ymfm->debug_dac_data()^0x100)-0x100)<<6);
+          oscBuf[6]->putSample(0);
         }
       } else {
-        oscBuf[i]->data[oscBuf[i]->needle++]=chOut;
+        oscBuf[5]->putSample(CLAMP((fmChan[5]->debug_output(0)+fmChan[5]->debug_output(1))<<5,-32768,32767));
+        oscBuf[6]->putSample(0);
       }
     }
     
@@ -297,9 +311,17 @@ void DivPlatformGenesis::acquire(short** buf, size_t len) {
   if (useYMFM==2) {
     acquire_nuked276(buf,len);
   } else if (useYMFM==1) {
-    acquire_ymfm(buf,len);
+    if (oscBuf[0]->isEnabled()) {
+      acquire_ymfm<true>(buf,len);
+    } else {
+      acquire_ymfm<false>(buf,len);
+    }
   } else {
-    acquire_nuked(buf,len);
+    if (oscBuf[0]->isEnabled()) {
+      acquire_nuked<true>(buf,len);
+    } else {
+      acquire_nuked<false>(buf,len);
+    }
   }
 }
 
@@ -97,9 +97,11 @@ class DivPlatformGenesis: public DivPlatformOPN {
 
     inline void processDAC(int iRate);
     inline void commitState(int ch, DivInstrument* ins);
-    void acquire_nuked(short** buf, size_t len);
+    // osc: whether to feed the oscilloscope taps
+    template<bool osc> inline void clockNuked(int ch, int* os, bool isYM3438);
+    template<bool osc> void acquire_nuked(short** buf, size_t len);
     void acquire_nuked276(short** buf, size_t len);
-    void acquire_ymfm(short** buf, size_t len);
+    template<bool osc> void acquire_ymfm(short** buf, size_t len);
   
     friend void putDispatchChip(void*,int);
     friend void putDispatchChan(void*,int,int);
@@ -81,7 +81,7 @@ void DivPlatformK007232::acquire(short** buf, size_t len) {
       if (++oscDivider>=8) {
         oscDivider=0;
         for (int i=0; i<2; i++) {
-          oscBuf[i]->data[oscBuf[i]->needle++]=(lout[i]+rout[i])<<3;
+          oscBuf[i]->putSample((lout[i]+rout[i])<<3);
         }
       }
     } else {
@@ -91,7 +91,7 @@ void DivPlatformK007232::acquire(short** buf, size_t len) {
       if (++oscDivider>=8) {
         oscDivider=0;
         for (int i=0; i<2; i++) {
-          oscBuf[i]->data[oscBuf[i]->needle++]=out[i]<<4;
+          oscBuf[i]->putSample(out[i]<<4);
         }
       }
     }
@@ -99,8 +99,8 @@ void DivPlatformK007232::acquire(short** buf, size_t len) {
 }
 
 u8 DivPlatformK007232::read_sample(u8 ne, u32 address) {
-  if ((sampleMem!=NULL) && (address<getSampleMemCapacity())) {
-    return sampleMem[((regPool[0x12+(ne&1)]<<17)|(address&0x1ffff))&0xffffff];
+  if (address<getSampleMemCapacity()) {
+    return sampleMem.read(((regPool[0x12+(ne&1)]<<17)|(address&0x1ffff))&0xffffff);
   }
   return 0;
 }
@@ -511,7 +511,7 @@ int DivPlatformK007232::getRegisterPoolSize() {
 }
 
 const void* DivPlatformK007232::getSampleMem(int index) {
-  return index == 0 ? sampleMem : NULL;
+  return index == 0 ? sampleMem.getData() : NULL;
 }
 
 size_t DivPlatformK007232::getSampleMemCapacity(int index) {
@@ -529,7 +529,7 @@ bool DivPlatformK007232::isSampleLoaded(int index, int sample) {
 }
 
 void DivPlatformK007232::renderSamples(int sysID) {
-  memset(sampleMem,0xc0,getSampleMemCapacity());
+  sampleMem.clear();
   memset(sampleOffK007232,0,256*sizeof(unsigned int));
   memset(sampleLoaded,0,256*sizeof(bool));
 
@@ -551,13 +551,15 @@ void DivPlatformK007232::renderSamples(int sysID) {
         memPos=(memPos+0x1ffff)&0xfe0000;
       }
       sampleOffK007232[i]=memPos;
+      sampleMem.grow(memPos+actualLength+1);
+      unsigned char* mem=sampleMem.getData();
       for (int j=0; j<actualLength; j++) {
         // convert to 7 bit unsigned
         unsigned char val=(unsigned char)(s->data8[j])^0x80;
-        sampleMem[memPos++]=(val>>1)&0x7f;
+        mem[memPos++]=(val>>1)&0x7f;
       }
       // write end of sample marker
-      memset(&sampleMem[memPos],0xc0,1);
+      memset(&mem[memPos],0xc0,1);
       memPos+=1;
     }
     if ((memPos+MAX(actualLength,0))>=(getSampleMemCapacity()-1)) {
@@ -568,6 +570,16 @@ void DivPlatformK007232::renderSamples(int sysID) {
     }
   }
   sampleMemLen=memPos;
+  sampleMem.fit(memPos);
+}
+
+bool DivPlatformK007232::shareSamples(DivDispatch* from) {
+  DivPlatformK007232* other=(DivPlatformK007232*)from;
+  sampleMem.share(other->sampleMem);
+  sampleMemLen=other->sampleMemLen;
+  memcpy(sampleOffK007232,other->sampleOffK007232,256*sizeof(unsigned int));
+  memcpy(sampleLoaded,other->sampleLoaded,256*sizeof(bool));
+  return true;
 }
 
 int DivPlatformK007232::init(DivEngine* p, int channels, int sugRate, const DivConfig& flags) {
@@ -579,7 +591,8 @@ int DivPlatformK007232::init(DivEngine* p, int channels, int sugRate, const DivC
     isMuted[i]=false;
     oscBuf[i]=new DivDispatchOscBuffer;
   }
-  sampleMem=new unsigned char[getSampleMemCapacity()];
+  // unused memory reads as end of sample
+  sampleMem.init(getSampleMemCapacity(),0xc0);
   sampleMemLen=0;
   oscDivider=0;
   setFlags(flags);
@@ -589,7 +602,7 @@ int DivPlatformK007232::init(DivEngine* p, int channels, int sugRate, const DivC
 }
 
 void DivPlatformK007232::quit() {
-  delete[] sampleMem;
+  sampleMem.quit();
   for (int i=0; i<2; i++) {
     delete oscBuf[i];
   }
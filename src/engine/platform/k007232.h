@@ -23,6 +23,7 @@
 #include "../dispatch.h"
 #include "../../fixedQueue.h"
 #include "../macroInt.h"
+#include "../sampleMem.h"
 #include "vgsound_emu/src/k007232/k007232.hpp"
 
 class DivPlatformK007232: public DivDispatch, public k007232_intf {
@@ -71,7 +72,7 @@ class DivPlatformK007232: public DivDispatch, public k007232_intf {
   unsigned char lastLoop, lastVolume, oscDivider;
   bool stereo;
 
-  unsigned char* sampleMem;
+  DivSampleMem sampleMem;
   size_t sampleMemLen;
   k007232_core k007232;
   unsigned char regPool[20];
@@ -106,6 +107,7 @@ class DivPlatformK007232: public DivDispatch, public k007232_intf {
     size_t getSampleMemUsage(int index = 0);
     bool isSampleLoaded(int index, int sample);
     void renderSamples(int chipID);
+    bool shareSamples(DivDispatch* from);
     int init(DivEngine* parent, int channels, int sugRate, const DivConfig& flags);
     void quit();
     DivPlatformK007232():
@@ -62,8 +62,8 @@ inline void DivPlatformK053260::chWrite(unsigned char ch, unsigned int addr, uns
 }
 
 u8 DivPlatformK053260::read_sample(u32 address) {
-  if ((sampleMem!=NULL) && (address<getSampleMemCapacity())) {
-    return sampleMem[address&0x1fffff];
+  if (address<getSampleMemCapacity()) {
+    return sampleMem.read(address&0x1fffff);
   }
   return 0;
 }
@@ -81,7 +81,7 @@ void DivPlatformK053260::acquire(short** buf, size_t len) {
     buf[1][i]=rout;
 
     for (int i=0; i<4; i++) {
-      oscBuf[i]->data[oscBuf[i]->needle++]=(k053260.voice_out(i,0)+k053260.voice_out(i,1))>>2;
+      oscBuf[i]->putSample((k053260.voice_out(i,0)+k053260.voice_out(i,1))>>2);
     }
   }
 }
@@ -449,7 +449,7 @@ int DivPlatformK053260::getRegisterPoolSize() {
 }
 
 const void* DivPlatformK053260::getSampleMem(int index) {
-  return index == 0 ? sampleMem : NULL;
+  return index == 0 ? sampleMem.getData() : NULL;
 }
 
 size_t DivPlatformK053260::getSampleMemCapacity(int index) {
@@ -467,7 +467,7 @@ bool DivPlatformK053260::isSampleLoaded(int index, int sample) {
 }
 
 void DivPlatformK053260::renderSamples(int sysID) {
-  memset(sampleMem,0,getSampleMemCapacity());
+  sampleMem.clear();
   memset(sampleOffK053260,0,256*sizeof(unsigned int));
   memset(sampleLoaded,0,256*sizeof(bool));
 
@@ -486,20 +486,24 @@ void DivPlatformK053260::renderSamples(int sysID) {
       actualLength=MIN((int)(getSampleMemCapacity()-memPos-1),length);
       if (actualLength>0) {
         sampleOffK053260[i]=memPos-1;
+        sampleMem.grow(memPos+actualLength+1);
+        unsigned char* mem=sampleMem.getData();
         for (int j=0; j<actualLength; j++) {
-          sampleMem[memPos++]=s->dataK[j];
+          mem[memPos++]=s->dataK[j];
         }
-        sampleMem[memPos++]=0; // Silence for avoid popping noise
+        mem[memPos++]=0; // Silence for avoid popping noise
       }
     } else {
       length=MIN(65535,s->getEndPosition(DIV_SAMPLE_DEPTH_8BIT));
       actualLength=MIN((int)(getSampleMemCapacity()-memPos-1),length);
       if (actualLength>0) {
         sampleOffK053260[i]=memPos-1;
+        sampleMem.grow(memPos+actualLength+1);
+        unsigned char* mem=sampleMem.getData();
         for (int j=0; j<actualLength; j++) {
-          sampleMem[memPos++]=s->data8[j];
+          mem[memPos++]=s->data8[j];
         }
-        sampleMem[memPos++]=0; // Silence for avoid popping noise
+        mem[memPos++]=0; // Silence for avoid popping noise
       }
     }
     if (actualLength<length) {
@@ -509,6 +513,17 @@ void DivPlatformK053260::renderSamples(int sysID) {
     sampleLoaded[i]=true;
   }
   sampleMemLen=memPos;
+  sampleMem.grow(memPos);
+  sampleMem.fit(memPos);
+}
+
+bool DivPlatformK053260::shareSamples(DivDispatch* from) {
+  DivPlatformK053260* other=(DivPlatformK053260*)from;
+  sampleMem.share(other->sampleMem);
+  sampleMemLen=other->sampleMemLen;
+  memcpy(sampleOffK053260,other->sampleOffK053260,256*sizeof(unsigned int));
+  memcpy(sampleLoaded,other->sampleLoaded,256*sizeof(bool));
+  return true;
 }
 
 int DivPlatformK053260::init(DivEngine* p, int channels, int sugRate, const DivConfig& flags) {
@@ -520,7 +535,7 @@ int DivPlatformK053260::init(DivEngine* p, int channels, int sugRate, const DivC
     isMuted[i]=false;
     oscBuf[i]=new DivDispatchOscBuffer;
   }
-  sampleMem=new unsigned char[getSampleMemCapacity()];
+  sampleMem.init(getSampleMemCapacity());
   sampleMemLen=0;
   setFlags(flags);
   reset();
@@ -529,7 +544,7 @@ int DivPlatformK053260::init(DivEngine* p, int channels, int sugRate, const DivC
 }
 
 void DivPlatformK053260::quit() {
-  delete[] sampleMem;
+  sampleMem.quit();
   for (int i=0; i<4; i++) {
     delete oscBuf[i];
   }
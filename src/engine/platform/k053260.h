@@ -21,6 +21,7 @@
 #define _K053260_H
 
 #include "../dispatch.h"
+#include "../sampleMem.h"
 #include <queue>
 #include "vgsound_emu/src/k053260/k053260.hpp"
 
@@ -49,7 +50,7 @@ class DivPlatformK053260: public DivDispatch, public k053260_intf {
   unsigned int sampleOffK053260[256];
   bool sampleLoaded[256];
 
-  unsigned char* sampleMem;
+  DivSampleMem sampleMem;
   size_t sampleMemLen;
   k053260_core k053260;
   unsigned char regPool[64];
@@ -85,6 +86,7 @@ class DivPlatformK053260: public DivDispatch, public k053260_intf {
     virtual size_t getSampleMemUsage(int index = 0) override;
     virtual bool isSampleLoaded(int index, int sample) override;
     virtual void renderSamples(int chipID) override;
+    virtual bool shareSamples(DivDispatch* from) override;
     virtual int init(DivEngine* parent, int channels, int sugRate, const DivConfig& flags) override;
     virtual void quit() override;
     DivPlatformK053260():
@@ -85,9 +85,9 @@ void DivPlatformMMC5::acquire(short** buf, size_t len) {
 
     if (++writeOscBuf>=32) {
       writeOscBuf=0;
-      oscBuf[0]->data[oscBuf[0]->needle++]=isMuted[0]?0:((mmc5->S3.output)<<11);
-      oscBuf[1]->data[oscBuf[1]->needle++]=isMuted[1]?0:((mmc5->S4.output)<<11);
-      oscBuf[2]->data[oscBuf[2]->needle++]=isMuted[2]?0:((mmc5->pcm.output)<<7);
+      oscBuf[0]->putSample(isMuted[0]?0:((mmc5->S3.output)<<11));
+      oscBuf[1]->putSample(isMuted[1]?0:((mmc5->S4.output)<<11));
+      oscBuf[2]->putSample(isMuted[2]?0:((mmc5->pcm.output)<<7));
     }
   }
 }
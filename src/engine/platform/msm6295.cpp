@@ -39,16 +39,16 @@ const char** DivPlatformMSM6295::getRegisterSheet() {
 }
 
 u8 DivPlatformMSM6295::read_byte(u32 address) {
-  if (adpcmMem==NULL || address>=getSampleMemCapacity(0)) {
+  if (address>=getSampleMemCapacity(0)) {
     return 0;
   }
   if (isBanked) {
     if (address<0x400) {
-      return adpcmMem[(bank[(address>>8)&0x3]<<16)|(address&0x3ff)];
+      return adpcmMem.read((bank[(address>>8)&0x3]<<16)|(address&0x3ff));
     }
-    return adpcmMem[(bank[(address>>16)&0x3]<<16)|(address&0xffff)];
+    return adpcmMem.read((bank[(address>>16)&0x3]<<16)|(address&0xffff));
   }
-  return adpcmMem[address&0x3ffff];
+  return adpcmMem.read(address&0x3ffff);
 }
 
 void DivPlatformMSM6295::acquire(short** buf, size_t len) {
@@ -95,7 +95,7 @@ void DivPlatformMSM6295::acquire(short** buf, size_t len) {
     if (++updateOsc>=22) {
       updateOsc=0;
       for (int i=0; i<4; i++) {
-        oscBuf[i]->data[oscBuf[i]->needle++]=msm.voice_out(i)<<5;
+        oscBuf[i]->putSample(msm.voice_out(i)<<5);
       }
     }
   }
@@ -353,7 +353,7 @@ void DivPlatformMSM6295::notifyInsDeletion(void* ins) {
 }
 
 const void* DivPlatformMSM6295::getSampleMem(int index) {
-  return index == 0 ? adpcmMem : NULL;
+  return index == 0 ? adpcmMem.getData() : NULL;
 }
 
 size_t DivPlatformMSM6295::getSampleMemCapacity(int index) {
@@ -373,7 +373,7 @@ bool DivPlatformMSM6295::isSampleLoaded(int index, int sample) {
 void DivPlatformMSM6295::renderSamples(int sysID) {
   unsigned int sampleOffVOX[256];
 
-  memset(adpcmMem,0,16777216);
+  adpcmMem.clear();
   memset(sampleOffVOX,0,256*sizeof(unsigned int));
   memset(sampleLoaded,0,256*sizeof(bool));
   for (int i=0; i<256; i++) {
@@ -408,11 +408,12 @@ void DivPlatformMSM6295::renderSamples(int sysID) {
         logW("out of ADPCM memory for sample %d!",i);
         break;
       }
+      adpcmMem.grow(memPos+paddedLen);
       if (memPos+paddedLen>=getSampleMemCapacity(0)) {
-        memcpy(adpcmMem+memPos,s->dataVOX,getSampleMemCapacity(0)-memPos);
+        memcpy(adpcmMem.getData()+memPos,s->dataVOX,getSampleMemCapacity(0)-memPos);
         logW("out of ADPCM memory for sample %d!",i);
       } else {
-        memcpy(adpcmMem+memPos,s->dataVOX,paddedLen);
+        memcpy(adpcmMem.getData()+memPos,s->dataVOX,paddedLen);
         sampleLoaded[i]=true;
       }
       sampleOffVOX[i]=memPos;
@@ -423,18 +424,21 @@ void DivPlatformMSM6295::renderSamples(int sysID) {
       phraseInd++;
     }
     adpcmMemLen=memPos+256;
+    adpcmMem.grow(adpcmMemLen);
+    adpcmMem.fit(adpcmMemLen);
+    unsigned char* mem=adpcmMem.getData();
 
     // phrase book
     for (int i=0; i<parent->song.sampleLen; i++) {
       int endPos=sampleOffVOX[i]+bankedPhrase[i].length;
       for (int b=0; b<4; b++) {
         unsigned int bankedAddr=((unsigned int)bankedPhrase[i].bank<<16)+(b<<8)+(bankedPhrase[i].phrase*8);
-        adpcmMem[bankedAddr]=b;
-        adpcmMem[bankedAddr+1]=(sampleOffVOX[i]>>8)&0xff;
-        adpcmMem[bankedAddr+2]=(sampleOffVOX[i])&0xff;
-        adpcmMem[bankedAddr+3]=b;
-        adpcmMem[bankedAddr+4]=(endPos>>8)&0xff;
-        adpcmMem[bankedAddr+5]=(endPos)&0xff;
+        mem[bankedAddr]=b;
+        mem[bankedAddr+1]=(sampleOffVOX[i]>>8)&0xff;
+        mem[bankedAddr+2]=(sampleOffVOX[i])&0xff;
+        mem[bankedAddr+3]=b;
+        mem[bankedAddr+4]=(endPos>>8)&0xff;
+        mem[bankedAddr+5]=(endPos)&0xff;
       }
     }
   } else {
@@ -452,32 +456,45 @@ void DivPlatformMSM6295::renderSamples(int sysID) {
         logW("out of ADPCM memory for sample %d!",i);
         break;
       }
+      adpcmMem.grow(memPos+paddedLen);
       if (memPos+paddedLen>=getSampleMemCapacity(0)) {
-        memcpy(adpcmMem+memPos,s->dataVOX,getSampleMemCapacity(0)-memPos);
+        memcpy(adpcmMem.getData()+memPos,s->dataVOX,getSampleMemCapacity(0)-memPos);
         logW("out of ADPCM memory for sample %d!",i);
       } else {
-        memcpy(adpcmMem+memPos,s->dataVOX,paddedLen);
+        memcpy(adpcmMem.getData()+memPos,s->dataVOX,paddedLen);
         sampleLoaded[i]=true;
       }
       sampleOffVOX[i]=memPos;
       memPos+=paddedLen;
     }
     adpcmMemLen=memPos+256;
+    adpcmMem.grow(adpcmMemLen);
+    adpcmMem.fit(adpcmMemLen);
+    unsigned char* mem=adpcmMem.getData();
 
     // phrase book
     for (int i=0; i<sampleCount; i++) {
       DivSample* s=parent->song.sample[i];
       int endPos=sampleOffVOX[i]+s->lengthVOX;
-      adpcmMem[i*8]=(sampleOffVOX[i]>>16)&0xff;
-      adpcmMem[1+i*8]=(sampleOffVOX[i]>>8)&0xff;
-      adpcmMem[2+i*8]=(sampleOffVOX[i])&0xff;
-      adpcmMem[3+i*8]=(endPos>>16)&0xff;
-      adpcmMem[4+i*8]=(endPos>>8)&0xff;
-      adpcmMem[5+i*8]=(endPos)&0xff;
+      mem[i*8]=(sampleOffVOX[i]>>16)&0xff;
+      mem[1+i*8]=(sampleOffVOX[i]>>8)&0xff;
+      mem[2+i*8]=(sampleOffVOX[i])&0xff;
+      mem[3+i*8]=(endPos>>16)&0xff;
+      mem[4+i*8]=(endPos>>8)&0xff;
+      mem[5+i*8]=(endPos)&0xff;
     }
   }
 }
 
+bool DivPlatformMSM6295::shareSamples(DivDispatch* from) {
+  DivPlatformMSM6295* other=(DivPlatformMSM6295*)from;
+  adpcmMem.share(other->adpcmMem);
+  adpcmMemLen=other->adpcmMemLen;
+  memcpy(bankedPhrase,other->bankedPhrase,sizeof(bankedPhrase));
+  memcpy(sampleLoaded,other->sampleLoaded,256*sizeof(bool));
+  return true;
+}
+
 void DivPlatformMSM6295::setFlags(const DivConfig& flags) {
   rateSelInit=flags.getBool("rateSel",false);
   isBanked=flags.getBool("isBanked",false);
@@ -545,7 +562,7 @@ void DivPlatformMSM6295::setFlags(const DivConfig& flags) {
 
 int DivPlatformMSM6295::init(DivEngine* p, int channels, int sugRate, const DivConfig& flags) {
   parent=p;
-  adpcmMem=new unsigned char[16777216];
+  adpcmMem.init(16777216);
   adpcmMemLen=0;
   dumpWrites=false;
   skipRegisterWrites=false;
@@ -563,7 +580,7 @@ void DivPlatformMSM6295::quit() {
   for (int i=0; i<4; i++) {
     delete oscBuf[i];
   }
-  delete[] adpcmMem;
+  adpcmMem.quit();
 }
 
 DivPlatformMSM6295::~DivPlatformMSM6295() {
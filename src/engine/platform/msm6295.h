@@ -22,6 +22,7 @@
 
 #include "../dispatch.h"
 #include "../../fixedQueue.h"
+#include "../sampleMem.h"
 #include "vgsound_emu/src/msm6295/msm6295.hpp"
 
 class DivPlatformMSM6295: public DivDispatch, public vgsound_emu_mem_intf {
@@ -50,7 +51,7 @@ class DivPlatformMSM6295: public DivDispatch, public vgsound_emu_mem_intf {
     FixedQueue<QueuedWrite,256> writes;
     msm6295_core msm;
 
-    unsigned char* adpcmMem;
+    DivSampleMem adpcmMem;
     size_t adpcmMemLen;
     bool sampleLoaded[256];
     unsigned char sampleBank;
@@ -100,6 +101,7 @@ class DivPlatformMSM6295: public DivDispatch, public vgsound_emu_mem_intf {
     virtual size_t getSampleMemUsage(int index) override;
     virtual bool isSampleLoaded(int index, int sample) override;
     virtual void renderSamples(int chipID) override;
+    virtual bool shareSamples(DivDispatch* from) override;
 
     virtual int init(DivEngine* parent, int channels, int sugRate, const DivConfig& flags) override;
     virtual void quit() override;
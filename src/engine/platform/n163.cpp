@@ -22,8 +22,8 @@
 #include "../../ta-log.h"
 #include <math.h>
 
-#define rWrite(a,v) if (!skipRegisterWrites) {writes.push(QueuedWrite(a,v)); if (dumpWrites) {addWrite(a,v);} }
-#define rWriteMask(a,v,m) if (!skipRegisterWrites) {writes.push(QueuedWrite(a,v,m)); if (dumpWrites) {addWrite(a,v);} }
+#define rWrite(a,v) if (!skipRegisterWrites) {writes.push(QueuedWrite(a,v)); wakeUp(); if (dumpWrites) {addWrite(a,v);} }
+#define rWriteMask(a,v,m) if (!skipRegisterWrites) {writes.push(QueuedWrite(a,v,m)); wakeUp(); if (dumpWrites) {addWrite(a,v);} }
 #define chWrite(c,a,v) \
   if (c<=chanMax) { \
     rWrite(0x78-(c<<3)+(a&7),v) \
@@ -108,16 +108,16 @@ const char** DivPlatformN163::getRegisterSheet() {
   return regCheatSheetN163;
 }
 
-void DivPlatformN163::acquire(short** buf, size_t len) {
+template<typename T> void DivPlatformN163::acquireInternal(T* out, size_t len) {
   for (size_t i=0; i<len; i++) {
     n163.tick();
-    int out=(n163.out()<<6)*2; // scale to 16 bit
-    if (out>32767) out=32767;
-    if (out<-32768) out=-32768;
-    buf[0][i]=out;
+    int sample=(n163.out()<<6)*2; // scale to 16 bit
+    if (sample>32767) sample=32767;
+    if (sample<-32768) sample=-32768;
+    out[0].put(i,sample);
 
-    if (n163.voice_cycle()==0x78) for (int i=0; i<8; i++) {
-      oscBuf[i]->data[oscBuf[i]->needle++]=n163.voice_out(i)<<7;
+    if (n163.voice_cycle()==0x78) for (int j=0; j<8; j++) {
+      oscBuf[j]->putSample(n163.voice_out(j)<<7);
     }
 
     // command queue
@@ -130,6 +130,15 @@ void DivPlatformN163::acquire(short** buf, size_t len) {
   }
 }
 
+void DivPlatformN163::acquire(short** buf, size_t len) {
+  DivSampleSink out(buf[0]);
+  acquireInternal(&out,len);
+}
+
+void DivPlatformN163::acquireSpans(DivSpanBuffer* out, size_t len) {
+  acquireInternal(out,len);
+}
+
 void DivPlatformN163::updateWave(int ch, int wave, int pos, int len) {
   len&=0xfc; // 4 nibble boundary
   if (wave<0) {
@@ -461,6 +470,14 @@ int DivPlatformN163::dispatch(DivCommand c) {
   return 1;
 }
 
+bool DivPlatformN163::getSpansSupported() {
+  return true;
+}
+
+bool DivPlatformN163::canSleep() {
+  return writes.empty();
+}
+
 void DivPlatformN163::muteChannel(int ch, bool mute) {
   isMuted[ch]=mute;
   chan[ch].volumeChanged=true;
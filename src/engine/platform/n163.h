@@ -67,11 +67,15 @@ class DivPlatformN163: public DivDispatch {
   unsigned char regPool[128];
   void updateWave(int ch, int wave, int pos, int len);
   void updateWaveCh(int ch);
+  template<typename T> void acquireInternal(T* out, size_t len);
   friend void putDispatchChip(void*,int);
   friend void putDispatchChan(void*,int,int);
 
   public:
     void acquire(short** buf, size_t len);
+    void acquireSpans(DivSpanBuffer* out, size_t len);
+    bool getSpansSupported();
+    bool canSleep();
     int dispatch(DivCommand c);
     void* getChanState(int chan);
     DivMacroInt* getChanMacroInt(int ch);
@@ -177,7 +177,7 @@ void DivPlatformNamcoWSG::acquire(short** buf, size_t len) {
     };
     namco->sound_stream_update(bufC,1);
     for (int i=0; i<chans; i++) {
-      oscBuf[i]->data[oscBuf[i]->needle++]=(namco->m_channel_list[i].last_out*chans)>>1;
+      oscBuf[i]->putSample((namco->m_channel_list[i].last_out*chans)>>1);
     }
   }
 }
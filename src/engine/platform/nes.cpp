@@ -100,7 +100,7 @@ void DivPlatformNES::doWrite(unsigned short addr, unsigned char data) {
     } \
   }
 
-void DivPlatformNES::acquire_puNES(short** buf, size_t len) {
+template<typename T> void DivPlatformNES::acquire_puNES(T* out, size_t len) {
   for (size_t i=0; i<len; i++) {
     doPCM;
   
@@ -112,14 +112,14 @@ void DivPlatformNES::acquire_puNES(short** buf, size_t len) {
     int sample=(pulse_output(nes)+tnd_output(nes))<<6;
     if (sample>32767) sample=32767;
     if (sample<-32768) sample=-32768;
-    buf[0][i]=sample;
+    out[0].put(i,sample);
     if (++writeOscBuf>=32) {
       writeOscBuf=0;
-      oscBuf[0]->data[oscBuf[0]->needle++]=isMuted[0]?0:(nes->S1.output<<11);
-      oscBuf[1]->data[oscBuf[1]->needle++]=isMuted[1]?0:(nes->S2.output<<11);
-      oscBuf[2]->data[oscBuf[2]->needle++]=isMuted[2]?0:(nes->TR.output<<11);
-      oscBuf[3]->data[oscBuf[3]->needle++]=isMuted[3]?0:(nes->NS.output<<11);
-      oscBuf[4]->data[oscBuf[4]->needle++]=isMuted[4]?0:(nes->DMC.output<<8);
+      oscBuf[0]->putSample(isMuted[0]?0:(nes->S1.output<<11));
+      oscBuf[1]->putSample(isMuted[1]?0:(nes->S2.output<<11));
+      oscBuf[2]->putSample(isMuted[2]?0:(nes->TR.output<<11));
+      oscBuf[3]->putSample(isMuted[3]?0:(nes->NS.output<<11));
+      oscBuf[4]->putSample(isMuted[4]?0:(nes->DMC.output<<8));
     }
   }
 }
@@ -142,11 +142,11 @@ void DivPlatformNES::acquire_NSFPlay(short** buf, size_t len) {
     buf[0][i]=sample;
     if (++writeOscBuf>=4) {
       writeOscBuf=0;
-      oscBuf[0]->data[oscBuf[0]->needle++]=nes1_NP->out[0]<<11;
-      oscBuf[1]->data[oscBuf[1]->needle++]=nes1_NP->out[1]<<11;
-      oscBuf[2]->data[oscBuf[2]->needle++]=nes2_NP->out[0]<<11;
-      oscBuf[3]->data[oscBuf[3]->needle++]=nes2_NP->out[1]<<11;
-      oscBuf[4]->data[oscBuf[4]->needle++]=nes2_NP->out[2]<<8;
+      oscBuf[0]->putSample(nes1_NP->out[0]<<11);
+      oscBuf[1]->putSample(nes1_NP->out[1]<<11);
+      oscBuf[2]->putSample(nes2_NP->out[0]<<11);
+      oscBuf[3]->putSample(nes2_NP->out[1]<<11);
+      oscBuf[4]->putSample(nes2_NP->out[2]<<8);
     }
   }
 }
@@ -155,10 +155,15 @@ void DivPlatformNES::acquire(short** buf, size_t len) {
   if (useNP) {
     acquire_NSFPlay(buf,len);
   } else {
-    acquire_puNES(buf,len);
+    DivSampleSink out(buf[0]);
+    acquire_puNES(&out,len);
   }
 }
 
+void DivPlatformNES::acquireSpans(DivSpanBuffer* out, size_t len) {
+  acquire_puNES(out,len);
+}
+
 static unsigned char noiseTable[253]={
   6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 5, 4,
   15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4,
@@ -762,6 +767,11 @@ void DivPlatformNES::reset() {
   dacAntiClick=0;
 }
 
+// NSFPlay runs at a fraction of the clock
+bool DivPlatformNES::getSpansSupported() {
+  return !useNP;
+}
+
 bool DivPlatformNES::keyOffAffectsArp(int ch) {
   return true;
 }
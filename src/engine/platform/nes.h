@@ -73,11 +73,13 @@ class DivPlatformNES: public DivDispatch {
 
   void doWrite(unsigned short addr, unsigned char data);
   unsigned char calcDPCMRate(int inRate);
-  void acquire_puNES(short** buf, size_t len);
+  template<typename T> void acquire_puNES(T* out, size_t len);
   void acquire_NSFPlay(short** buf, size_t len);
 
   public:
     void acquire(short** buf, size_t len);
+    void acquireSpans(DivSpanBuffer* out, size_t len);
+    bool getSpansSupported();
     int dispatch(DivCommand c);
     void* getChanState(int chan);
     DivMacroInt* getChanMacroInt(int ch);
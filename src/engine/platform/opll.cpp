@@ -24,7 +24,7 @@
 #include <math.h>
 
 #define rWrite(a,v) if (!skipRegisterWrites) {pendingWrites[a]=v;}
-#define immWrite(a,v) if (!skipRegisterWrites) {writes.push(QueuedWrite(a,v)); if (dumpWrites) {addWrite(a,v);} }
+#define immWrite(a,v) if (!skipRegisterWrites) {writes.push(QueuedWrite(a,v,writeStamp)); if (dumpWrites) {addWrite(a,v);} }
 
 #define CHIP_FREQBASE 1180068
 
@@ -43,13 +43,13 @@ const unsigned char visMapOPLL[9]={
 };
 
 void DivPlatformOPLL::acquire_nuked(short** buf, size_t len) {
-  thread_local int o[2];
-  thread_local int os;
+  int o[2];
+  int os;
 
   for (size_t h=0; h<len; h++) {
     os=0;
     for (int i=0; i<9; i++) {
-      if (!writes.empty() && --delay<0) {
+      if (!writes.empty() && TICK_AHEAD_READY(writes.front()) && --delay<0) {
         // 84 is safe value
         QueuedWrite& w=writes.front();
         if (w.addrOrVal) {
@@ -70,17 +70,17 @@ void DivPlatformOPLL::acquire_nuked(short** buf, size_t len) {
       unsigned char nextOut=cycleMapOPLL[fm.cycles];
       if ((nextOut>=6 && properDrums) || !isMuted[nextOut]) {
         os+=(o[0]+o[1]);
-        if (vrc7 || (fm.rm_enable&0x20)) oscBuf[nextOut]->data[oscBuf[nextOut]->needle++]=(o[0]+o[1])<<6;
+        if (vrc7 || (fm.rm_enable&0x20)) oscBuf[nextOut]->putSample((o[0]+o[1])<<6);
       } else {
-        if (vrc7 || (fm.rm_enable&0x20)) oscBuf[nextOut]->data[oscBuf[nextOut]->needle++]=0;
+        if (vrc7 || (fm.rm_enable&0x20)) oscBuf[nextOut]->putSample(0);
       }
     }
     if (!(vrc7 || (fm.rm_enable&0x20))) for (int i=0; i<9; i++) {
       unsigned char ch=visMapOPLL[i];
       if ((i>=6 && properDrums) || !isMuted[ch]) {
-        oscBuf[ch]->data[oscBuf[ch]->needle++]=(fm.output_ch[i])<<6;
+        oscBuf[ch]->putSample((fm.output_ch[i])<<6);
       } else {
-        oscBuf[ch]->data[oscBuf[ch]->needle++]=0;
+        oscBuf[ch]->putSample(0);
       }
     }
     os*=50;
@@ -1081,6 +1081,58 @@ float DivPlatformOPLL::getPostAmp() {
   return 1.5f;
 }
 
+bool DivPlatformOPLL::getTickAheadSupported() {
+  return true;
+}
+
+bool DivPlatformOPLL::getTickAheadQueueFull() {
+  return TICK_AHEAD_QUEUE_FULL(writes);
+}
+
+bool DivPlatformOPLL::getStateSupported() {
+  return true;
+}
+
+void* DivPlatformOPLL::getState() {
+  State* s=new State;
+  for (int i=0; i<11; i++) {
+    s->chan[i]=chan[i];
+  }
+  s->lastCustomMemory=lastCustomMemory;
+  s->drumState=drumState;
+  memcpy(s->drumVol,drumVol,5);
+  memcpy(s->drumActivated,drumActivated,5*sizeof(bool));
+  s->lastFreqSH=lastFreqSH;
+  s->lastFreqTT=lastFreqTT;
+  s->crapDrums=crapDrums;
+  s->properDrums=properDrums;
+  memcpy(s->oldWrites,oldWrites,256*sizeof(short));
+  memcpy(s->pendingWrites,pendingWrites,256*sizeof(short));
+  return s;
+}
+
+void DivPlatformOPLL::setState(void* state) {
+  State* s=(State*)state;
+  if (s==NULL) return;
+  for (int i=0; i<11; i++) {
+    chan[i]=s->chan[i];
+  }
+  lastCustomMemory=s->lastCustomMemory;
+  drumState=s->drumState;
+  memcpy(drumVol,s->drumVol,5);
+  memcpy(drumActivated,s->drumActivated,5*sizeof(bool));
+  lastFreqSH=s->lastFreqSH;
+  lastFreqTT=s->lastFreqTT;
+  crapDrums=s->crapDrums;
+  properDrums=s->properDrums;
+  memcpy(oldWrites,s->oldWrites,256*sizeof(short));
+  memcpy(pendingWrites,s->pendingWrites,256*sizeof(short));
+}
+
+void DivPlatformOPLL::freeState(void* state) {
+  delete (State*)state;
+}
+
 void DivPlatformOPLL::setFlags(const DivConfig& flags) {
   int clockSel=flags.getInt("clockSel",0);
   if (clockSel==3) {
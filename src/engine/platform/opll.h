@@ -50,8 +50,9 @@ class DivPlatformOPLL: public DivDispatch {
       unsigned short addr;
       unsigned char val;
       bool addrOrVal;
-      QueuedWrite(): addr(0), val(0), addrOrVal(false) {}
-      QueuedWrite(unsigned short a, unsigned char v): addr(a), val(v), addrOrVal(false) {}
+      unsigned int stamp;
+      QueuedWrite(): addr(0), val(0), addrOrVal(false), stamp(0) {}
+      QueuedWrite(unsigned short a, unsigned char v, unsigned int s): addr(a), val(v), addrOrVal(false), stamp(s) {}
     };
     FixedQueue<QueuedWrite,512> writes;
     opll_t fm;
@@ -78,6 +79,18 @@ class DivPlatformOPLL: public DivDispatch {
     short oldWrites[256];
     short pendingWrites[256];
 
+    struct State {
+      Channel chan[11];
+      int lastCustomMemory;
+      unsigned char drumState;
+      unsigned char drumVol[5];
+      bool drumActivated[5];
+      signed char lastFreqSH, lastFreqTT;
+      bool crapDrums, properDrums;
+      short oldWrites[256];
+      short pendingWrites[256];
+    };
+
     int octave(int freq);
     int toFreq(int freq);
     void commitState(int ch, DivInstrument* ins);
@@ -107,6 +120,12 @@ class DivPlatformOPLL: public DivDispatch {
     bool keyOffAffectsPorta(int ch);
     bool getLegacyAlwaysSetVolume();
     float getPostAmp();
+    bool getTickAheadSupported();
+    bool getTickAheadQueueFull();
+    bool getStateSupported();
+    void* getState();
+    void setState(void* state);
+    void freeState(void* state);
     void toggleRegisterDump(bool enable);
     void setVRC7(bool vrc);
     void setProperDrums(bool pd);
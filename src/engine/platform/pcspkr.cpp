@@ -69,7 +69,7 @@ void DivPlatformPCSpeaker::pcSpeakerThread() {
     }
     realQueueLock.unlock();
 #ifdef __linux__
-    static struct timespec ts, tSleep, rSleep;
+    struct timespec ts, tSleep, rSleep;
     if (clock_gettime(CLOCK_MONOTONIC,&ts)<0) {
       logW("could not get time!");
       tSleep.tv_sec=0;
@@ -90,7 +90,7 @@ void DivPlatformPCSpeaker::pcSpeakerThread() {
       switch (realOutMethod) {
 #ifdef HAVE_LINUX_INPUT
         case 0: { // evdev
-          static struct input_event ie;
+          struct input_event ie;
           ie.time.tv_sec=r.tv_sec;
           ie.time.tv_usec=r.tv_nsec/1000;
           ie.type=EV_SND;
@@ -207,10 +207,10 @@ void DivPlatformPCSpeaker::acquire_unfilt(short** buf, size_t len) {
       }
       out=(pos>(freq>>1) && !isMuted[0])?32767:0;
       buf[0][i]=out;
-      oscBuf->data[oscBuf->needle++]=out;
+      oscBuf->putSample(out);
     } else {
       buf[0][i]=0;
-      oscBuf->data[oscBuf->needle++]=0;
+      oscBuf->putSample(0);
     }
   }
 }
@@ -234,10 +234,10 @@ void DivPlatformPCSpeaker::acquire_cone(short** buf, size_t len) {
       if (out>1.0) out=1.0;
       if (out<-1.0) out=-1.0;
       buf[0][i]=out*32767;
-      oscBuf->data[oscBuf->needle++]=out*32767;
+      oscBuf->putSample(out*32767);
     } else {
       buf[0][i]=0;
-      oscBuf->data[oscBuf->needle++]=0;
+      oscBuf->putSample(0);
     }
   }
 }
@@ -261,10 +261,10 @@ void DivPlatformPCSpeaker::acquire_piezo(short** buf, size_t len) {
       if (out>1.0) out=1.0;
       if (out<-1.0) out=-1.0;
       buf[0][i]=out*32767;
-      oscBuf->data[oscBuf->needle++]=out*32767;
+      oscBuf->putSample(out*32767);
     } else {
       buf[0][i]=0;
-      oscBuf->data[oscBuf->needle++]=0;
+      oscBuf->putSample(0);
     }
   }
 }
@@ -312,9 +312,9 @@ void DivPlatformPCSpeaker::acquire_real(short** buf, size_t len) {
         }
       }
       out=(pos>(freq>>1) && !isMuted[0])?32767:0;
-      oscBuf->data[oscBuf->needle++]=out;
+      oscBuf->putSample(out);
     } else {
-      oscBuf->data[oscBuf->needle++]=0;
+      oscBuf->putSample(0);
     }
     buf[0][i]=0;
   }
@@ -71,7 +71,7 @@ void DivPlatformPET::acquire(short** buf, size_t len) {
         chan[0].cnt-=SAMP_DIVIDER;
       }
       buf[0][h]=chan[0].out;
-      oscBuf->data[oscBuf->needle++]=chan[0].out;
+      oscBuf->putSample(chan[0].out);
     }
     // emulate driver writes to PCR
     if (!hwSROutput) regPool[12]=chan[0].out?0xe0:0xc0;
@@ -79,7 +79,7 @@ void DivPlatformPET::acquire(short** buf, size_t len) {
     chan[0].out=0;
     for (size_t h=0; h<len; h++) {
       buf[0][h]=0;
-      oscBuf->data[oscBuf->needle++]=0;
+      oscBuf->putSample(0);
     }
   }
 }
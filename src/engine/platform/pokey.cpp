@@ -20,11 +20,14 @@
 #include "pokey.h"
 #include "../engine.h"
 #include "../../ta-log.h"
+#include <mutex>
 
 #define rWrite(a,v) if (!skipRegisterWrites) {writes.push(QueuedWrite(a,v)); if (dumpWrites) {addWrite(a,v);} }
 
 #define CHIP_DIVIDER 1
 
+static std::once_flag mzPokeyTablesOnce;
+
 const char* regCheatSheetPOKEY[]={
   "AUDF1", "0",
   "AUDC1", "1",
@@ -86,10 +89,10 @@ void DivPlatformPOKEY::acquireMZ(short* buf, size_t len) {
 
     if (++oscBufDelay>=14) {
       oscBufDelay=0;
-      oscBuf[0]->data[oscBuf[0]->needle++]=pokey.outvol_0<<10;
-      oscBuf[1]->data[oscBuf[1]->needle++]=pokey.outvol_1<<10;
-      oscBuf[2]->data[oscBuf[2]->needle++]=pokey.outvol_2<<10;
-      oscBuf[3]->data[oscBuf[3]->needle++]=pokey.outvol_3<<10;
+      oscBuf[0]->putSample(pokey.outvol_0<<10);
+      oscBuf[1]->putSample(pokey.outvol_1<<10);
+      oscBuf[2]->putSample(pokey.outvol_2<<10);
+      oscBuf[3]->putSample(pokey.outvol_3<<10);
     }
   }
 }
@@ -519,6 +522,7 @@ int DivPlatformPOKEY::init(DivEngine* p, int channels, int sugRate, const DivCon
   }
 
   if (!useAltASAP) {
+    std::call_once(mzPokeyTablesOnce,MZPOKEYSND_InitTables);
     MZPOKEYSND_Init(&pokey);
   }
 
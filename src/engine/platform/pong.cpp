@@ -33,10 +33,10 @@ void DivPlatformPong::acquire(short** buf, size_t len) {
       }
       out=(flip && !isMuted[0])?32767:0;
       buf[0][i]=out;
-      oscBuf->data[oscBuf->needle++]=out;
+      oscBuf->putSample(out);
     } else {
       buf[0][i]=0;
-      oscBuf->data[oscBuf->needle++]=0;
+      oscBuf->putSample(0);
       flip=false;
     }
   }
@@ -274,7 +274,7 @@ void DivPlatformQSound::acquire(short** buf, size_t len) {
       int data=chip.voice_output[i]<<1;
       if (data<-32768) data=-32768;
       if (data>32767) data=32767;
-      oscBuf[i]->data[oscBuf[i]->needle++]=data;
+      oscBuf[i]->putSample(data);
     }
   }
 }
@@ -713,7 +713,7 @@ int DivPlatformQSound::getRegisterPoolDepth() {
 }
 
 const void* DivPlatformQSound::getSampleMem(int index) {
-  return (index == 0 || index == 1) ? sampleMem : NULL;
+  return (index == 0 || index == 1) ? sampleMem.getData() : NULL;
 }
 
 size_t DivPlatformQSound::getSampleMemCapacity(int index) {
@@ -736,7 +736,7 @@ const char* DivPlatformQSound::getSampleMemName(int index) {
 }
 
 void DivPlatformQSound::renderSamples(int sysID) {
-  memset(sampleMem,0,getSampleMemCapacity());
+  sampleMem.clear();
   memset(sampleLoaded,0,256*sizeof(bool));
   memset(sampleLoadedBS,0,256*sizeof(bool));
 
@@ -759,14 +759,17 @@ void DivPlatformQSound::renderSamples(int sysID) {
       logW("out of QSound PCM memory for sample %d!",i);
       break;
     }
+    // samples are swizzled within their bank
+    sampleMem.grow(((memPos+length)|0xffff)+1);
+    unsigned char* mem=sampleMem.getData();
     if (memPos+length>=getSampleMemCapacity()) {
       for (unsigned int i=0; i<getSampleMemCapacity()-(memPos+length); i++) {
-        sampleMem[(memPos+i)^0x8000]=s->data8[i];
+        mem[(memPos+i)^0x8000]=s->data8[i];
       }
       logW("out of QSound PCM memory for sample %d!",i);
     } else {
       for (int i=0; i<length; i++) {
-        sampleMem[(memPos+i)^0x8000]=s->data8[i];
+        mem[(memPos+i)^0x8000]=s->data8[i];
       }
       sampleLoaded[i]=true;
     }
@@ -796,14 +799,16 @@ void DivPlatformQSound::renderSamples(int sysID) {
       logW("out of QSound ADPCM memory for sample %d!",i);
       break;
     }
+    sampleMem.grow(memPos+length);
+    unsigned char* mem=sampleMem.getData();
     if (memPos+length>=getSampleMemCapacity()) {
       for (unsigned int i=0; i<getSampleMemCapacity()-(memPos+length); i++) {
-        sampleMem[(memPos+i)]=s->dataQSoundA[i];
+        mem[(memPos+i)]=s->dataQSoundA[i];
       }
       logW("out of QSound ADPCM memory for sample %d!",i);
     } else {
       for (int i=0; i<length; i++) {
-        sampleMem[(memPos+i)]=s->dataQSoundA[i];
+        mem[(memPos+i)]=s->dataQSoundA[i];
       }
       sampleLoadedBS[i]=true;
     }
@@ -811,6 +816,28 @@ void DivPlatformQSound::renderSamples(int sysID) {
     memPos+=length+16;
   }
   sampleMemLenBS=memPos+256;
+
+  // VGM export writes whole banks
+  size_t used=((MAX(sampleMemLen,sampleMemLenBS))+0xffff)&(~0xffff);
+  sampleMem.grow(used);
+  sampleMem.fit(used);
+  chip.rom_data=sampleMem.getData();
+  chip.rom_len=sampleMem.getLen();
+}
+
+bool DivPlatformQSound::shareSamples(DivDispatch* from) {
+  DivPlatformQSound* other=(DivPlatformQSound*)from;
+  sampleMem.share(other->sampleMem);
+  sampleMemLen=other->sampleMemLen;
+  sampleMemLenBS=other->sampleMemLenBS;
+  sampleMemUsage=other->sampleMemUsage;
+  memcpy(offPCM,other->offPCM,256*sizeof(unsigned int));
+  memcpy(offBS,other->offBS,256*sizeof(unsigned int));
+  memcpy(sampleLoaded,other->sampleLoaded,256*sizeof(bool));
+  memcpy(sampleLoadedBS,other->sampleLoadedBS,256*sizeof(bool));
+  chip.rom_data=sampleMem.getData();
+  chip.rom_len=sampleMem.getLen();
+  return true;
 }
 
 int DivPlatformQSound::init(DivEngine* p, int channels, int sugRate, const DivConfig& flags) {
@@ -826,11 +853,12 @@ int DivPlatformQSound::init(DivEngine* p, int channels, int sugRate, const DivCo
 
   chipClock=60000000;
   rate = qsound_start(&chip, chipClock);
-  sampleMem=new unsigned char[getSampleMemCapacity()];
+  sampleMem.init(getSampleMemCapacity());
   sampleMemLen=0;
   sampleMemLenBS=0;
   sampleMemUsage=0;
-  chip.rom_data=sampleMem;
+  chip.rom_data=sampleMem.getData();
+  chip.rom_len=sampleMem.getLen();
   chip.rom_mask=0xffffff;
   reset();
 
@@ -841,7 +869,7 @@ int DivPlatformQSound::init(DivEngine* p, int channels, int sugRate, const DivCo
 }
 
 void DivPlatformQSound::quit() {
-  delete[] sampleMem;
+  sampleMem.quit();
   for (int i=0; i<19; i++) {
     delete oscBuf[i];
   }
@@ -21,6 +21,7 @@
 #define _QSOUND_H
 
 #include "../dispatch.h"
+#include "../sampleMem.h"
 #include "sound/qsound.h"
 
 class DivPlatformQSound: public DivDispatch {
@@ -46,7 +47,7 @@ class DivPlatformQSound: public DivDispatch {
   int echoDelay;
   int echoFeedback;
 
-  unsigned char* sampleMem;
+  DivSampleMem sampleMem;
   size_t sampleMemLen;
   size_t sampleMemLenBS;
   size_t sampleMemUsage;
@@ -90,6 +91,7 @@ class DivPlatformQSound: public DivDispatch {
     size_t getSampleMemUsage(int index = 0);
     bool isSampleLoaded(int index, int sample);
     void renderSamples(int chipID);
+    bool shareSamples(DivDispatch* from);
     int init(DivEngine* parent, int channels, int sugRate, const DivConfig& flags);
     void quit();
 };
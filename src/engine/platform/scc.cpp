@@ -23,7 +23,7 @@
 
 #define CHIP_DIVIDER 16
 
-#define rWrite(a,v) {if (!skipRegisterWrites) {scc->scc_w(true,a,v); regPool[a]=v; if (dumpWrites) addWrite(a,v); }}
+#define rWrite(a,v) {if (!skipRegisterWrites) {scc->scc_w(true,a,v); regPool[a]=v; wakeUp(); if (dumpWrites) addWrite(a,v); }}
 
 const char* regCheatSheetSCC[]={
   "Ch1_Wave", "00",
@@ -87,7 +87,7 @@ void DivPlatformSCC::acquire(short** buf, size_t len) {
     buf[0][h]=out;
 
     for (int i=0; i<5; i++) {
-      oscBuf[i]->data[oscBuf[i]->needle++]=scc->voice_out(i)<<7;
+      oscBuf[i]->putSample(scc->voice_out(i)<<7);
     }
   }
 }
@@ -337,6 +337,10 @@ int DivPlatformSCC::getOutputCount() {
   return 1;
 }
 
+bool DivPlatformSCC::canSleep() {
+  return true;
+}
+
 void DivPlatformSCC::notifyWaveChange(int wave) {
   for (int i=0; i<5; i++) {
     if (chan[i].wave==wave) {
@@ -27,7 +27,7 @@
 #define chWrite(c,a,v) rWrite(((c)<<3)+(a),v)
 
 void DivPlatformSegaPCM::acquire(short** buf, size_t len) {
-  thread_local int os[2];
+  int os[2];
 
   for (size_t h=0; h<len; h++) {
     while (!writes.empty()) {
@@ -49,7 +49,7 @@ void DivPlatformSegaPCM::acquire(short** buf, size_t len) {
     buf[1][h]=os[1];
 
     for (int i=0; i<16; i++) {
-      oscBuf[i]->data[oscBuf[i]->needle++]=(pcm.lastOut[i][0]+pcm.lastOut[i][1])>>1;
+      oscBuf[i]->putSample((pcm.lastOut[i][0]+pcm.lastOut[i][1])>>1);
     }
   }
 }
@@ -436,7 +436,7 @@ void DivPlatformSegaPCM::poke(std::vector<DivRegWrite>& wlist) {
 }
 
 const void* DivPlatformSegaPCM::getSampleMem(int index) {
-  return index == 0 ? sampleMem : NULL;
+  return index == 0 ? sampleMem.getData() : NULL;
 }
 
 size_t DivPlatformSegaPCM::getSampleMemCapacity(int index) {
@@ -482,7 +482,7 @@ void DivPlatformSegaPCM::reset() {
 void DivPlatformSegaPCM::renderSamples(int sysID) {
   size_t memPos=0;
 
-  memset(sampleMem,0,2097152);
+  sampleMem.clear();
   memset(sampleLoaded,0,256*sizeof(bool));
   memset(sampleOffSegaPCM,0,256*sizeof(unsigned int));
   memset(sampleEndSegaPCM,0,256);
@@ -501,11 +501,13 @@ void DivPlatformSegaPCM::renderSamples(int sysID) {
     sampleLoaded[i]=true;
     if (memPos>=2097152) break;
     sampleOffSegaPCM[i]=memPos;
+    sampleMem.grow(memPos+alignedSize);
+    unsigned char* mem=sampleMem.getData();
     for (unsigned int j=0; j<alignedSize; j++) {
       if (j>=sample->samples) {
-        sampleMem[memPos++]=0;
+        mem[memPos++]=0;
       } else {
-        sampleMem[memPos++]=((unsigned char)sample->data8[j]+0x80);
+        mem[memPos++]=((unsigned char)sample->data8[j]+0x80);
       }
       sampleEndSegaPCM[i]=((memPos+0xff)>>8)-1;
       if (memPos>=2097152) break;
@@ -514,6 +516,17 @@ void DivPlatformSegaPCM::renderSamples(int sysID) {
     if (memPos>=2097152) break;
   }
   sampleMemLen=memPos;
+  sampleMem.fit(memPos);
+}
+
+bool DivPlatformSegaPCM::shareSamples(DivDispatch* from) {
+  DivPlatformSegaPCM* other=(DivPlatformSegaPCM*)from;
+  sampleMem.share(other->sampleMem);
+  sampleMemLen=other->sampleMemLen;
+  memcpy(sampleOffSegaPCM,other->sampleOffSegaPCM,256*sizeof(unsigned int));
+  memcpy(sampleEndSegaPCM,other->sampleEndSegaPCM,256);
+  memcpy(sampleLoaded,other->sampleLoaded,256*sizeof(bool));
+  return true;
 }
 
 void DivPlatformSegaPCM::setFlags(const DivConfig& flags) {
@@ -539,10 +552,10 @@ int DivPlatformSegaPCM::init(DivEngine* p, int channels, int sugRate, const DivC
     isMuted[i]=false;
     oscBuf[i]=new DivDispatchOscBuffer;
   }
-  sampleMem=new unsigned char[2097152];
+  sampleMem.init(2097152);
   pcm.set_bank(segapcm_device::BANK_12M|segapcm_device::BANK_MASKF8);
   pcm.set_read([this](unsigned int addr) -> unsigned char {
-    return sampleMem[addr&0x1fffff];
+    return sampleMem.read(addr&0x1fffff);
   });
   setFlags(flags);
   reset();
@@ -554,7 +567,7 @@ void DivPlatformSegaPCM::quit() {
   for (int i=0; i<16; i++) {
     delete oscBuf[i];
   }
-  delete sampleMem;
+  sampleMem.quit();
 }
 
 DivPlatformSegaPCM::~DivPlatformSegaPCM() {
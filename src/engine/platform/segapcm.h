@@ -22,6 +22,7 @@
 
 #include "../dispatch.h"
 #include "../instrument.h"
+#include "../sampleMem.h"
 #include "sound/segapcm.h"
 #include "../../fixedQueue.h"
 
@@ -53,7 +54,7 @@ class DivPlatformSegaPCM: public DivDispatch {
     };
     Channel chan[16];
     DivDispatchOscBuffer* oscBuf[16];
-    unsigned char* sampleMem;
+    DivSampleMem sampleMem;
     size_t sampleMemLen;
     struct QueuedWrite {
       unsigned short addr;
@@ -101,6 +102,7 @@ class DivPlatformSegaPCM: public DivDispatch {
     void notifyInsChange(int ins);
     void notifyInsDeletion(void* ins);
     void renderSamples(int chipID);
+    bool shareSamples(DivDispatch* from);
     void setFlags(const DivConfig& flags);
     int getOutputCount();
     bool getLegacyAlwaysSetVolume();
@@ -22,7 +22,7 @@
 #include "../../ta-log.h"
 #include <math.h>
 
-#define rWrite(a,v) {if (!skipRegisterWrites) {writes.push(QueuedWrite(a,v)); if (dumpWrites) {addWrite(a,v);}}}
+#define rWrite(a,v) {if (!skipRegisterWrites) {writes.push(QueuedWrite(a,v,writeStamp)); if (dumpWrites) {addWrite(a,v);}}}
 
 const char* regCheatSheetSN[]={
   "DATA", "0",
@@ -43,6 +43,46 @@ float DivPlatformSMS::getPostAmp() {
   return 1.5f;
 }
 
+bool DivPlatformSMS::getTickAheadSupported() {
+  return true;
+}
+
+bool DivPlatformSMS::getTickAheadQueueFull() {
+  return TICK_AHEAD_QUEUE_FULL(writes);
+}
+
+bool DivPlatformSMS::getStateSupported() {
+  return true;
+}
+
+void* DivPlatformSMS::getState() {
+  State* s=new State;
+  for (int i=0; i<4; i++) {
+    s->chan[i]=chan[i];
+  }
+  s->lastPan=lastPan;
+  s->oldValue=oldValue;
+  s->snNoiseMode=snNoiseMode;
+  s->updateSNMode=updateSNMode;
+  return s;
+}
+
+void DivPlatformSMS::setState(void* state) {
+  State* s=(State*)state;
+  if (s==NULL) return;
+  for (int i=0; i<4; i++) {
+    chan[i]=s->chan[i];
+  }
+  lastPan=s->lastPan;
+  oldValue=s->oldValue;
+  snNoiseMode=s->snNoiseMode;
+  updateSNMode=s->updateSNMode;
+}
+
+void DivPlatformSMS::freeState(void* state) {
+  delete (State*)state;
+}
+
 void DivPlatformSMS::poolWrite(unsigned short a, unsigned char v) {
   if (a) {
     regPool[9]=v;
@@ -64,7 +104,7 @@ void DivPlatformSMS::acquire_nuked(short** buf, size_t len) {
   int oL=0;
   int oR=0;
   for (size_t h=0; h<len; h++) {
-    if (!writes.empty()) {
+    if (!writes.empty() && TICK_AHEAD_READY(writes.front())) {
       QueuedWrite w=writes.front();
       if (w.addr==0) {
         YMPSG_Write(&sn_nuked,w.val);
@@ -101,16 +141,16 @@ void DivPlatformSMS::acquire_nuked(short** buf, size_t len) {
     if (stereo) buf[1][h]=oR;
     for (int i=0; i<4; i++) {
       if (isMuted[i]) {
-        oscBuf[i]->data[oscBuf[i]->needle++]=0;
+        oscBuf[i]->putSample(0);
       } else {
-        oscBuf[i]->data[oscBuf[i]->needle++]=sn_nuked.vol_table[sn_nuked.volume_out[i]]*3;
+        oscBuf[i]->putSample(sn_nuked.vol_table[sn_nuked.volume_out[i]]*3);
       }
     }
   }
 }
 
 void DivPlatformSMS::acquire_mame(short** buf, size_t len) {
-  while (!writes.empty()) {
+  while (!writes.empty() && TICK_AHEAD_READY(writes.front())) {
     QueuedWrite w=writes.front();
     if (stereo && (w.addr==1))
       sn->stereo_w(w.val);
@@ -130,9 +170,9 @@ void DivPlatformSMS::acquire_mame(short** buf, size_t len) {
     sn->sound_stream_update(outs,1);
     for (int i=0; i<4; i++) {
       if (isMuted[i]) {
-        oscBuf[i]->data[oscBuf[i]->needle++]=0;
+        oscBuf[i]->putSample(0);
       } else {
-        oscBuf[i]->data[oscBuf[i]->needle++]=sn->get_channel_output(i)*3;
+        oscBuf[i]->putSample(sn->get_channel_output(i)*3);
       }
     }
   }
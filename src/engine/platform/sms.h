@@ -59,10 +59,16 @@ class DivPlatformSMS: public DivDispatch {
     unsigned short addr;
     unsigned char val;
     bool addrOrVal;
-    QueuedWrite(): addr(0), val(0), addrOrVal(false) {}
-    QueuedWrite(unsigned short a, unsigned char v): addr(a), val(v), addrOrVal(false) {}
+    unsigned int stamp;
+    QueuedWrite(): addr(0), val(0), addrOrVal(false), stamp(0) {}
+    QueuedWrite(unsigned short a, unsigned char v, unsigned int s): addr(a), val(v), addrOrVal(false), stamp(s) {}
   };
   FixedQueue<QueuedWrite,128> writes;
+  struct State {
+    Channel chan[4];
+    unsigned char lastPan, oldValue, snNoiseMode;
+    bool updateSNMode;
+  };
   friend void putDispatchChip(void*,int);
   friend void putDispatchChan(void*,int,int);
 
@@ -91,6 +97,12 @@ class DivPlatformSMS: public DivDispatch {
     bool keyOffAffectsPorta(int ch);
     bool getLegacyAlwaysSetVolume();
     float getPostAmp();
+    bool getTickAheadSupported();
+    bool getTickAheadQueueFull();
+    bool getStateSupported();
+    void* getState();
+    void setState(void* state);
+    void freeState(void* state);
     int getPortaFloor(int ch);
     void setFlags(const DivConfig& flags);
     void notifyInsDeletion(void* ins);
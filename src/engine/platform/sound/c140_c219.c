@@ -104,8 +104,10 @@ void c140_voice_tick(struct c140_t *c140, const unsigned char v, const int cycle
 		if (!voice->muted)
 		{
 			// fetch 12 bit sample
-			signed short s1 = c140->sample_mem[((unsigned int)(voice->bank) << 16) | (voice->addr & 0xffff)] & ~0xf;
-			signed short s2 = c140->sample_mem[((unsigned int)(voice->bank) << 16) | ((voice->addr + 1) & 0xffff)] & ~0xf;
+			const unsigned int a1 = ((unsigned int)(voice->bank) << 16) | (voice->addr & 0xffff);
+			const unsigned int a2 = ((unsigned int)(voice->bank) << 16) | ((voice->addr + 1) & 0xffff);
+			signed short s1 = ((a1 < c140->sample_mem_len) ? c140->sample_mem[a1] : 0) & ~0xf;
+			signed short s2 = ((a2 < c140->sample_mem_len) ? c140->sample_mem[a2] : 0) & ~0xf;
 			if (voice->compressed)
 			{
 				s1 = c140->mulaw[(s1 >> 8) & 0xff];
@@ -171,8 +173,10 @@ void c219_voice_tick(struct c219_t *c219, const unsigned char v, const int cycle
 			else
 			{
 				// fetch 8 bit sample
-				signed short s1 = c219->sample_mem[((unsigned int)(c219->bank[(v >> 2) & 3]) << 17) | ((voice->addr^1) & 0x1ffff)];
-				signed short s2 = c219->sample_mem[((unsigned int)(c219->bank[(v >> 2) & 3]) << 17) | (((voice->addr + 1) & 0x1ffff)^1)];
+				const unsigned int a1 = ((unsigned int)(c219->bank[(v >> 2) & 3]) << 17) | ((voice->addr^1) & 0x1ffff);
+				const unsigned int a2 = ((unsigned int)(c219->bank[(v >> 2) & 3]) << 17) | (((voice->addr + 1) & 0x1ffff)^1);
+				signed short s1 = (a1 < c219->sample_mem_len) ? c219->sample_mem[a1] : 0;
+				signed short s2 = (a2 < c219->sample_mem_len) ? c219->sample_mem[a2] : 0;
 				if (voice->compressed)
 				{
 					s1 = c219->mulaw[s1&0xff];
@@ -78,6 +78,7 @@ struct c140_t
    signed int lout, rout;
    signed short mulaw[256];
    signed short *sample_mem;
+   unsigned int sample_mem_len; // in samples. reads past this return 0
    unsigned char bank_type;
 };
 
@@ -89,6 +90,7 @@ struct c219_t
    unsigned short lfsr;
    unsigned char bank[4];
    signed char *sample_mem;
+   unsigned int sample_mem_len; // in samples. reads past this return 0
 };
 
 void c140_tick(struct c140_t *c140, const int cycle);
@@ -13,7 +13,8 @@
 */
 
 msm5232_device::msm5232_device(uint32_t clock)
-	: m_noise_cnt(0), m_noise_step(0), m_noise_rng(0), m_noise_clocks(0), m_UpdateStep(0), m_control1(0), m_control2(0), m_gate(0), m_chip_clock(0), m_rate(0), m_clock(clock)
+	: m_o2(0), m_o4(0), m_o8(0), m_o16(0), m_solo8(0), m_solo16(0)
+	, m_noise_cnt(0), m_noise_step(0), m_noise_rng(0), m_noise_clocks(0), m_UpdateStep(0), m_control1(0), m_control2(0), m_gate(0), m_chip_clock(0), m_rate(0), m_clock(clock)
 	, m_gate_handler_cb(NULL)
 {
 }
@@ -528,14 +529,12 @@ void msm5232_device::EG_voices_advance()
 
 }
 
-static int o2,o4,o8,o16,solo8,solo16;
-
 void msm5232_device::TG_group_advance(int groupidx)
 {
 	VOICE *voi = &m_voi[groupidx*4];
 	int i;
 
-	o2 = o4 = o8 = o16 = solo8 = solo16 = 0;
+	m_o2 = m_o4 = m_o8 = m_o16 = m_solo8 = m_solo16 = 0;
 
 	i=4;
 	do
@@ -596,15 +595,15 @@ void msm5232_device::TG_group_advance(int groupidx)
 
 		/* calculate signed output */
     if (!voi->mute) {
-      o16 += vo16[groupidx*4+(4-i)] = ( (out16-(1<<(STEP_SH-1))) * voi->egvol) >> STEP_SH;
-      o8  += vo8 [groupidx*4+(4-i)] = ( (out8 -(1<<(STEP_SH-1))) * voi->egvol) >> STEP_SH;
-      o4  += vo4 [groupidx*4+(4-i)] = ( (out4 -(1<<(STEP_SH-1))) * voi->egvol) >> STEP_SH;
-      o2  += vo2 [groupidx*4+(4-i)] = ( (out2 -(1<<(STEP_SH-1))) * voi->egvol) >> STEP_SH;
+      m_o16 += vo16[groupidx*4+(4-i)] = ( (out16-(1<<(STEP_SH-1))) * voi->egvol) >> STEP_SH;
+      m_o8  += vo8 [groupidx*4+(4-i)] = ( (out8 -(1<<(STEP_SH-1))) * voi->egvol) >> STEP_SH;
+      m_o4  += vo4 [groupidx*4+(4-i)] = ( (out4 -(1<<(STEP_SH-1))) * voi->egvol) >> STEP_SH;
+      m_o2  += vo2 [groupidx*4+(4-i)] = ( (out2 -(1<<(STEP_SH-1))) * voi->egvol) >> STEP_SH;
 
       if (i == 1 && groupidx == 1)
       {
-        solo16 += ( (out16-(1<<(STEP_SH-1))) << 11) >> STEP_SH;
-        solo8  += ( (out8 -(1<<(STEP_SH-1))) << 11) >> STEP_SH;
+        m_solo16 += ( (out16-(1<<(STEP_SH-1))) << 11) >> STEP_SH;
+        m_solo8  += ( (out8 -(1<<(STEP_SH-1))) << 11) >> STEP_SH;
       }
     }
 
@@ -613,10 +612,10 @@ void msm5232_device::TG_group_advance(int groupidx)
 	}while (i>0);
 
 	/* cut off disabled output lines */
-	o16 &= m_EN_out16[groupidx];
-	o8  &= m_EN_out8 [groupidx];
-	o4  &= m_EN_out4 [groupidx];
-	o2  &= m_EN_out2 [groupidx];
+	m_o16 &= m_EN_out16[groupidx];
+	m_o8  &= m_EN_out8 [groupidx];
+	m_o4  &= m_EN_out4 [groupidx];
+	m_o2  &= m_EN_out2 [groupidx];
 }
 
 
@@ -698,19 +697,19 @@ void msm5232_device::sound_stream_update(short* outputs)
   EG_voices_advance();
 
   TG_group_advance(0);   /* calculate tones group 1 */
-  buf1=o2;
-  buf2=o4;
-  buf3=o8;
-  buf4=o16;
+  buf1=m_o2;
+  buf2=m_o4;
+  buf3=m_o8;
+  buf4=m_o16;
 
   TG_group_advance(1);   /* calculate tones group 2 */
-  buf5=o2;
-  buf6=o4;
-  buf7=o8;
-  buf8=o16;
+  buf5=m_o2;
+  buf6=m_o4;
+  buf7=m_o8;
+  buf8=m_o16;
 
-  bufsolo1=solo8;
-  bufsolo2=solo16;
+  bufsolo1=m_solo8;
+  bufsolo2=m_solo16;
 
   /* update noise generator */
   {
@@ -76,6 +76,9 @@ private:
 	uint32_t m_EN_out4[2];  /* enable 4'  output masks */
 	uint32_t m_EN_out2[2];  /* enable 2'  output masks */
 
+	int m_o2, m_o4, m_o8, m_o16;  /* outputs of the last TG_group_advance() */
+	int m_solo8, m_solo16;
+
 	int m_noise_cnt;
 	int m_noise_step;
 	int m_noise_rng;
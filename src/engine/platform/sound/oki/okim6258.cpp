@@ -15,6 +15,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
+#include <mutex>
 
 #define COMMAND_STOP        (1 << 0)
 #define COMMAND_PLAY        (1 << 1)
@@ -31,8 +32,8 @@ static const int index_shift[8] = { -1, -1, -1, -1, 2, 4, 6, 8 };
 /* lookup table for the precomputed difference */
 static int diff_lookup[49*16];
 
-/* tables computed? */
-static int tables_computed = 0;
+/* tables computed? (shared by all instances, built once) */
+static std::once_flag tables_computed;
 
 
 
@@ -97,8 +98,6 @@ static void compute_tables()
 					stepval/8);
 		}
 	}
-
-	tables_computed = 1;
 }
 
 
@@ -108,7 +107,7 @@ static void compute_tables()
 
 void okim6258_device::device_start()
 {
-	compute_tables();
+	std::call_once(tables_computed, compute_tables);
 
 	m_divider = dividers[m_start_divider];
 
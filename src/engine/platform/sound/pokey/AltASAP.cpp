@@ -504,10 +504,10 @@ public:
 
         if ( oscb != nullptr )
         {
-          oscb[0]->data[oscb[0]->needle++]=ch0 * MAGICK_OSC_VOLUME_BOOSTER;
-          oscb[1]->data[oscb[1]->needle++]=ch1 * MAGICK_OSC_VOLUME_BOOSTER;
-          oscb[2]->data[oscb[2]->needle++]=ch2 * MAGICK_OSC_VOLUME_BOOSTER;
-          oscb[3]->data[oscb[3]->needle++]=ch3 * MAGICK_OSC_VOLUME_BOOSTER;
+          oscb[0]->putSample(ch0 * MAGICK_OSC_VOLUME_BOOSTER);
+          oscb[1]->putSample(ch1 * MAGICK_OSC_VOLUME_BOOSTER);
+          oscb[2]->putSample(ch2 * MAGICK_OSC_VOLUME_BOOSTER);
+          oscb[3]->putSample(ch3 * MAGICK_OSC_VOLUME_BOOSTER);
         }
 
         enqueueSampling();
@@ -767,12 +767,18 @@ double generate_sample(PokeyState* ps)
 /*                                                                           */
 /*****************************************************************************/
 
-int MZPOKEYSND_Init(PokeyState* ps)
+/* the polynomial tables are shared by every instance. call this once per */
+/* process (before the first MZPOKEYSND_Init) and never while rendering. */
+void MZPOKEYSND_InitTables(void)
 {
     build_poly4();
     build_poly5();
     build_poly9();
     build_poly17();
+}
+
+int MZPOKEYSND_Init(PokeyState* ps)
+{
     ResetPokeyState(ps);
   return 0; /* OK */
 }
@@ -154,6 +154,7 @@ void Update_pokey_sound_mz(PokeyState* ps, unsigned short addr, unsigned char va
 
 void ResetPokeyState(PokeyState* ps);
 
+void MZPOKEYSND_InitTables(void);
 int MZPOKEYSND_Init(PokeyState* ps);
 
 #endif /* MZPOKEYSND_H_ */
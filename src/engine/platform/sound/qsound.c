@@ -300,7 +300,9 @@ static inline int16_t get_sample(struct qsound_chip *chip, uint16_t bank,uint16_
 		return 0;	// ignore attempts to read from DSP program ROM
 
 	bank &= 0x7FFF;
-	rom_addr = (bank << 16) | (address << 0);
+	rom_addr = ((bank << 16) | (address << 0)) & chip->rom_mask;
+	if (rom_addr >= chip->rom_len)
+		return 0;	// not allocated
 
 	sample_data = chip->rom_data[rom_addr];
 
@@ -71,6 +71,7 @@ struct qsound_echo {
 struct qsound_chip {
 
 	unsigned long rom_mask;
+	unsigned long rom_len; // reads past this return 0
 	uint8_t *rom_data;
 
 	uint32_t mute_mask;
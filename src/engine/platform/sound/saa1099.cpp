@@ -229,9 +229,9 @@ void saa1099_device::sound_stream_update(short** outputs, int len, DivDispatchOs
 				int this_output_r = m_channels[ch].amplitude[RIGHT] * m_channels[ch].envelope[RIGHT] / 16;
         output_l+=this_output_l;
         output_r+=this_output_r;
-        oscBuf[ch]->data[oscBuf[ch]->needle++]=(this_output_l+this_output_r)<<1;
+        oscBuf[ch]->putSample((this_output_l+this_output_r)<<1);
 			} else if (oscBuf!=NULL) {
-        oscBuf[ch]->data[oscBuf[ch]->needle++]=0;
+        oscBuf[ch]->putSample(0);
       }
 		}
 
@@ -115,12 +115,14 @@ public:
 	//        bool EG_HAS_REVERB: True if the chip has a faux reverb envelope stage (OPQ/OPZ)
 	//           bool EG_HAS_SSG: True if the chip has SSG envelope support (OPN)
 	//      bool MODULATOR_DELAY: True if the modulator is delayed by 1 sample (OPL pre-OPL3)
+	//  bool CACHE_PM_PHASE_STEP: True if a PM phase step is costly enough to reuse while the LFO holds (OPM/OPN)
 	//
 	static constexpr bool DYNAMIC_OPS = false;
 	static constexpr bool EG_HAS_DEPRESS = false;
 	static constexpr bool EG_HAS_REVERB = false;
 	static constexpr bool EG_HAS_SSG = false;
 	static constexpr bool MODULATOR_DELAY = false;
+	static constexpr bool CACHE_PM_PHASE_STEP = false;
 
 	// system-wide register defaults
 	uint32_t status_mask() const                     { return 0; } // OPL only
@@ -167,6 +169,9 @@ class fm_operator
 	// "quiet" value, used to optimize when we can skip doing work
 	static constexpr uint32_t EG_QUIET = 0x380;
 
+	// LFO PM value that never occurs, used to mark the dynamic phase step stale
+	static constexpr int32_t DYNAMIC_PM_NONE = INT32_MIN;
+
 public:
 	// constructor
 	fm_operator(fm_engine_base<RegisterType> &owner, uint32_t opoffs);
@@ -237,6 +242,8 @@ private:
 	uint8_t m_key_state;                   // current key state: on or off (bit 0)
 	uint8_t m_keyon_live;                  // live key on state (bit 0 = direct, bit 1 = rhythm, bit 2 = CSM)
 	opdata_cache m_cache;                  // cached values for performance
+	int32_t m_dynamic_pm;                  // LFO PM value the dynamic phase step was computed for
+	uint32_t m_dynamic_step;               // last dynamic phase step
 	RegisterType &m_regs;                  // direct reference to registers
 	fm_engine_base<RegisterType> &m_owner; // reference to the owning engine
 };
@@ -380,6 +380,8 @@ fm_operator<RegisterType>::fm_operator(fm_engine_base<RegisterType> &owner, uint
 	m_ssg_inverted(false),
 	m_key_state(0),
 	m_keyon_live(0),
+	m_dynamic_pm(DYNAMIC_PM_NONE),
+	m_dynamic_step(0),
 	m_regs(owner.regs()),
 	m_owner(owner)
 {
@@ -400,6 +402,7 @@ void fm_operator<RegisterType>::reset()
 	m_ssg_inverted = 0;
 	m_key_state = 0;
 	m_keyon_live = 0;
+	m_dynamic_pm = DYNAMIC_PM_NONE;
 }
 
 
@@ -429,6 +432,9 @@ bool fm_operator<RegisterType>::prepare()
 	// cache the data
 	m_regs.cache_operator_data(m_choffs, m_opoffs, m_cache);
 
+	// registers may have changed, so the dynamic phase step is stale
+	m_dynamic_pm = DYNAMIC_PM_NONE;
+
 	// clock the key state
 	clock_keystate(uint32_t(m_keyon_live != 0));
         if (m_keyon_live & (1<<KEYON_CSM)) {
@@ -755,10 +761,19 @@ void fm_operator<RegisterType>::clock_envelope(uint32_t env_counter)
 template<class RegisterType>
 void fm_operator<RegisterType>::clock_phase(int32_t lfo_raw_pm)
 {
-	// read from the cache, or recalculate if PM active
+	// read from the cache, or recalculate if PM active; the LFO moves much
+	// more slowly than the sample rate, so where recalculating is costly only
+	// do so when its value changes
 	uint32_t phase_step = m_cache.phase_step;
 	if (phase_step == opdata_cache::PHASE_STEP_DYNAMIC)
-		phase_step = m_regs.compute_phase_step(m_choffs, m_opoffs, m_cache, lfo_raw_pm);
+	{
+		if (!RegisterType::CACHE_PM_PHASE_STEP || lfo_raw_pm != m_dynamic_pm)
+		{
+			m_dynamic_step = m_regs.compute_phase_step(m_choffs, m_opoffs, m_cache, lfo_raw_pm);
+			m_dynamic_pm = lfo_raw_pm;
+		}
+		phase_step = m_dynamic_step;
+	}
 
 	// finally apply the step to the current phase value
 	m_phase += phase_step;
@@ -116,6 +116,7 @@ public:
 	static constexpr uint32_t REGISTERS = 0x100;
 	static constexpr uint32_t DEFAULT_PRESCALE = 2;
 	static constexpr uint32_t EG_CLOCK_DIVIDER = 3;
+	static constexpr bool CACHE_PM_PHASE_STEP = true;
 	static constexpr uint32_t CSM_TRIGGER_MASK = ALL_CHANNELS;
 	static constexpr uint32_t REG_MODE = 0x14;
 	static constexpr uint8_t STATUS_TIMERA = 0x01;
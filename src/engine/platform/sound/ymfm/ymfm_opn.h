@@ -123,6 +123,7 @@ public:
 	static constexpr uint32_t EG_CLOCK_DIVIDER = 3;
 	static constexpr bool EG_HAS_SSG = true;
 	static constexpr bool MODULATOR_DELAY = false;
+	static constexpr bool CACHE_PM_PHASE_STEP = true;
 	static constexpr uint32_t CSM_TRIGGER_MASK = 1 << 2;
 	static constexpr uint8_t STATUS_TIMERA = 0x01;
 	static constexpr uint8_t STATUS_TIMERB = 0x02;
@@ -33,6 +33,7 @@
 #include <assert.h>
 #include <stdio.h>
 #include <string.h>
+#include <mutex>
 
 #define MAX_SAMPLE_CHUNK    10000
 
@@ -45,6 +46,9 @@ static constexpr int index_scale[8] = { 0x0e6, 0x0e6, 0x0e6, 0x0e6, 0x133, 0x199
 /* lookup table for the precomputed difference */
 static int diff_lookup[16];
 
+/* tables computed? (shared by all instances, built once) */
+static std::once_flag tables_computed;
+
 
 void ymz280b_device::update_step(struct YMZ280BVoice *voice)
 {
@@ -118,7 +122,7 @@ int ymz280b_device::generate_adpcm(struct YMZ280BVoice *voice, s16 *buffer, int
 		while (samples)
 		{
 			/* compute the new amplitude and update the current step */
-			val = m_ext_mem[position / 2] >> ((~position & 1) << 2);
+			val = read_ext_mem(position / 2) >> ((~position & 1) << 2);
 			signal += (step * diff_lookup[val & 15]) / 8;
 
 			/* clamp to the maximum */
@@ -155,7 +159,7 @@ int ymz280b_device::generate_adpcm(struct YMZ280BVoice *voice, s16 *buffer, int
 		while (samples)
 		{
 			/* compute the new amplitude and update the current step */
-			val = m_ext_mem[position / 2] >> ((~position & 1) << 2);
+			val = read_ext_mem(position / 2) >> ((~position & 1) << 2);
 			signal += (step * diff_lookup[val & 15]) / 8;
 
 			/* clamp to the maximum */
@@ -228,7 +232,7 @@ int ymz280b_device::generate_pcm8(struct YMZ280BVoice *voice, s16 *buffer, int s
 		while (samples)
 		{
 			/* fetch the current value */
-			val = m_ext_mem[position / 2];
+			val = read_ext_mem(position / 2);
 
 			/* output to the buffer, scaling by the volume */
 			*buffer++ = (s8)val * 256;
@@ -251,7 +255,7 @@ int ymz280b_device::generate_pcm8(struct YMZ280BVoice *voice, s16 *buffer, int s
 		while (samples)
 		{
 			/* fetch the current value */
-			val = m_ext_mem[position / 2];
+			val = read_ext_mem(position / 2);
 
 			/* output to the buffer, scaling by the volume */
 			*buffer++ = (s8)val * 256;
@@ -300,7 +304,7 @@ int ymz280b_device::generate_pcm16(struct YMZ280BVoice *voice, s16 *buffer, int
 		while (samples)
 		{
 			/* fetch the current value */
-			val = (s16)((m_ext_mem[position / 2 + 0] << 8) + m_ext_mem[position / 2 + 1]);
+			val = (s16)((read_ext_mem(position / 2 + 0) << 8) + read_ext_mem(position / 2 + 1));
 
 			/* output to the buffer, scaling by the volume */
 			*buffer++ = val;
@@ -323,7 +327,7 @@ int ymz280b_device::generate_pcm16(struct YMZ280BVoice *voice, s16 *buffer, int
 		while (samples)
 		{
 			/* fetch the current value */
-			val = (s16)((m_ext_mem[position / 2 + 0] << 8) + m_ext_mem[position / 2 + 1]);
+			val = (s16)((read_ext_mem(position / 2 + 0) << 8) + read_ext_mem(position / 2 + 1));
 
 			/* output to the buffer, scaling by the volume */
 			*buffer++ = val;
@@ -487,9 +491,10 @@ void ymz280b_device::sound_stream_update(s16 **outputs, int samples)
 void ymz280b_device::device_start(u8 *ext_mem)
 {
 	m_ext_mem = ext_mem;
+	m_ext_mem_len = 0x1000000;
 
 	/* compute ADPCM tables */
-	compute_tables();
+	std::call_once(tables_computed, compute_tables);
 
 	/* allocate memory */
 	assert(MAX_SAMPLE_CHUNK < 0x10000);
@@ -668,13 +673,14 @@ void ymz280b_device::write_to_register(int data)
 			case 0x86:      /* ROM readback / RAM write (low) -> update latch */
 				m_ext_mem_address = m_ext_mem_address_hi | m_ext_mem_address_mid | data;
 				if (m_ext_mem_enable)
-					m_ext_readlatch = m_ext_mem[m_ext_mem_address];
+					m_ext_readlatch = read_ext_mem(m_ext_mem_address);
 				break;
 
 			case 0x87:      /* RAM write */
 				if (m_ext_mem_enable)
 				{
-					m_ext_mem[m_ext_mem_address] = data;
+					if (m_ext_mem_address < m_ext_mem_len)
+						m_ext_mem[m_ext_mem_address] = data;
 					m_ext_mem_address = (m_ext_mem_address + 1) & 0xffffff;
 				}
 				break;
@@ -752,7 +758,7 @@ u8 ymz280b_device::read(offs_t offset)
 
 		/* read from external memory */
 		u8 ret = m_ext_readlatch;
-		m_ext_readlatch = m_ext_mem[m_ext_mem_address];
+		m_ext_readlatch = read_ext_mem(m_ext_mem_address);
 		m_ext_mem_address = (m_ext_mem_address + 1) & 0xffffff;
 		return ret;
 	}
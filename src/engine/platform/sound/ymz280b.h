@@ -37,6 +37,9 @@ public:
 	void device_start(u8 *ext_mem);
 	void device_reset();
 
+	// change the external memory. reads past len return 0
+	void set_ext_mem(u8 *ext_mem, u32 len) { m_ext_mem = ext_mem; m_ext_mem_len = len; }
+
 	void sound_stream_update(s16 **outputs, int samples);
 
 private:
@@ -97,6 +100,9 @@ private:
 	u32 m_ext_mem_address;            /* where the CPU can read the ROM */
 
 	u8 *m_ext_mem;
+	u32 m_ext_mem_len;
+
+	u8 read_ext_mem(u32 addr) const { return (addr < m_ext_mem_len) ? m_ext_mem[addr] : 0; }
 
 	std::unique_ptr<s16[]> m_scratch;
 };
@@ -49,7 +49,7 @@ void DivPlatformSoundUnit::acquire(short** buf, size_t len) {
     }
     su->NextSample(&buf[0][h],&buf[1][h]);
     for (int i=0; i<8; i++) {
-      oscBuf[i]->data[oscBuf[i]->needle++]=su->GetSample(i);
+      oscBuf[i]->putSample(su->GetSample(i));
     }
   }
 }
@@ -49,8 +49,8 @@ void DivPlatformTED::acquire(short** buf, size_t len) {
     }
 
     ted_sound_machine_calculate_samples(&ted,&buf[0][h],1,1);
-    oscBuf[0]->data[oscBuf[0]->needle++]=(ted.voice0_output_enabled && ted.voice0_sign)?(ted.volume<<1):0;
-    oscBuf[1]->data[oscBuf[1]->needle++]=(ted.voice1_output_enabled && ((ted.noise && (!(ted.noise_shift_register&1))) || (!ted.noise && ted.voice1_sign)))?(ted.volume<<1):0;
+    oscBuf[0]->putSample((ted.voice0_output_enabled && ted.voice0_sign)?(ted.volume<<1):0);
+    oscBuf[1]->putSample((ted.voice1_output_enabled && ((ted.noise && (!(ted.noise_shift_register&1))) || (!ted.noise && ted.voice1_sign)))?(ted.volume<<1):0);
   }
 }
 
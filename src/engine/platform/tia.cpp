@@ -38,25 +38,36 @@ const char** DivPlatformTIA::getRegisterSheet() {
   return regCheatSheetTIA;
 }
 
-void DivPlatformTIA::acquire(short** buf, size_t len) {
+template<typename T> void DivPlatformTIA::acquireInternal(T* out, size_t len) {
   for (size_t h=0; h<len; h++) {
     tia.tick();
     if (mixingType==2) {
-      buf[0][h]=tia.myCurrentSample[0];
-      buf[1][h]=tia.myCurrentSample[1];
+      out[0].put(h,tia.myCurrentSample[0]);
+      out[1].put(h,tia.myCurrentSample[1]);
     } else if (mixingType==1) {
-      buf[0][h]=(tia.myCurrentSample[0]+tia.myCurrentSample[1])>>1;
+      out[0].put(h,(tia.myCurrentSample[0]+tia.myCurrentSample[1])>>1);
     } else {
-      buf[0][h]=tia.myCurrentSample[0];
+      out[0].put(h,tia.myCurrentSample[0]);
     }
     if (++chanOscCounter>=114) {
       chanOscCounter=0;
-      oscBuf[0]->data[oscBuf[0]->needle++]=tia.myChannelOut[0];
-      oscBuf[1]->data[oscBuf[1]->needle++]=tia.myChannelOut[1];
+      oscBuf[0]->putSample(tia.myChannelOut[0]);
+      oscBuf[1]->putSample(tia.myChannelOut[1]);
     }
   }
 }
 
+void DivPlatformTIA::acquire(short** buf, size_t len) {
+  DivSampleSink out[2];
+  out[0].buf=buf[0];
+  if (mixingType==2) out[1].buf=buf[1];
+  acquireInternal(out,len);
+}
+
+void DivPlatformTIA::acquireSpans(DivSpanBuffer* out, size_t len) {
+  acquireInternal(out,len);
+}
+
 unsigned char DivPlatformTIA::dealWithFreq(unsigned char shape, int base, int pitch) {
   int bp=base+pitch;
   double mult=0.25*(parent->song.tuning*0.0625)*pow(2.0,double(768+bp)/(256.0*12.0));
@@ -336,6 +347,10 @@ int DivPlatformTIA::getOutputCount() {
   return (mixingType==2)?2:1;
 }
 
+bool DivPlatformTIA::getSpansSupported() {
+  return true;
+}
+
 bool DivPlatformTIA::keyOffAffectsArp(int ch) {
   return true;
 }
@@ -42,9 +42,11 @@ class DivPlatformTIA: public DivDispatch {
     friend void putDispatchChan(void*,int,int);
 
     unsigned char dealWithFreq(unsigned char shape, int base, int pitch);
+    template<typename T> void acquireInternal(T* out, size_t len);
   
   public:
     void acquire(short** buf, size_t len);
+    void acquireSpans(DivSpanBuffer* out, size_t len);
     int dispatch(DivCommand c);
     void* getChanState(int chan);
     DivMacroInt* getChanMacroInt(int ch);
@@ -58,6 +60,7 @@ class DivPlatformTIA: public DivDispatch {
     void setFlags(const DivConfig& flags);
     float getPostAmp();
     int getOutputCount();
+    bool getSpansSupported();
     bool keyOffAffectsArp(int ch);
     bool getLegacyAlwaysSetVolume();
     void notifyInsDeletion(void* ins);
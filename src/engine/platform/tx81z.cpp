@@ -58,7 +58,7 @@ const char** DivPlatformTX81Z::getRegisterSheet() {
 }
 
 void DivPlatformTX81Z::acquire(short** buf, size_t len) {
-  thread_local int os[2];
+  int os[2];
 
   ymfm::ym2414::fm_engine* fme=fm_ymfm->debug_engine();
 
@@ -78,7 +78,7 @@ void DivPlatformTX81Z::acquire(short** buf, size_t len) {
     fm_ymfm->generate(&out_ymfm);
 
     for (int i=0; i<8; i++) {
-      oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(fme->debug_channel(i)->debug_output(0)+fme->debug_channel(i)->debug_output(1),-32768,32767);
+      oscBuf[i]->putSample(CLAMP(fme->debug_channel(i)->debug_output(0)+fme->debug_channel(i)->debug_output(1),-32768,32767));
     }
 
     os[0]=out_ymfm.data[0];
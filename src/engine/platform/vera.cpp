@@ -118,12 +118,12 @@ void DivPlatformVERA::acquire(short** buf, size_t len) {
       pos++;
 
       for (int i=0; i<16; i++) {
-        oscBuf[i]->data[oscBuf[i]->needle++]=psg->channels[i].lastOut<<3;
+        oscBuf[i]->putSample(psg->channels[i].lastOut<<3);
       }
       int pcmOut=(whyCallItBuf[2][i]+whyCallItBuf[3][i])>>1;
       if (pcmOut<-32768) pcmOut=-32768;
       if (pcmOut>32767) pcmOut=32767;
-      oscBuf[16]->data[oscBuf[16]->needle++]=pcmOut;
+      oscBuf[16]->putSample(pcmOut);
     }
     len-=curLen;
   }
@@ -22,7 +22,7 @@
 #include <cstddef>
 #include <math.h>
 
-#define rWrite(a,v) if (!skipRegisterWrites) {writes.push(QueuedWrite(a,v)); if (dumpWrites) {addWrite(a,v);} }
+#define rWrite(a,v) if (!skipRegisterWrites) {writes.push(QueuedWrite(a,v)); wakeUp(); if (dumpWrites) {addWrite(a,v);} }
 #define chWrite(c,a,v) rWrite(0x9000+(c<<12)+(a&3),v)
 
 const char* regCheatSheetVRC6[]={
@@ -87,9 +87,9 @@ void DivPlatformVRC6::acquire(short** buf, size_t len) {
     if (++writeOscBuf>=32) {
       writeOscBuf=0;
       for (int i=0; i<2; i++) {
-        oscBuf[i]->data[oscBuf[i]->needle++]=vrc6.pulse_out(i)<<11;
+        oscBuf[i]->putSample(vrc6.pulse_out(i)<<11);
       }
-      oscBuf[2]->data[oscBuf[2]->needle++]=vrc6.sawtooth_out()<<10;
+      oscBuf[2]->putSample(vrc6.sawtooth_out()<<10);
     }
 
     // Command part
@@ -509,6 +509,15 @@ void DivPlatformVRC6::reset() {
   rWrite(0xf002,0);
 }
 
+// PCM is played in acquire()
+bool DivPlatformVRC6::canSleep() {
+  if (!writes.empty()) return false;
+  for (int i=0; i<2; i++) {
+    if (chan[i].pcm && chan[i].dacSample!=-1) return false;
+  }
+  return true;
+}
+
 bool DivPlatformVRC6::keyOffAffectsArp(int ch) {
   return true;
 }
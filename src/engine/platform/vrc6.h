@@ -75,6 +75,7 @@ class DivPlatformVRC6: public DivDispatch, public vrcvi_intf {
     void tick(bool sysTick=true);
     void muteChannel(int ch, bool mute);
     bool keyOffAffectsArp(int ch);
+    bool canSleep();
     void setFlags(const DivConfig& flags);
     void notifyInsDeletion(void* ins);
     void poke(unsigned int addr, unsigned short val);
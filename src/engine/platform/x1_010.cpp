@@ -223,19 +223,19 @@ void DivPlatformX1_010::acquire(short** buf, size_t len) {
 
     for (int i=0; i<16; i++) {
       int vo=(x1_010.voice_out(i,0)+x1_010.voice_out(i,1))<<2;
-      oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(vo,-32768,32767);
+      oscBuf[i]->putSample(CLAMP(vo,-32768,32767));
     }
   }
 }
 
 u8 DivPlatformX1_010::read_byte(u32 address) {
-  if ((sampleMem!=NULL) && (address<getSampleMemCapacity())) {
+  if (address<getSampleMemCapacity()) {
     if (isBanked) {
       address=((bankSlot[(address>>17)&7]<<17)|(address&0x1ffff))&0xffffff;
     } else {
       address&=0xfffff;
     }
-    return sampleMem[address];
+    return sampleMem.read(address);
   }
   return 0;
 }
@@ -978,7 +978,7 @@ void DivPlatformX1_010::poke(std::vector<DivRegWrite>& wlist) {
 }
 
 const void* DivPlatformX1_010::getSampleMem(int index) {
-  return index >= 0 ? sampleMem : 0;
+  return index >= 0 ? sampleMem.getData() : 0;
 }
 
 size_t DivPlatformX1_010::getSampleMemCapacity(int index) {
@@ -996,7 +996,7 @@ bool DivPlatformX1_010::isSampleLoaded(int index, int sample) {
 }
 
 void DivPlatformX1_010::renderSamples(int sysID) {
-  memset(sampleMem,0,16777216);
+  sampleMem.clear();
   memset(sampleOffX1,0,256*sizeof(unsigned int));
   memset(sampleLoaded,0,256*sizeof(bool));
 
@@ -1022,17 +1022,29 @@ void DivPlatformX1_010::renderSamples(int sysID) {
       logW("out of X1-010 memory for sample %d!",i);
       break;
     }
+    sampleMem.grow(memPos+paddedLen);
     if (memPos+paddedLen>=getSampleMemCapacity()) {
-      memcpy(sampleMem+memPos,s->data8,getSampleMemCapacity()-memPos);
+      memcpy(sampleMem.getData()+memPos,s->data8,getSampleMemCapacity()-memPos);
       logW("out of X1-010 memory for sample %d!",i);
     } else {
-      memcpy(sampleMem+memPos,s->data8,paddedLen);
+      memcpy(sampleMem.getData()+memPos,s->data8,paddedLen);
       sampleLoaded[i]=true;
     }
     sampleOffX1[i]=memPos;
     memPos+=paddedLen;
   }
   sampleMemLen=memPos+256;
+  sampleMem.grow(sampleMemLen);
+  sampleMem.fit(sampleMemLen);
+}
+
+bool DivPlatformX1_010::shareSamples(DivDispatch* from) {
+  DivPlatformX1_010* other=(DivPlatformX1_010*)from;
+  sampleMem.share(other->sampleMem);
+  sampleMemLen=other->sampleMemLen;
+  memcpy(sampleOffX1,other->sampleOffX1,256*sizeof(unsigned int));
+  memcpy(sampleLoaded,other->sampleLoaded,256*sizeof(bool));
+  return true;
 }
 
 int DivPlatformX1_010::init(DivEngine* p, int channels, int sugRate, const DivConfig& flags) {
@@ -1045,7 +1057,7 @@ int DivPlatformX1_010::init(DivEngine* p, int channels, int sugRate, const DivCo
     oscBuf[i]=new DivDispatchOscBuffer;
   }
   setFlags(flags);
-  sampleMem=new unsigned char[16777216];
+  sampleMem.init(16777216);
   sampleMemLen=0;
   x1_010.reset();
   reset();
@@ -1056,7 +1068,7 @@ void DivPlatformX1_010::quit() {
   for (int i=0; i<16; i++) {
     delete oscBuf[i];
   }
-  delete[] sampleMem;
+  sampleMem.quit();
 }
 
 DivPlatformX1_010::~DivPlatformX1_010() {
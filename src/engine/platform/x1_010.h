@@ -23,6 +23,7 @@
 #include "../dispatch.h"
 #include "../engine.h"
 #include "../waveSynth.h"
+#include "../sampleMem.h"
 #include "vgsound_emu/src/x1_010/x1_010.hpp"
 
 class DivPlatformX1_010: public DivDispatch, public vgsound_emu_mem_intf {
@@ -109,7 +110,7 @@ class DivPlatformX1_010: public DivDispatch, public vgsound_emu_mem_intf {
   DivDispatchOscBuffer* oscBuf[16];
   bool isMuted[16];
   bool stereo=false;
-  unsigned char* sampleMem;
+  DivSampleMem sampleMem;
   size_t sampleMemLen;
   unsigned char sampleBank;
   x1_010_core x1_010;
@@ -152,6 +153,7 @@ class DivPlatformX1_010: public DivDispatch, public vgsound_emu_mem_intf {
     size_t getSampleMemUsage(int index = 0);
     bool isSampleLoaded(int index, int sample);
     void renderSamples(int chipID);
+    bool shareSamples(DivDispatch* from);
     const char** getRegisterSheet();
     int init(DivEngine* parent, int channels, int sugRate, const DivConfig& flags);
     void quit();
@@ -165,8 +165,8 @@ void DivPlatformYM2203::acquire(short** buf, size_t len) {
 }
 
 void DivPlatformYM2203::acquire_combo(short** buf, size_t len) {
-  thread_local int os;
-  thread_local short ignored[2];
+  int os;
+  short ignored[2];
 
   for (size_t h=0; h<len; h++) {
     // AY -> OPN
@@ -231,17 +231,17 @@ void DivPlatformYM2203::acquire_combo(short** buf, size_t len) {
     buf[0][h]=os;
     
     for (int i=0; i<3; i++) {
-      oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(fm_nuked.ch_out[i]<<1,-32768,32767);
+      oscBuf[i]->putSample(CLAMP(fm_nuked.ch_out[i]<<1,-32768,32767));
     }
 
     for (int i=3; i<6; i++) {
-      oscBuf[i]->data[oscBuf[i]->needle++]=fmout.data[i-2]<<1;
+      oscBuf[i]->putSample(fmout.data[i-2]<<1);
     }
   }
 }
 
 void DivPlatformYM2203::acquire_ymfm(short** buf, size_t len) {
-  thread_local int os;
+  int os;
 
   ymfm::ym2203::fm_engine* fme=fm->debug_fm_engine();
 
@@ -283,11 +283,11 @@ void DivPlatformYM2203::acquire_ymfm(short** buf, size_t len) {
     
     for (int i=0; i<3; i++) {
       int out=(fmChan[i]->debug_output(0)+fmChan[i]->debug_output(1))<<1;
-      oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(out,-32768,32767);
+      oscBuf[i]->putSample(CLAMP(out,-32768,32767));
     }
 
     for (int i=3; i<6; i++) {
-      oscBuf[i]->data[oscBuf[i]->needle++]=fmout.data[i-2]<<1;
+      oscBuf[i]->putSample(fmout.data[i-2]<<1);
     }
   }
 }
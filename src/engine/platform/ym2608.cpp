@@ -306,8 +306,8 @@ void DivPlatformYM2608::acquire(short** buf, size_t len) {
 }
 
 void DivPlatformYM2608::acquire_combo(short** buf, size_t len) {
-  thread_local int os[2];
-  thread_local short ignored[2];
+  int os[2];
+  short ignored[2];
 
   ymfm::ssg_engine* ssge=fm->debug_ssg_engine();
   ymfm::adpcm_a_engine* aae=fm->debug_adpcm_a_engine();
@@ -402,24 +402,24 @@ void DivPlatformYM2608::acquire_combo(short** buf, size_t len) {
 
     
     for (int i=0; i<psgChanOffs; i++) {
-      oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(fm_nuked.ch_out[i]<<1,-32768,32767);
+      oscBuf[i]->putSample(CLAMP(fm_nuked.ch_out[i]<<1,-32768,32767));
     }
 
     ssge->get_last_out(ssgOut);
     for (int i=psgChanOffs; i<adpcmAChanOffs; i++) {
-      oscBuf[i]->data[oscBuf[i]->needle++]=ssgOut.data[i-psgChanOffs]<<1;
+      oscBuf[i]->putSample(ssgOut.data[i-psgChanOffs]<<1);
     }
 
     for (int i=adpcmAChanOffs; i<adpcmBChanOffs; i++) {
-      oscBuf[i]->data[oscBuf[i]->needle++]=(adpcmAChan[i-adpcmAChanOffs]->get_last_out(0)+adpcmAChan[i-adpcmAChanOffs]->get_last_out(1))>>1;
+      oscBuf[i]->putSample((adpcmAChan[i-adpcmAChanOffs]->get_last_out(0)+adpcmAChan[i-adpcmAChanOffs]->get_last_out(1))>>1);
     }
 
-    oscBuf[adpcmBChanOffs]->data[oscBuf[adpcmBChanOffs]->needle++]=(abe->get_last_out(0)+abe->get_last_out(1))>>1;
+    oscBuf[adpcmBChanOffs]->putSample((abe->get_last_out(0)+abe->get_last_out(1))>>1);
   }
 }
 
 void DivPlatformYM2608::acquire_ymfm(short** buf, size_t len) {
-  thread_local int os[2];
+  int os[2];
 
   ymfm::ym2608::fm_engine* fme=fm->debug_fm_engine();
   ymfm::ssg_engine* ssge=fm->debug_ssg_engine();
@@ -472,19 +472,19 @@ void DivPlatformYM2608::acquire_ymfm(short** buf, size_t len) {
 
     for (int i=0; i<6; i++) {
       int out=(fmChan[i]->debug_output(0)+fmChan[i]->debug_output(1))<<1;
-      oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(out,-32768,32767);
+      oscBuf[i]->putSample(CLAMP(out,-32768,32767));
     }
 
     ssge->get_last_out(ssgOut);
     for (int i=6; i<9; i++) {
-      oscBuf[i]->data[oscBuf[i]->needle++]=ssgOut.data[i-6]<<1;
+      oscBuf[i]->putSample(ssgOut.data[i-6]<<1);
     }
 
     for (int i=9; i<15; i++) {
-      oscBuf[i]->data[oscBuf[i]->needle++]=(adpcmAChan[i-9]->get_last_out(0)+adpcmAChan[i-9]->get_last_out(1))>>1;
+      oscBuf[i]->putSample((adpcmAChan[i-9]->get_last_out(0)+adpcmAChan[i-9]->get_last_out(1))>>1);
     }
 
-    oscBuf[15]->data[oscBuf[15]->needle++]=(abe->get_last_out(0)+abe->get_last_out(1))>>1;
+    oscBuf[15]->putSample((abe->get_last_out(0)+abe->get_last_out(1))>>1);
   }
 }
 
@@ -23,10 +23,10 @@ uint8_t DivYM2610Interface::ymfm_external_read(ymfm::access_class type, uint32_t
   switch (type) {
     case ymfm::ACCESS_ADPCM_A:
       if (adpcmAMem==NULL) return 0;
-      return adpcmAMem[address&0xffffff];
+      return adpcmAMem->read(address&0xffffff);
     case ymfm::ACCESS_ADPCM_B:
       if (adpcmBMem==NULL) return 0;
-      return adpcmBMem[address&0xffffff];
+      return adpcmBMem->read(address&0xffffff);
     default:
       return 0;
   }
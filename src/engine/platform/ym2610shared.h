@@ -22,6 +22,7 @@
 
 #include "fmshared_OPN.h"
 #include "../engine.h"
+#include "../sampleMem.h"
 #include "../../ta-log.h"
 #include "ay.h"
 #include "sound/ymfm/ymfm.h"
@@ -33,8 +34,8 @@
 
 class DivYM2610Interface: public ymfm::ymfm_interface {
   public:
-    unsigned char* adpcmAMem;
-    unsigned char* adpcmBMem;
+    DivSampleMem* adpcmAMem;
+    DivSampleMem* adpcmBMem;
     int sampleBank;
     uint8_t ymfm_external_read(ymfm::access_class type, uint32_t address);
     void ymfm_external_write(ymfm::access_class type, uint32_t address, uint8_t data);
@@ -55,9 +56,9 @@ class DivPlatformYM2610Base: public DivPlatformOPN {
     ymfm::ym2610b::output_data fmout;
     DivPlatformAY8910* ay;
   
-    unsigned char* adpcmAMem;
+    DivSampleMem adpcmAMem;
     size_t adpcmAMemLen;
-    unsigned char* adpcmBMem;
+    DivSampleMem adpcmBMem;
     size_t adpcmBMemLen;
     DivYM2610Interface iface;
 
@@ -124,7 +125,7 @@ class DivPlatformYM2610Base: public DivPlatformOPN {
     }
 
     const void* getSampleMem(int index) {
-      return index == 0 ? adpcmAMem : index == 1 ? adpcmBMem : NULL;
+      return index == 0 ? adpcmAMem.getData() : index == 1 ? adpcmBMem.getData() : NULL;
     }
 
     size_t getSampleMemCapacity(int index) {
@@ -146,7 +147,7 @@ class DivPlatformYM2610Base: public DivPlatformOPN {
     }
 
     void renderSamples(int sysID) {
-      memset(adpcmAMem,0,getSampleMemCapacity(0));
+      adpcmAMem.clear();
       memset(sampleOffA,0,256*sizeof(unsigned int));
       memset(sampleOffB,0,256*sizeof(unsigned int));
       memset(sampleLoaded,0,256*2*sizeof(bool));
@@ -167,19 +168,22 @@ class DivPlatformYM2610Base: public DivPlatformOPN {
           logW("out of ADPCM-A memory for sample %d!",i);
           break;
         }
+        adpcmAMem.grow(memPos+paddedLen);
         if (memPos+paddedLen>=getSampleMemCapacity(0)) {
-          memcpy(adpcmAMem+memPos,s->dataA,getSampleMemCapacity(0)-memPos);
+          memcpy(adpcmAMem.getData()+memPos,s->dataA,getSampleMemCapacity(0)-memPos);
           logW("out of ADPCM-A memory for sample %d!",i);
         } else {
-          memcpy(adpcmAMem+memPos,s->dataA,paddedLen);
+          memcpy(adpcmAMem.getData()+memPos,s->dataA,paddedLen);
           sampleLoaded[0][i]=true;
         }
         sampleOffA[i]=memPos;
         memPos+=paddedLen;
       }
       adpcmAMemLen=memPos+256;
+      adpcmAMem.grow(adpcmAMemLen);
+      adpcmAMem.fit(adpcmAMemLen);
 
-      memset(adpcmBMem,0,getSampleMemCapacity(1));
+      adpcmBMem.clear();
 
       memPos=0;
       for (int i=0; i<parent->song.sampleLen; i++) {
@@ -197,17 +201,32 @@ class DivPlatformYM2610Base: public DivPlatformOPN {
           logW("out of ADPCM-B memory for sample %d!",i);
           break;
         }
+        adpcmBMem.grow(memPos+paddedLen);
         if (memPos+paddedLen>=getSampleMemCapacity(1)) {
-          memcpy(adpcmBMem+memPos,s->dataB,getSampleMemCapacity(1)-memPos);
+          memcpy(adpcmBMem.getData()+memPos,s->dataB,getSampleMemCapacity(1)-memPos);
           logW("out of ADPCM-B memory for sample %d!",i);
         } else {
-          memcpy(adpcmBMem+memPos,s->dataB,paddedLen);
+          memcpy(adpcmBMem.getData()+memPos,s->dataB,paddedLen);
           sampleLoaded[1][i]=true;
         }
         sampleOffB[i]=memPos;
         memPos+=paddedLen;
       }
       adpcmBMemLen=memPos+256;
+      adpcmBMem.grow(adpcmBMemLen);
+      adpcmBMem.fit(adpcmBMemLen);
+    }
+
+    bool shareSamples(DivDispatch* from) {
+      DivPlatformYM2610Base* other=(DivPlatformYM2610Base*)from;
+      adpcmAMem.share(other->adpcmAMem);
+      adpcmAMemLen=other->adpcmAMemLen;
+      adpcmBMem.share(other->adpcmBMem);
+      adpcmBMemLen=other->adpcmBMemLen;
+      memcpy(sampleOffA,other->sampleOffA,256*sizeof(unsigned int));
+      memcpy(sampleOffB,other->sampleOffB,256*sizeof(unsigned int));
+      memcpy(sampleLoaded,other->sampleLoaded,256*2*sizeof(bool));
+      return true;
     }
 
     void setFlags(const DivConfig& flags) {
@@ -239,12 +258,12 @@ class DivPlatformYM2610Base: public DivPlatformOPN {
         isMuted[i]=false;
         oscBuf[i]=new DivDispatchOscBuffer;
       }
-      adpcmAMem=new unsigned char[getSampleMemCapacity(0)];
+      adpcmAMem.init(getSampleMemCapacity(0));
       adpcmAMemLen=0;
-      adpcmBMem=new unsigned char[getSampleMemCapacity(1)];
+      adpcmBMem.init(getSampleMemCapacity(1));
       adpcmBMemLen=0;
-      iface.adpcmAMem=adpcmAMem;
-      iface.adpcmBMem=adpcmBMem;
+      iface.adpcmAMem=&adpcmAMem;
+      iface.adpcmBMem=&adpcmBMem;
       iface.sampleBank=0;
       fm=new ymfm::ym2610b(iface);
       fm->set_fidelity(ymfm::OPN_FIDELITY_MED);
@@ -262,8 +281,8 @@ class DivPlatformYM2610Base: public DivPlatformOPN {
       }
       ay->quit();
       delete ay;
-      delete[] adpcmAMem;
-      delete[] adpcmBMem;
+      adpcmAMem.quit();
+      adpcmBMem.quit();
     }
 
     DivPlatformYM2610Base(int ext, int psg, int adpcmA, int adpcmB, int chanCount):
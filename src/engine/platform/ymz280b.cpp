@@ -75,7 +75,7 @@ void DivPlatformYMZ280B::acquire(short** buf, size_t len) {
       for (int j=0; j<8; j++) {
         dataL+=why[j*2][i];
         dataR+=why[j*2+1][i];
-        oscBuf[j]->data[oscBuf[j]->needle++]=(short)(((int)why[j*2][i]+why[j*2+1][i])/4);
+        oscBuf[j]->putSample((short)(((int)why[j*2][i]+why[j*2+1][i])/4));
       }
       buf[0][pos]=(short)(dataL/8);
       buf[1][pos]=(short)(dataR/8);
@@ -425,7 +425,7 @@ float DivPlatformYMZ280B::getPostAmp() {
 }
 
 const void* DivPlatformYMZ280B::getSampleMem(int index) {
-  return index == 0 ? sampleMem : NULL;
+  return index == 0 ? sampleMem.getData() : NULL;
 }
 
 size_t DivPlatformYMZ280B::getSampleMemCapacity(int index) {
@@ -443,7 +443,7 @@ bool DivPlatformYMZ280B::isSampleLoaded(int index, int sample) {
 }
 
 void DivPlatformYMZ280B::renderSamples(int sysID) {
-  memset(sampleMem,0,getSampleMemCapacity());
+  sampleMem.clear();
   memset(sampleOff,0,256*sizeof(unsigned int));
   memset(sampleLoaded,0,256*sizeof(bool));
 
@@ -459,15 +459,17 @@ void DivPlatformYMZ280B::renderSamples(int sysID) {
     unsigned char* src=(unsigned char*)s->getCurBuf();
     int actualLength=MIN((int)(getSampleMemCapacity()-memPos),length);
     if (actualLength>0) {
+      sampleMem.grow(memPos+actualLength);
+      unsigned char* mem=sampleMem.getData();
 #ifdef TA_BIG_ENDIAN
-      memcpy(&sampleMem[memPos],src,actualLength);
+      memcpy(&mem[memPos],src,actualLength);
 #else
       if (s->depth==DIV_SAMPLE_DEPTH_16BIT) {
         for (int i=0; i<actualLength; i++) {
-          sampleMem[memPos+i]=src[i^1];
+          mem[memPos+i]=src[i^1];
         }
       } else {
-        memcpy(&sampleMem[memPos],src,actualLength);
+        memcpy(&mem[memPos],src,actualLength);
       }
 #endif
       sampleOff[i]=memPos;
@@ -480,6 +482,9 @@ void DivPlatformYMZ280B::renderSamples(int sysID) {
     sampleLoaded[i]=true;
   }
   sampleMemLen=memPos;
+  sampleMem.grow(memPos);
+  sampleMem.fit(memPos);
+  ymz280b.set_ext_mem(sampleMem.getData(),sampleMem.getLen());
 }
 
 void DivPlatformYMZ280B::setChipModel(int type) {
@@ -532,9 +537,10 @@ int DivPlatformYMZ280B::init(DivEngine* p, int channels, int sugRate, const DivC
     isMuted[i]=false;
     oscBuf[i]=new DivDispatchOscBuffer;
   }
-  sampleMem=new unsigned char[getSampleMemCapacity()];
+  sampleMem.init(getSampleMemCapacity());
   sampleMemLen=0;
-  ymz280b.device_start(sampleMem);
+  ymz280b.device_start(NULL);
+  ymz280b.set_ext_mem(sampleMem.getData(),sampleMem.getLen());
   setFlags(flags);
   reset();
 
@@ -542,7 +548,7 @@ int DivPlatformYMZ280B::init(DivEngine* p, int channels, int sugRate, const DivC
 }
 
 void DivPlatformYMZ280B::quit() {
-  delete[] sampleMem;
+  sampleMem.quit();
   for (int i=0; i<8; i++) {
     delete oscBuf[i];
   }
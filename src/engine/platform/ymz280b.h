@@ -21,6 +21,7 @@
 #define _YMZ280B_H
 
 #include "../dispatch.h"
+#include "../sampleMem.h"
 #include "sound/ymz280b.h"
 
 class DivPlatformYMZ280B: public DivDispatch {
@@ -47,7 +48,7 @@ class DivPlatformYMZ280B: public DivDispatch {
   unsigned int sampleOff[256];
   bool sampleLoaded[256];
 
-  unsigned char* sampleMem;
+  DivSampleMem sampleMem;
   size_t sampleMemLen;
   ymz280b_device ymz280b;
   unsigned char regPool[256];
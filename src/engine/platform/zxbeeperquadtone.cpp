@@ -51,12 +51,12 @@ void DivPlatformZXBeeperQuadTone::acquire(short** buf, size_t len) {
     if (sampleActive) {
       buf[0][h]=chan[4].out?32767:0;
       if (outputClock==0) {
-        oscBuf[0]->data[oscBuf[0]->needle++]=0;
-        oscBuf[1]->data[oscBuf[1]->needle++]=0;
-        oscBuf[2]->data[oscBuf[2]->needle++]=0;
-        oscBuf[3]->data[oscBuf[3]->needle++]=0;
+        oscBuf[0]->putSample(0);
+        oscBuf[1]->putSample(0);
+        oscBuf[2]->putSample(0);
+        oscBuf[3]->putSample(0);
       }
-      oscBuf[4]->data[oscBuf[4]->needle++]=buf[0][h];
+      oscBuf[4]->putSample(buf[0][h]);
     } else {
       int ch=outputClock/2;
       int b=ch*4;
@@ -72,7 +72,7 @@ void DivPlatformZXBeeperQuadTone::acquire(short** buf, size_t len) {
         } else {
           oscOut=16383;
         }
-        oscBuf[ch]->data[oscBuf[ch]->needle++]=oscOut;
+        oscBuf[ch]->putSample(oscOut);
       }
       if (!isMuted[ch]) o=chan[ch].out&0x10;
       if (noHiss) {
@@ -85,7 +85,7 @@ void DivPlatformZXBeeperQuadTone::acquire(short** buf, size_t len) {
         buf[0][h]=o?32767:0;
       }
       chan[ch].out<<=1;
-      oscBuf[4]->data[oscBuf[4]->needle++]=0;
+      oscBuf[4]->putSample(0);
     }
     outputClock=(outputClock+1)&7;
   }
@@ -23,6 +23,8 @@
 #include "dispatch.h"
 #include "engine.h"
 #include "workPool.h"
+#include "renderAhead.h"
+#include "allocTrap.h"
 #include "../ta-log.h"
 #include <math.h>
 
@@ -262,7 +264,7 @@ const char* cmdName[]={
 static_assert((sizeof(cmdName)/sizeof(void*))==DIV_CMD_MAX,"update cmdName!");
 
 const char* formatNote(unsigned char note, unsigned char octave) {
-  static char ret[4];
+  thread_local char ret[4];
   if (note==100) {
     return "OFF";
   } else if (note==101) {
@@ -299,7 +301,7 @@ int DivEngine::dispatchCmd(DivCommand c) {
     }
   }
   totalCmds++;
-  if (cmdStreamEnabled && cmdStream.size()<2000) {
+  if (cmdStreamEnabled && cmdStream.size()<DIV_CMD_STREAM_MAX) {
     cmdStream.push_back(c);
   }
 
@@ -384,6 +386,18 @@ int DivEngine::dispatchCmd(DivCommand c) {
 
   c.chan=dispatchChanOfChan[c.dis];
 
+  // anything but a query wakes the chip up
+  if (c.cmd!=DIV_CMD_GET_VOLUME && c.cmd!=DIV_CMD_GET_VOLMAX) {
+    disCont[dispatchOfChan[c.dis]].dispatch->wakeUp();
+    for (DivExportStem* i: stems) {
+      if (i->sys==dispatchOfChan[c.dis]) i->cont.dispatch->wakeUp();
+    }
+  }
+
+  for (DivExportStem* i: stems) {
+    if (i->sys==dispatchOfChan[c.dis]) i->cont.dispatch->dispatch(c);
+  }
+
   return disCont[dispatchOfChan[c.dis]].dispatch->dispatch(c);
 }
 
@@ -1128,10 +1142,10 @@ void DivEngine::processRow(int i, bool afterDelay) {
 }
 
 void DivEngine::nextRow() {
-  static char pb[4096];
-  static char pb1[4096];
-  static char pb2[4096];
-  static char pb3[4096];
+  char pb[4096];
+  char pb1[4096];
+  char pb2[4096];
+  char pb3[4096];
   if (view==DIV_STATUS_PATTERN && !skipping) {
     strcpy(pb1,"");
     strcpy(pb3,"");
@@ -1620,17 +1634,14 @@ bool DivEngine::nextTick(bool noAccum, bool inhibitLowLat) {
     // reset all chan oscs
     for (int i=0; i<chans; i++) {
       DivDispatchOscBuffer* buf=disCont[dispatchOfChan[i]].dispatch->getOscBuffer(dispatchChanOfChan[i]);
-      if (buf!=NULL) {
-        memset(buf->data,0,65536*sizeof(short));
-        buf->needle=0;
-        buf->readNeedle=0;
-      }
+      if (buf!=NULL) buf->reset();
     }
     return ret;
   }
 
   // system tick
   for (int i=0; i<song.systemLen; i++) disCont[i].dispatch->tick(subticks==tickMult);
+  for (DivExportStem* i: stems) i->cont.dispatch->tick(subticks==tickMult);
 
   if (!freelance) {
     if (stepPlay!=1) {
@@ -1808,6 +1819,25 @@ void _runDispatch2(void* d) {
 
 }
 
+void DivEngine::renderTickAhead() {
+  for (int i=0; i<song.systemLen; i++) {
+    renderPool->push([](void* d) {
+      DivDispatchContainer* dc=(DivDispatchContainer*)d;
+      dc->acquireAhead();
+    },&disCont[i]);
+  }
+  renderPool->wait();
+}
+
+void DivEngine::processAudio(float** in, float** out, int inChans, int outChans, unsigned int size) {
+  DIV_ALLOC_TRAP_SCOPE(true);
+  if (renderAhead!=NULL) {
+    renderAhead->pull(out,outChans,size);
+    return;
+  }
+  nextBuf(in,out,inChans,outChans,size);
+}
+
 void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsigned int size) {
   lastNBIns=inChans;
   lastNBOuts=outChans;
@@ -1835,13 +1865,21 @@ void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsi
   }
   got.bufsize=size;
 
+  if (size>metroBufLen) {
+    // the buffer size went up. this is the only place where nextBuf() allocates.
+    logD("buffer size grew to %d. reserving buffers...",size);
+    reserveBuffers(size);
+  }
+
   std::chrono::steady_clock::time_point ts_processBegin=std::chrono::steady_clock::now();
+  uint64_t profStage[DIV_PROF_MAX];
+  memset(profStage,0,DIV_PROF_MAX*sizeof(uint64_t));
+  uint64_t profLast=divProfNow();
+  uint64_t profNow;
 
   if (renderPool==NULL) {
-    unsigned int howManyThreads=song.systemLen;
-    if (howManyThreads<2) howManyThreads=0;
-    if (howManyThreads>renderPoolThreads) howManyThreads=renderPoolThreads;
-    renderPool=new DivWorkPool(howManyThreads);
+    logD("render pool not ready! creating it in the audio thread.");
+    initRenderPool();
   }
 
   // process MIDI events (TODO: everything)
@@ -1904,6 +1942,10 @@ void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsi
     output->midiIn->queue.pop();
   }
   
+  profNow=divProfNow();
+  profStage[DIV_PROF_MIDI]=profNow-profLast;
+  profLast=profNow;
+
   // process sample/wave preview
   if ((sPreview.sample>=0 && sPreview.sample<(int)song.sample.size()) || (sPreview.wave>=0 && sPreview.wave<(int)song.wave.size())) {
     unsigned int samp_bbOff=0;
@@ -2051,9 +2093,20 @@ void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsi
     memset(samp_bbOut,0,size*sizeof(short));
   }
 
+  profNow=divProfNow();
+  profStage[DIV_PROF_PREVIEW]=profNow-profLast;
+
   // process audio
   bool mustPlay=playing && !halted;
   if (mustPlay) {
+    for (int i=0; i<song.systemLen; i++) {
+      disCont[i].profAcquire=0;
+      disCont[i].profFill=0;
+    }
+    for (DivExportStem* i: stems) {
+      i->cont.profAcquire=0;
+      i->cont.profFill=0;
+    }
     // logic starts here
     for (int i=0; i<song.systemLen; i++) {
       // TODO: we may have a problem here
@@ -2067,21 +2120,54 @@ void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsi
         disCont[i].runtotal=blip_clocks_needed(disCont[i].bb[0],size-disCont[i].lastAvail);
       }
       if (disCont[i].runtotal>disCont[i].bbInLen) {
+        // the chip rate went up since reserveBuffers()
         logD("growing dispatch %d bbIn to %d",i,disCont[i].runtotal+256);
         disCont[i].grow(disCont[i].runtotal+256);
       }
       disCont[i].runLeft=disCont[i].runtotal;
       disCont[i].runPos=0;
     }
-
-    if (metroTickLen<size) {
-      if (metroTick!=NULL) delete[] metroTick;
-      metroTick=new unsigned char[size];
-      metroTickLen=size;
+    for (DivExportStem* i: stems) {
+      DivDispatchContainer& dc=i->cont;
+      dc.lastAvail=blip_samples_avail(dc.bb[0]);
+      if (dc.lastAvail>0) {
+        dc.flush(dc.lastAvail);
+      }
+      if (size<dc.lastAvail) {
+        dc.runtotal=0;
+      } else {
+        dc.runtotal=blip_clocks_needed(dc.bb[0],size-dc.lastAvail);
+      }
+      if (dc.runtotal>dc.bbInLen) {
+        dc.grow(dc.runtotal+256);
+      }
+      dc.runLeft=dc.runtotal;
+      dc.runPos=0;
     }
 
     memset(metroTick,0,size);
 
+    // tick-ahead mode: run tick logic first, then render every chip up to
+    // DIV_MAX_TICK_AHEAD segments at once.
+    // writes are stamped with the tick they belong to, so that each chip
+    // applies them at the right position.
+    bool useTickAhead=tickAhead && stems.empty();
+    if (useTickAhead) {
+      for (int i=0; i<song.systemLen; i++) {
+        if (!disCont[i].dispatch->getTickAheadSupported()) {
+          useTickAhead=false;
+          break;
+        }
+      }
+    }
+
+    // a sleeping chip's oscillators stop, and when it falls asleep depends
+    // on the buffer size. for playback only
+    bool mayChipSleep=chipSleep && !exporting;
+    for (int i=0; i<song.systemLen; i++) {
+      disCont[i].sleepEnabled=mayChipSleep;
+    }
+
     int attempts=0;
     int runLeftG=size<<MASTER_CLOCK_PREC;
     while (++attempts<(int)size) {
@@ -2096,7 +2182,23 @@ void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsi
       // 2. check whether we gonna tick
       if (cycles<=0) {
         // we have to tick
-        if (nextTick()) {
+        if (useTickAhead) {
+          // render what is pending if a chip may not fit another tick's writes
+          for (int i=0; i<song.systemLen; i++) {
+            if (disCont[i].dispatch->getTickAheadQueueFull()) {
+              renderTickAhead();
+              break;
+            }
+          }
+          tickAheadStamp++;
+          for (int i=0; i<song.systemLen; i++) {
+            disCont[i].dispatch->setWriteStamp(tickAheadStamp);
+          }
+        }
+        profLast=divProfNow();
+        bool looped=nextTick();
+        profStage[DIV_PROF_TICK]+=divProfNow()-profLast;
+        if (looped) {
           /*totalTicks=0;
           totalSeconds=0;*/
           lastLoopPos=size-(runLeftG>>MASTER_CLOCK_PREC);
@@ -2129,7 +2231,25 @@ void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsi
         runMidiTime(midiTotal);
 
         // 5. tick the clock and fill buffers as needed
-        if (cycles<runLeftG) {
+        if (useTickAhead) {
+          if (cycles<runLeftG) {
+            for (int i=0; i<song.systemLen; i++) {
+              int total=(cycles*disCont[i].runtotal)/(size<<MASTER_CLOCK_PREC);
+              disCont[i].pushAhead(total,tickAheadStamp);
+            }
+            runLeftG-=cycles;
+            cycles=0;
+          } else {
+            cycles-=runLeftG;
+            runLeftG=0;
+            for (int i=0; i<song.systemLen; i++) {
+              disCont[i].pushAhead(disCont[i].runLeft,tickAheadStamp);
+            }
+          }
+          if (song.systemLen>0 && disCont[0].aheadCount>=DIV_MAX_TICK_AHEAD) {
+            renderTickAhead();
+          }
+        } else if (cycles<runLeftG) {
           for (int i=0; i<song.systemLen; i++) {
             disCont[i].cycles=cycles;
             disCont[i].size=size;
@@ -2141,6 +2261,17 @@ void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsi
               dc->runPos+=total;
             },&disCont[i]);
           }
+          for (DivExportStem* i: stems) {
+            i->cont.cycles=cycles;
+            i->cont.size=size;
+            renderPool->push([](void* d) {
+              DivDispatchContainer* dc=(DivDispatchContainer*)d;
+              int total=(dc->cycles*dc->runtotal)/(dc->size<<MASTER_CLOCK_PREC);
+              dc->acquire(dc->runPos,total);
+              dc->runLeft-=total;
+              dc->runPos+=total;
+            },&i->cont);
+          }
           renderPool->wait();
           runLeftG-=cycles;
           cycles=0;
@@ -2154,11 +2285,26 @@ void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsi
               dc->runLeft=0;
             },&disCont[i]);
           }
+          for (DivExportStem* i: stems) {
+            renderPool->push([](void* d) {
+              DivDispatchContainer* dc=(DivDispatchContainer*)d;
+              dc->acquire(dc->runPos,dc->runLeft);
+              dc->runLeft=0;
+            },&i->cont);
+          }
           renderPool->wait();
         }
       }
     }
 
+    if (useTickAhead) {
+      renderTickAhead();
+      // any write left over is due now
+      for (int i=0; i<song.systemLen; i++) {
+        disCont[i].dispatch->setAcquireStamp(tickAheadStamp);
+      }
+    }
+
     //logD("attempts: %d",attempts);
     if (attempts>=(int)(size+10)) {
       logE("hang detected! stopping! at %d seconds %d micro (%d>=%d)",totalSeconds,totalTicks,attempts,(int)size);
@@ -2179,17 +2325,25 @@ void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsi
         dc->fillBuf(dc->runtotal,dc->lastAvail,dc->size-dc->lastAvail);
       },&disCont[i]);
     }
+    for (DivExportStem* i: stems) {
+      if (size<i->cont.lastAvail) continue;
+      i->cont.size=size;
+      renderPool->push([](void* d) {
+        DivDispatchContainer* dc=(DivDispatchContainer*)d;
+        dc->fillBuf(dc->runtotal,dc->lastAvail,dc->size-dc->lastAvail);
+      },&i->cont);
+    }
     renderPool->wait();
   }
 
-  // process metronome
-  if (metroBufLen<size || metroBuf==NULL) {
-    if (metroBuf!=NULL) delete[] metroBuf;
-    metroBuf=new float[size];
-    metroBufLen=size;
+  profLast=divProfNow();
+
+  if (!stems.empty()) {
+    mixStems(size);
   }
 
-  memset(metroBuf,0,metroBufLen*sizeof(float));
+  // process metronome
+  memset(metroBuf,0,size*sizeof(float));
 
   if (mustPlay && metronome) {
     for (size_t i=0; i<size; i++) {
@@ -2214,101 +2368,38 @@ void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsi
     }
   }
 
-  // resolve patchbay
-  for (unsigned int i: song.patchbay) {
-    const unsigned short srcPort=i>>16;
-    const unsigned short destPort=i&0xffff;
-
-    const unsigned short srcPortSet=srcPort>>4;
-    const unsigned short destPortSet=destPort>>4;
-    const unsigned char srcSubPort=srcPort&15;
-    const unsigned char destSubPort=destPort&15;
-
-    // null portset
-    if (destPortSet==0xfff) continue;
-
-    // system outputs
-    if (destPortSet==0x000) {
-      if (destSubPort>=outChans) continue;
-
-      // chip outputs
-      if (srcPortSet<song.systemLen && playing && !halted) {
-        if (srcSubPort<disCont[srcPortSet].dispatch->getOutputCount()) {
-          float vol=song.systemVol[srcPortSet]*disCont[srcPortSet].dispatch->getPostAmp()*song.masterVol;
-
-          switch (destSubPort&3) {
-            case 0:
-              vol*=MIN(1.0f,1.0f-song.systemPan[srcPortSet])*MIN(1.0f,1.0f+song.systemPanFR[srcPortSet]);
-              break;
-            case 1:
-              vol*=MIN(1.0f,1.0f+song.systemPan[srcPortSet])*MIN(1.0f,1.0f+song.systemPanFR[srcPortSet]);
-              break;
-            case 2:
-              vol*=MIN(1.0f,1.0f-song.systemPan[srcPortSet])*MIN(1.0f,1.0f-song.systemPanFR[srcPortSet]);
-              break;
-            case 3:
-              vol*=MIN(1.0f,1.0f+song.systemPan[srcPortSet])*MIN(1.0f,1.0f-song.systemPanFR[srcPortSet]);
-              break;
-          }
-
-          for (size_t j=0; j<size; j++) {
-            out[destSubPort][j]+=((float)disCont[srcPortSet].bbOut[srcSubPort][j]/32768.0)*vol;
-          }
-        }
-      } else if (srcPortSet==0xffd) {
-        // sample preview
-        for (size_t j=0; j<size; j++) {
-          out[destSubPort][j]+=previewVol*(samp_bbOut[j]/32768.0);
-        }
-      } else if (srcPortSet==0xffe && playing && !halted) {
-        // metronome
-        for (size_t j=0; j<size; j++) {
-          out[destSubPort][j]+=metroBuf[j];
-        }
-      }
-
-      // nothing/invalid
-    }
-
-    // nothing/invalid
-  }
+  // resolve patchbay, feed the oscilloscope and apply force mono/clamping
+  mixOutputs(out,outChans,size,playing && !halted);
 
-  // dump to oscillator buffer
-  for (unsigned int i=0; i<size; i++) {
-    for (int j=0; j<outChans; j++) {
-      if (oscBuf[j]==NULL) continue;
-      oscBuf[j][oscWritePos]=out[j][i];
-    }
-    if (++oscWritePos>=32768) oscWritePos=0;
-  }
-  oscSize=size;
+  profStage[DIV_PROF_MIX]=divProfNow()-profLast;
 
-  // force mono audio (if enabled)
-  if (forceMono && outChans>1) {
-    for (size_t i=0; i<size; i++) {
-      float chanSum=out[0][i];
-      for (int j=1; j<outChans; j++) {
-        chanSum+=out[j][i];
-      }
-      out[0][i]=chanSum/outChans;
-      for (int j=1; j<outChans; j++) {
-        out[j][i]=out[0][i];
+  // update the profiler
+  if (mustPlay) {
+    for (int i=0; i<song.systemLen; i++) {
+      uint64_t acquireTime=disCont[i].profAcquire;
+      uint64_t fillTime=disCont[i].profFill;
+      for (DivExportStem* j: stems) {
+        if (j->sys!=i) continue;
+        acquireTime+=j->cont.profAcquire;
+        fillTime+=j->cont.profFill;
       }
+      profiler.chipAcquire[i].add(acquireTime);
+      profiler.chipFill[i].add(fillTime);
+      profStage[DIV_PROF_ACQUIRE]+=acquireTime;
+      profStage[DIV_PROF_FILL]+=fillTime;
     }
+    profiler.stage[DIV_PROF_TICK].add(profStage[DIV_PROF_TICK]);
+    profiler.stage[DIV_PROF_ACQUIRE].add(profStage[DIV_PROF_ACQUIRE]);
+    profiler.stage[DIV_PROF_FILL].add(profStage[DIV_PROF_FILL]);
   }
+  profiler.stage[DIV_PROF_MIDI].add(profStage[DIV_PROF_MIDI]);
+  profiler.stage[DIV_PROF_PREVIEW].add(profStage[DIV_PROF_PREVIEW]);
+  profiler.stage[DIV_PROF_MIX].add(profStage[DIV_PROF_MIX]);
 
-  // clamp output (if enabled)
-  if (clampSamples) {
-    for (size_t i=0; i<size; i++) {
-      for (int j=0; j<outChans; j++) {
-        if (out[j][i]<-1.0) out[j][i]=-1.0;
-        if (out[j][i]>1.0) out[j][i]=1.0;
-      }
-    }
-  }
   isBusy.unlock();
 
   std::chrono::steady_clock::time_point ts_processEnd=std::chrono::steady_clock::now();
 
   processTime=std::chrono::duration_cast<std::chrono::nanoseconds>(ts_processEnd-ts_processBegin).count();
+  profiler.stage[DIV_PROF_TOTAL].add(processTime);
 }
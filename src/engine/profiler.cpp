@@ -0,0 +1,173 @@
+/**
+ * Furnace Tracker - multi-system chiptune tracker
+ * Copyright (C) 2021-2024 tildearrow and contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "profiler.h"
+#include <fmt/printf.h>
+
+static const char* stageNames[DIV_PROF_MAX]={
+  "midi",
+  "preview",
+  "tick",
+  "acquire",
+  "fill",
+  "mix",
+  "total"
+};
+
+// values below 8 get their own bucket.
+// above that, each octave is split in 8.
+static inline int getBucket(unsigned int v) {
+  if (v<8) return v;
+  int e=31;
+  while (!(v&(1U<<e))) e--;
+  return ((e-2)<<3)|((v>>(e-3))&7);
+}
+
+// middle of a bucket
+static inline double getBucketValue(int b) {
+  if (b<8) return b;
+  int e=(b>>3)+2;
+  double width=(double)(1U<<(e-3));
+  return (double)(8+(b&7))*width+width*0.5;
+}
+
+DivProfHistogram::DivProfHistogram():
+  windowCount(0) {
+  reset();
+}
+
+void DivProfHistogram::add(uint64_t ns) {
+  unsigned int v=(ns>0xffffffffULL)?0xffffffffU:(unsigned int)ns;
+  int b=getBucket(v);
+  int w=curWindow.load(std::memory_order_relaxed);
+
+  window[w][b].store(window[w][b].load(std::memory_order_relaxed)+1,std::memory_order_relaxed);
+  if (v>windowMax[w].load(std::memory_order_relaxed)) windowMax[w].store(v,std::memory_order_relaxed);
+  total[b].store(total[b].load(std::memory_order_relaxed)+1,std::memory_order_relaxed);
+  if (v>totalMax.load(std::memory_order_relaxed)) totalMax.store(v,std::memory_order_relaxed);
+
+  if (++windowCount>=DIV_PROF_WINDOW) {
+    // start over in the older window
+    windowCount=0;
+    w^=1;
+    for (int i=0; i<DIV_PROF_BUCKETS; i++) {
+      window[w][i].store(0,std::memory_order_relaxed);
+    }
+    windowMax[w].store(0,std::memory_order_relaxed);
+    curWindow.store(w,std::memory_order_relaxed);
+  }
+}
+
+DivProfStats DivProfHistogram::calcStats(const unsigned int* counts, unsigned int max) {
+  DivProfStats ret;
+  for (int i=0; i<DIV_PROF_BUCKETS; i++) {
+    ret.count+=counts[i];
+  }
+  if (ret.count==0) return ret;
+
+  unsigned int p50Pos=(ret.count+1)/2;
+  unsigned int p99Pos=ret.count-ret.count/100;
+  unsigned int acc=0;
+  bool gotP50=false;
+  for (int i=0; i<DIV_PROF_BUCKETS; i++) {
+    acc+=counts[i];
+    if (!gotP50 && acc>=p50Pos) {
+      ret.p50=getBucketValue(i)/1000.0;
+      gotP50=true;
+    }
+    if (acc>=p99Pos) {
+      ret.p99=getBucketValue(i)/1000.0;
+      break;
+    }
+  }
+  ret.max=(double)max/1000.0;
+  // don't report a percentile above the real maximum
+  if (ret.p50>ret.max) ret.p50=ret.max;
+  if (ret.p99>ret.max) ret.p99=ret.max;
+  return ret;
+}
+
+DivProfStats DivProfHistogram::getStats(bool rolling) const {
+  unsigned int counts[DIV_PROF_BUCKETS];
+  unsigned int max=0;
+  if (rolling) {
+    for (int i=0; i<DIV_PROF_BUCKETS; i++) {
+      counts[i]=window[0][i].load(std::memory_order_relaxed)+window[1][i].load(std::memory_order_relaxed);
+    }
+    max=MAX(windowMax[0].load(std::memory_order_relaxed),windowMax[1].load(std::memory_order_relaxed));
+  } else {
+    for (int i=0; i<DIV_PROF_BUCKETS; i++) {
+      counts[i]=total[i].load(std::memory_order_relaxed);
+    }
+    max=totalMax.load(std::memory_order_relaxed);
+  }
+  return calcStats(counts,max);
+}
+
+void DivProfHistogram::reset() {
+  for (int i=0; i<DIV_PROF_BUCKETS; i++) {
+    window[0][i].store(0,std::memory_order_relaxed);
+    window[1][i].store(0,std::memory_order_relaxed);
+    total[i].store(0,std::memory_order_relaxed);
+  }
+  windowMax[0].store(0,std::memory_order_relaxed);
+  windowMax[1].store(0,std::memory_order_relaxed);
+  totalMax.store(0,std::memory_order_relaxed);
+  curWindow.store(0,std::memory_order_relaxed);
+  windowCount=0;
+}
+
+const char* DivProfiler::getStageName(int stage) {
+  if (stage<0 || stage>=DIV_PROF_MAX) return "???";
+  return stageNames[stage];
+}
+
+void DivProfiler::reset() {
+  for (int i=0; i<DIV_PROF_MAX; i++) {
+    stage[i].reset();
+  }
+  for (int i=0; i<DIV_MAX_CHIPS; i++) {
+    chipAcquire[i].reset();
+    chipFill[i].reset();
+  }
+}
+
+static String statsToJSON(const DivProfStats& s) {
+  return fmt::sprintf("{\"count\": %u, \"p50\": %.3f, \"p99\": %.3f, \"max\": %.3f}",s.count,s.p50,s.p99,s.max);
+}
+
+String DivProfiler::toJSON(const char** chipNames, int chips) const {
+  String ret="{\n  \"unit\": \"us\",\n  \"stages\": {\n";
+  for (int i=0; i<DIV_PROF_MAX; i++) {
+    ret+=fmt::sprintf("    \"%s\": %s%s\n",stageNames[i],statsToJSON(stage[i].getStats(false)),(i<DIV_PROF_MAX-1)?",":"");
+  }
+  ret+="  },\n  \"chips\": [\n";
+  for (int i=0; i<chips && i<DIV_MAX_CHIPS; i++) {
+    String name;
+    // escape the name
+    for (const char* j=chipNames[i]; j!=NULL && *j; j++) {
+      if (*j=='"' || *j=='\\') name+='\\';
+      if ((unsigned char)*j<0x20) continue;
+      name+=*j;
+    }
+    ret+=fmt::sprintf("    {\"index\": %d, \"name\": \"%s\", \"acquire\": %s, \"fill\": %s}%s\n",i,name,statsToJSON(chipAcquire[i].getStats(false)),statsToJSON(chipFill[i].getStats(false)),(i<chips-1)?",":"");
+  }
+  ret+="  ]\n}\n";
+  return ret;
+}
@@ -0,0 +1,127 @@
+/**
+ * Furnace Tracker - multi-system chiptune tracker
+ * Copyright (C) 2021-2024 tildearrow and contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _PROFILER_H
+#define _PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <stdint.h>
+#include "defines.h"
+#include "../ta-utils.h"
+
+// 8 buckets per octave, up to ~4s
+#define DIV_PROF_BUCKETS 240
+// buffers per rolling window. statistics cover the last one or two windows.
+#define DIV_PROF_WINDOW 512
+
+enum DivProfStage {
+  DIV_PROF_MIDI=0,
+  DIV_PROF_PREVIEW,
+  DIV_PROF_TICK,
+  DIV_PROF_ACQUIRE,
+  DIV_PROF_FILL,
+  DIV_PROF_MIX,
+  DIV_PROF_TOTAL,
+
+  DIV_PROF_MAX
+};
+
+// current time in nanoseconds, for measuring
+inline uint64_t divProfNow() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct DivProfStats {
+  // number of buffers
+  unsigned int count;
+  // in microseconds
+  double p50, p99, max;
+  DivProfStats():
+    count(0),
+    p50(0.0),
+    p99(0.0),
+    max(0.0) {}
+};
+
+/**
+ * a histogram of per-buffer times.
+ * one thread adds values while any other may read statistics.
+ */
+class DivProfHistogram {
+  // rolling: two windows which take turns
+  std::atomic<unsigned int> window[2][DIV_PROF_BUCKETS];
+  std::atomic<unsigned int> windowMax[2];
+  std::atomic<int> curWindow;
+  unsigned int windowCount;
+  // since the last reset
+  std::atomic<unsigned int> total[DIV_PROF_BUCKETS];
+  std::atomic<unsigned int> totalMax;
+
+  static DivProfStats calcStats(const unsigned int* counts, unsigned int max);
+
+  public:
+    /**
+     * add a value (writer only).
+     * @param ns time in nanoseconds.
+     */
+    void add(uint64_t ns);
+
+    /**
+     * get statistics.
+     * @param rolling whether to only consider recent buffers.
+     */
+    DivProfStats getStats(bool rolling=true) const;
+
+    /**
+     * clear everything. must not run at the same time as add().
+     */
+    void reset();
+
+    DivProfHistogram();
+};
+
+/**
+ * per-stage and per-chip timing of DivEngine::nextBuf().
+ */
+class DivProfiler {
+  public:
+    DivProfHistogram stage[DIV_PROF_MAX];
+    DivProfHistogram chipAcquire[DIV_MAX_CHIPS];
+    DivProfHistogram chipFill[DIV_MAX_CHIPS];
+
+    /**
+     * get the name of a stage.
+     */
+    static const char* getStageName(int stage);
+
+    /**
+     * clear all histograms.
+     */
+    void reset();
+
+    /**
+     * get all statistics (since the last reset) as JSON.
+     * @param chipNames the name of each chip.
+     * @param chips how many chips there are.
+     */
+    String toJSON(const char** chipNames, int chips) const;
+};
+
+#endif
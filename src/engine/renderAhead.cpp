@@ -0,0 +1,193 @@
+/**
+ * Furnace Tracker - multi-system chiptune tracker
+ * Copyright (C) 2021-2024 tildearrow and contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "renderAhead.h"
+#include "engine.h"
+#include "allocTrap.h"
+#include "../ta-log.h"
+#include <chrono>
+
+void* _renderAheadThread(void* inst) {
+  ((DivRenderAhead*)inst)->run();
+  return NULL;
+}
+
+size_t DivAudioRing::avail() {
+  return writePos.load(std::memory_order_acquire)-readPos.load(std::memory_order_relaxed);
+}
+
+size_t DivAudioRing::space() {
+  return size-(writePos.load(std::memory_order_relaxed)-readPos.load(std::memory_order_acquire));
+}
+
+size_t DivAudioRing::write(float** in, size_t len) {
+  size_t w=writePos.load(std::memory_order_relaxed);
+  size_t s=space();
+  if (len>s) len=s;
+  for (size_t i=0; i<len; i++) {
+    float* f=&data[((w+i)&mask)*chans];
+    for (int j=0; j<chans; j++) {
+      f[j]=in[j][i];
+    }
+  }
+  writePos.store(w+len,std::memory_order_release);
+  return len;
+}
+
+size_t DivAudioRing::read(float** out, int outChans, size_t len) {
+  size_t r=readPos.load(std::memory_order_relaxed);
+  size_t a=avail();
+  int copyChans=MIN(chans,outChans);
+  if (len>a) len=a;
+  for (size_t i=0; i<len; i++) {
+    float* f=&data[((r+i)&mask)*chans];
+    for (int j=0; j<copyChans; j++) {
+      out[j][i]=f[j];
+    }
+    for (int j=copyChans; j<outChans; j++) {
+      out[j][i]=0;
+    }
+  }
+  readPos.store(r+len,std::memory_order_release);
+  return len;
+}
+
+void DivAudioRing::init(int ch, size_t frames) {
+  quit();
+  size=1;
+  while (size<frames) size<<=1;
+  mask=size-1;
+  chans=ch;
+  data=new float[size*chans];
+  memset(data,0,size*chans*sizeof(float));
+  readPos=0;
+  writePos=0;
+}
+
+void DivAudioRing::quit() {
+  if (data!=NULL) {
+    delete[] data;
+    data=NULL;
+  }
+  size=0;
+  mask=0;
+}
+
+DivAudioRing::~DivAudioRing() {
+  quit();
+}
+
+void DivRenderAhead::run() {
+  unsigned int lastUnderruns=0;
+  logV("running render-ahead thread");
+
+  while (!terminate.load()) {
+    if (started.load() && ring.avail()<target && ring.space()>=period) {
+      DIV_ALLOC_TRAP_SCOPE(true);
+      e->nextBuf(NULL,renderBuf,0,chans,period);
+      ring.write(renderBuf,period);
+      continue;
+    }
+
+    // report underruns from here, as the audio callback must not log
+    unsigned int underruns=statUnderruns.load(std::memory_order_relaxed);
+    if (underruns!=lastUnderruns) {
+      logW("render-ahead: %d underrun(s)!",underruns-lastUnderruns);
+      lastUnderruns=underruns;
+    }
+
+    // the audio callback does not take the lock when notifying, so a wakeup
+    // may be missed. the timeout makes up for it.
+    std::unique_lock<std::mutex> lock(waitLock);
+    waitCond.wait_for(lock,std::chrono::microseconds(waitTime));
+  }
+
+  logV("render-ahead thread finished");
+}
+
+void DivRenderAhead::pull(float** out, int outChans, unsigned int size) {
+  size_t got=ring.read(out,outChans,size);
+  if (got<size) {
+    for (int i=0; i<outChans; i++) {
+      memset(&out[i][got],0,(size-got)*sizeof(float));
+    }
+    if (started.load(std::memory_order_relaxed)) {
+      statUnderruns.fetch_add(1,std::memory_order_relaxed);
+      statMissed.fetch_add(size-got,std::memory_order_relaxed);
+    } else {
+      started.store(true);
+    }
+  }
+  waitCond.notify_one();
+}
+
+unsigned int DivRenderAhead::getLatency() {
+  return target;
+}
+
+void DivRenderAhead::getStats(unsigned int& underruns, unsigned long long& missed, size_t& fill) {
+  underruns=statUnderruns.load(std::memory_order_relaxed);
+  missed=statMissed.load(std::memory_order_relaxed);
+  fill=ring.writePos.load(std::memory_order_relaxed)-ring.readPos.load(std::memory_order_relaxed);
+}
+
+DivRenderAhead::DivRenderAhead(DivEngine* eng, int ch, int rate, unsigned int bufsize, unsigned int periods):
+  e(eng),
+  thread(NULL),
+  chans(ch),
+  period(bufsize),
+  terminate(false),
+  started(false),
+  statUnderruns(0),
+  statMissed(0) {
+  if (chans<1) chans=1;
+  if (chans>DIV_MAX_OUTPUTS) chans=DIV_MAX_OUTPUTS;
+  if (period<1) period=1;
+  if (periods<1) periods=1;
+  if (periods>DIV_RENDER_AHEAD_MAX) periods=DIV_RENDER_AHEAD_MAX;
+  if (rate<1) rate=44100;
+  target=period*periods;
+  // wake up a few times per period
+  waitTime=MAX(50,(unsigned int)(((unsigned long long)period*250000)/rate));
+
+  memset(renderBuf,0,DIV_MAX_OUTPUTS*sizeof(float*));
+  for (int i=0; i<chans; i++) {
+    renderBuf[i]=new float[period];
+  }
+  ring.init(chans,target+period);
+
+  logD("render-ahead: %d periods of %d frames (%d in ring)",periods,period,(int)ring.size);
+  thread=new std::thread(_renderAheadThread,this);
+}
+
+DivRenderAhead::~DivRenderAhead() {
+  terminate=true;
+  waitCond.notify_one();
+  if (thread!=NULL) {
+    thread->join();
+    delete thread;
+    thread=NULL;
+  }
+  for (int i=0; i<DIV_MAX_OUTPUTS; i++) {
+    if (renderBuf[i]!=NULL) {
+      delete[] renderBuf[i];
+      renderBuf[i]=NULL;
+    }
+  }
+}
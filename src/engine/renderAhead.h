@@ -0,0 +1,132 @@
+/**
+ * Furnace Tracker - multi-system chiptune tracker
+ * Copyright (C) 2021-2024 tildearrow and contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _RENDERAHEAD_H
+#define _RENDERAHEAD_H
+
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include "defines.h"
+
+// maximum number of periods to render ahead
+#define DIV_RENDER_AHEAD_MAX 16
+
+class DivEngine;
+
+/**
+ * a lock-free ring buffer of interleaved float frames with one producer and one consumer.
+ */
+struct DivAudioRing {
+  float* data;
+  size_t size, mask;
+  int chans;
+  std::atomic<size_t> readPos, writePos;
+
+  // consumer only. frames which may be read.
+  size_t avail();
+  // producer only. frames which may be written.
+  size_t space();
+  // producer only. returns how many frames were written.
+  size_t write(float** in, size_t len);
+  // consumer only. returns how many frames were read.
+  size_t read(float** out, int outChans, size_t len);
+
+  /**
+   * allocate the ring.
+   * @param ch number of channels.
+   * @param frames minimum capacity in frames (rounded up to a power of two).
+   */
+  void init(int ch, size_t frames);
+  void quit();
+
+  DivAudioRing():
+    data(NULL),
+    size(0),
+    mask(0),
+    chans(0),
+    readPos(0),
+    writePos(0) {}
+  ~DivAudioRing();
+};
+
+/**
+ * this class runs the engine on a dedicated thread, a number of periods
+ * ahead of the audio backend.
+ * the audio callback only copies from the ring, so it never waits on the engine lock.
+ * it is highly recommended to use `new` when allocating a DivRenderAhead.
+ */
+class DivRenderAhead {
+  DivEngine* e;
+  DivAudioRing ring;
+  std::thread* thread;
+  float* renderBuf[DIV_MAX_OUTPUTS];
+  int chans;
+  unsigned int period;
+  unsigned int target;
+  unsigned int waitTime;
+
+  std::atomic<bool> terminate;
+  // set on the first pull, so that nothing is rendered before the backend runs
+  std::atomic<bool> started;
+  std::mutex waitLock;
+  std::condition_variable waitCond;
+
+  // statistics
+  std::atomic<unsigned int> statUnderruns;
+  std::atomic<unsigned long long> statMissed;
+
+  public:
+    void run();
+
+    /**
+     * copy frames from the ring to the audio backend.
+     * shall only be called from the audio callback.
+     * missing frames are filled with silence and counted as an underrun.
+     */
+    void pull(float** out, int outChans, unsigned int size);
+
+    /**
+     * get the target latency of this render-ahead thread.
+     * @return latency in frames.
+     */
+    unsigned int getLatency();
+
+    /**
+     * get statistics.
+     * @param underruns number of callbacks which did not get enough frames.
+     * @param missed total number of frames which were replaced with silence.
+     * @param fill frames currently in the ring.
+     */
+    void getStats(unsigned int& underruns, unsigned long long& missed, size_t& fill);
+
+    /**
+     * start the render-ahead thread.
+     * @param eng the engine.
+     * @param ch number of output channels.
+     * @param rate sample rate.
+     * @param bufsize period size in frames.
+     * @param periods how many periods to render ahead.
+     */
+    DivRenderAhead(DivEngine* eng, int ch, int rate, unsigned int bufsize, unsigned int periods);
+    ~DivRenderAhead();
+};
+
+#endif
@@ -512,6 +512,7 @@ bool DivSample::saveRaw(const char* path) {
 // 16-bit memory is padded to 512, to make things easier for ADPCM-A/B.
 bool DivSample::initInternal(DivSampleDepth d, int count) {
   logV("initInternal(%d,%d)",(int)d,count);
+  if (d<DIV_SAMPLE_DEPTH_MAX) renderHash[d]=0;
   switch (d) {
     case DIV_SAMPLE_DEPTH_1BIT: // 1-bit
       if (data1!=NULL) delete[] data1;
@@ -1163,6 +1164,40 @@ bool DivSample::resample(double sRate, double tRate, int filter) {
 }
 
 #define NOT_IN_FORMAT(x) (depth!=x && formatMask&(1U<<(unsigned int)x))
+// whether a format is wanted and out of date. sets renderKey.
+#define MUST_RENDER(x,key) (NOT_IN_FORMAT(x) && renderHash[x]!=(renderKey=(key)))
+
+static inline uint64_t mixRenderKey(uint64_t h, uint64_t v) {
+  h=(h^v)*0x9e3779b97f4a7c15ULL;
+  return h^(h>>32);
+}
+
+// not cryptographic. it only has to tell whether a buffer changed.
+static uint64_t hashRenderData(const void* data, size_t len, uint64_t seed) {
+  const unsigned char* d=(const unsigned char*)data;
+  uint64_t ret=mixRenderKey(seed,len);
+  size_t i=0;
+  if (d!=NULL) {
+    for (; i+8<=len; i+=8) {
+      uint64_t w;
+      memcpy(&w,&d[i],8);
+      ret=mixRenderKey(ret,w);
+    }
+    for (; i<len; i++) {
+      ret=mixRenderKey(ret,d[i]);
+    }
+  }
+  // 0 means "not rendered"
+  return ret|1;
+}
+
+static inline uint64_t getFormatKey(uint64_t dataKey, int format, int param1=0, int param2=0, int param3=0) {
+  uint64_t ret=mixRenderKey(dataKey,(uint64_t)(unsigned int)format);
+  ret=mixRenderKey(ret,(uint64_t)(unsigned int)param1);
+  ret=mixRenderKey(ret,(uint64_t)(unsigned int)param2);
+  ret=mixRenderKey(ret,(uint64_t)(unsigned int)param3);
+  return ret|1;
+}
 
 union IntFloat {
   unsigned int i;
@@ -1200,10 +1235,19 @@ signed char adpcmKTable[16]={
   0, 1, 2, 4, 8, 16, 32, 64, -128, -64, -32, -16, -8, -4, -2, -1
 };
 
-void DivSample::render(unsigned int formatMask) {
-  // step 1: convert to 16-bit if needed
+int DivSample::render(unsigned int formatMask) {
+  int rendered=0;
+  uint64_t renderKey=0;
+
+  // the current format is the source. it may be edited directly
+  if (depth<DIV_SAMPLE_DEPTH_MAX) renderHash[depth]=0;
+
+  // step 1: convert to 16-bit if needed (and if the source changed)
   if (depth!=DIV_SAMPLE_DEPTH_16BIT) {
-    if (!initInternal(DIV_SAMPLE_DEPTH_16BIT,samples)) return;
+    renderKey=hashRenderData(getCurBuf(),getCurBufLen(),getFormatKey(0,depth,samples,brrEmphasis));
+  }
+  if (depth!=DIV_SAMPLE_DEPTH_16BIT && (data16==NULL || renderHash[DIV_SAMPLE_DEPTH_16BIT]!=renderKey)) {
+    if (!initInternal(DIV_SAMPLE_DEPTH_16BIT,samples)) return rendered;
     switch (depth) {
       case DIV_SAMPLE_DEPTH_1BIT: // 1-bit
         for (unsigned int i=0; i<samples; i++) {
@@ -1272,21 +1316,30 @@ void DivSample::render(unsigned int formatMask) {
         }
         break;
       default:
-        return;
+        return rendered;
     }
+    renderHash[DIV_SAMPLE_DEPTH_16BIT]=renderKey;
+    rendered++;
   }
+  if (data16==NULL) return rendered;
 
   // step 2: render to other formats
-  if (NOT_IN_FORMAT(DIV_SAMPLE_DEPTH_1BIT)) { // 1-bit
-    if (!initInternal(DIV_SAMPLE_DEPTH_1BIT,samples)) return;
+  // each one is keyed by the 16-bit data and the parameters it depends on
+  uint64_t dataKey=hashRenderData(data16,samples*sizeof(short),getFormatKey(0,depth,samples));
+  if (MUST_RENDER(DIV_SAMPLE_DEPTH_1BIT,getFormatKey(dataKey,DIV_SAMPLE_DEPTH_1BIT))) { // 1-bit
+    if (!initInternal(DIV_SAMPLE_DEPTH_1BIT,samples)) return rendered;
+    renderHash[DIV_SAMPLE_DEPTH_1BIT]=renderKey;
+    rendered++;
     for (unsigned int i=0; i<samples; i++) {
       if (data16[i]>0) {
         data1[i>>3]|=1<<(i&7);
       }
     }
   }
-  if (NOT_IN_FORMAT(DIV_SAMPLE_DEPTH_1BIT_DPCM)) { // DPCM
-    if (!initInternal(DIV_SAMPLE_DEPTH_1BIT_DPCM,samples)) return;
+  if (MUST_RENDER(DIV_SAMPLE_DEPTH_1BIT_DPCM,getFormatKey(dataKey,DIV_SAMPLE_DEPTH_1BIT_DPCM))) { // DPCM
+    if (!initInternal(DIV_SAMPLE_DEPTH_1BIT_DPCM,samples)) return rendered;
+    renderHash[DIV_SAMPLE_DEPTH_1BIT_DPCM]=renderKey;
+    rendered++;
     int accum=63;
     int next=63;
     for (unsigned int i=0; (i<samples && (i>>3)<lengthDPCM); i++) {
@@ -1302,25 +1355,35 @@ void DivSample::render(unsigned int formatMask) {
       if (accum>127) accum=127;
     }
   }
-  if (NOT_IN_FORMAT(DIV_SAMPLE_DEPTH_YMZ_ADPCM)) { // YMZ ADPCM
-    if (!initInternal(DIV_SAMPLE_DEPTH_YMZ_ADPCM,samples)) return;
+  if (MUST_RENDER(DIV_SAMPLE_DEPTH_YMZ_ADPCM,getFormatKey(dataKey,DIV_SAMPLE_DEPTH_YMZ_ADPCM))) { // YMZ ADPCM
+    if (!initInternal(DIV_SAMPLE_DEPTH_YMZ_ADPCM,samples)) return rendered;
+    renderHash[DIV_SAMPLE_DEPTH_YMZ_ADPCM]=renderKey;
+    rendered++;
     ymz_encode(data16,dataZ,(samples+7)&(~0x7));
   }
-  if (NOT_IN_FORMAT(DIV_SAMPLE_DEPTH_QSOUND_ADPCM)) { // QSound ADPCM
-    if (!initInternal(DIV_SAMPLE_DEPTH_QSOUND_ADPCM,samples)) return;
+  if (MUST_RENDER(DIV_SAMPLE_DEPTH_QSOUND_ADPCM,getFormatKey(dataKey,DIV_SAMPLE_DEPTH_QSOUND_ADPCM))) { // QSound ADPCM
+    if (!initInternal(DIV_SAMPLE_DEPTH_QSOUND_ADPCM,samples)) return rendered;
+    renderHash[DIV_SAMPLE_DEPTH_QSOUND_ADPCM]=renderKey;
+    rendered++;
     bs_encode(data16,dataQSoundA,samples);
   }
   // TODO: pad to 256.
-  if (NOT_IN_FORMAT(DIV_SAMPLE_DEPTH_ADPCM_A)) { // ADPCM-A
-    if (!initInternal(DIV_SAMPLE_DEPTH_ADPCM_A,samples)) return;
+  if (MUST_RENDER(DIV_SAMPLE_DEPTH_ADPCM_A,getFormatKey(dataKey,DIV_SAMPLE_DEPTH_ADPCM_A))) { // ADPCM-A
+    if (!initInternal(DIV_SAMPLE_DEPTH_ADPCM_A,samples)) return rendered;
+    renderHash[DIV_SAMPLE_DEPTH_ADPCM_A]=renderKey;
+    rendered++;
     yma_encode(data16,dataA,(samples+511)&(~0x1ff));
   }
-  if (NOT_IN_FORMAT(DIV_SAMPLE_DEPTH_ADPCM_B)) { // ADPCM-B
-    if (!initInternal(DIV_SAMPLE_DEPTH_ADPCM_B,samples)) return;
+  if (MUST_RENDER(DIV_SAMPLE_DEPTH_ADPCM_B,getFormatKey(dataKey,DIV_SAMPLE_DEPTH_ADPCM_B))) { // ADPCM-B
+    if (!initInternal(DIV_SAMPLE_DEPTH_ADPCM_B,samples)) return rendered;
+    renderHash[DIV_SAMPLE_DEPTH_ADPCM_B]=renderKey;
+    rendered++;
     ymb_encode(data16,dataB,(samples+511)&(~0x1ff));
   }
-  if (NOT_IN_FORMAT(DIV_SAMPLE_DEPTH_ADPCM_K)) { // K05 ADPCM
-    if (!initInternal(DIV_SAMPLE_DEPTH_ADPCM_K,samples)) return;
+  if (MUST_RENDER(DIV_SAMPLE_DEPTH_ADPCM_K,getFormatKey(dataKey,DIV_SAMPLE_DEPTH_ADPCM_K))) { // K05 ADPCM
+    if (!initInternal(DIV_SAMPLE_DEPTH_ADPCM_K,samples)) return rendered;
+    renderHash[DIV_SAMPLE_DEPTH_ADPCM_K]=renderKey;
+    rendered++;
     signed char accum=0;
     unsigned char out=0;
     for (unsigned int i=0; i<samples; i++) {
@@ -1378,8 +1441,10 @@ void DivSample::render(unsigned int formatMask) {
       }
     }
   }
-  if (NOT_IN_FORMAT(DIV_SAMPLE_DEPTH_8BIT)) { // 8-bit PCM
-    if (!initInternal(DIV_SAMPLE_DEPTH_8BIT,samples)) return;
+  if (MUST_RENDER(DIV_SAMPLE_DEPTH_8BIT,getFormatKey(dataKey,DIV_SAMPLE_DEPTH_8BIT,dither))) { // 8-bit PCM
+    if (!initInternal(DIV_SAMPLE_DEPTH_8BIT,samples)) return rendered;
+    renderHash[DIV_SAMPLE_DEPTH_8BIT]=renderKey;
+    rendered++;
     if (dither) {
       unsigned short lfsr=0x6438;
       unsigned short lfsr1=0x1283;
@@ -1399,17 +1464,23 @@ void DivSample::render(unsigned int formatMask) {
       }
     }
   }
-  if (NOT_IN_FORMAT(DIV_SAMPLE_DEPTH_BRR)) { // BRR
+  if (MUST_RENDER(DIV_SAMPLE_DEPTH_BRR,getFormatKey(dataKey,DIV_SAMPLE_DEPTH_BRR,loop?loopEnd:samples,loop?loopStart:-1,brrEmphasis))) { // BRR
     int sampleCount=loop?loopEnd:samples;
-    if (!initInternal(DIV_SAMPLE_DEPTH_BRR,sampleCount)) return;
+    if (!initInternal(DIV_SAMPLE_DEPTH_BRR,sampleCount)) return rendered;
+    renderHash[DIV_SAMPLE_DEPTH_BRR]=renderKey;
+    rendered++;
     brrEncode(data16,dataBRR,sampleCount,loop?loopStart:-1,brrEmphasis);
   }
-  if (NOT_IN_FORMAT(DIV_SAMPLE_DEPTH_VOX)) { // VOX
-    if (!initInternal(DIV_SAMPLE_DEPTH_VOX,samples)) return;
+  if (MUST_RENDER(DIV_SAMPLE_DEPTH_VOX,getFormatKey(dataKey,DIV_SAMPLE_DEPTH_VOX))) { // VOX
+    if (!initInternal(DIV_SAMPLE_DEPTH_VOX,samples)) return rendered;
+    renderHash[DIV_SAMPLE_DEPTH_VOX]=renderKey;
+    rendered++;
     oki_encode(data16,dataVOX,samples);
   }
-  if (NOT_IN_FORMAT(DIV_SAMPLE_DEPTH_MULAW)) { // µ-law
-    if (!initInternal(DIV_SAMPLE_DEPTH_MULAW,samples)) return;
+  if (MUST_RENDER(DIV_SAMPLE_DEPTH_MULAW,getFormatKey(dataKey,DIV_SAMPLE_DEPTH_MULAW))) { // µ-law
+    if (!initInternal(DIV_SAMPLE_DEPTH_MULAW,samples)) return rendered;
+    renderHash[DIV_SAMPLE_DEPTH_MULAW]=renderKey;
+    rendered++;
     for (unsigned int i=0; i<samples; i++) {
       IntFloat s;
       s.f=data16[i];
@@ -1421,8 +1492,10 @@ void DivSample::render(unsigned int formatMask) {
       dataMuLaw[i]=(((data16[i]<0)?0x80:0)|(s.i&0x03f80000)>>19)^0xff;
     }
   }
-  if (NOT_IN_FORMAT(DIV_SAMPLE_DEPTH_C219)) { // C219
-    if (!initInternal(DIV_SAMPLE_DEPTH_C219,samples)) return;
+  if (MUST_RENDER(DIV_SAMPLE_DEPTH_C219,getFormatKey(dataKey,DIV_SAMPLE_DEPTH_C219))) { // C219
+    if (!initInternal(DIV_SAMPLE_DEPTH_C219,samples)) return rendered;
+    renderHash[DIV_SAMPLE_DEPTH_C219]=renderKey;
+    rendered++;
     for (unsigned int i=0; i<samples; i++) {
       short s=data16[i];
       unsigned char x=0;
@@ -1442,6 +1515,7 @@ void DivSample::render(unsigned int formatMask) {
       dataC219[i]=x|(negate?0x80:0);
     }
   }
+  return rendered;
 }
 
 void* DivSample::getCurBuf() {
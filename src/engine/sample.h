@@ -20,6 +20,7 @@
 #ifndef _SAMPLE_H
 #define _SAMPLE_H
 
+#include <stdint.h>
 #include "../ta-utils.h"
 #include "defines.h"
 #include "safeWriter.h"
@@ -144,6 +145,9 @@ struct DivSample {
 
   unsigned int samples;
 
+  // what each format was last rendered from. 0 means it has to be rendered again.
+  uint64_t renderHash[DIV_SAMPLE_DEPTH_MAX];
+
   FixedQueue<DivSampleHistory*,128> undoHist;
   FixedQueue<DivSampleHistory*,128> redoHist;
 
@@ -289,8 +293,12 @@ struct DivSample {
 
   /**
    * initialize the rest of sample formats for this sample.
+   * formats whose source data and parameters did not change since the last call are not rendered again.
+   * different samples may be rendered from different threads at once.
+   * @param formatMask which formats to render.
+   * @return how many formats were rendered.
    */
-  void render(unsigned int formatMask=0xffffffff);
+  int render(unsigned int formatMask=0xffffffff);
 
   /**
    * get the sample data for the current depth.
@@ -363,6 +371,9 @@ struct DivSample {
     lengthMuLaw(0),
     lengthC219(0),
     samples(0) {
+    for (int i=0; i<DIV_SAMPLE_DEPTH_MAX; i++) {
+      renderHash[i]=0;
+    }
     for (int i=0; i<DIV_MAX_CHIPS; i++) {
       for (int j=0; j<DIV_MAX_SAMPLE_TYPE; j++) {
         renderOn[j][i]=true;
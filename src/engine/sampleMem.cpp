@@ -0,0 +1,124 @@
+/**
+ * Furnace Tracker - multi-system chiptune tracker
+ * Copyright (C) 2021-2024 tildearrow and contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "sampleMem.h"
+#include "../ta-utils.h"
+#include <string.h>
+
+void DivSampleMem::detach() {
+  if (refs==NULL) return;
+  if (*refs>1) {
+    // make our own copy
+    (*refs)--;
+    if (data!=NULL) {
+      unsigned char* newData=new unsigned char[len];
+      memcpy(newData,data,len);
+      data=newData;
+    }
+  } else {
+    delete refs;
+  }
+  refs=NULL;
+}
+
+void DivSampleMem::resize(size_t newLen) {
+  detach();
+  if (newLen==len) return;
+  unsigned char* newData=NULL;
+  if (newLen>0) {
+    newData=new unsigned char[newLen];
+    if (data!=NULL) memcpy(newData,data,MIN(len,newLen));
+    if (newLen>len) memset(&newData[len],fill,newLen-len);
+  }
+  if (data!=NULL) delete[] data;
+  data=newData;
+  len=newLen;
+}
+
+void DivSampleMem::init(size_t capacity, unsigned char fillVal) {
+  quit();
+  cap=capacity;
+  fill=fillVal;
+}
+
+void DivSampleMem::quit() {
+  if (refs!=NULL) {
+    if (--(*refs)>0) {
+      // somebody else still uses it
+      data=NULL;
+    }
+    if (*refs<=0) delete refs;
+    refs=NULL;
+  }
+  if (data!=NULL) {
+    delete[] data;
+    data=NULL;
+  }
+  len=0;
+}
+
+void DivSampleMem::clear() {
+  if (isShared()) {
+    // no need to copy what is about to be cleared
+    quit();
+    return;
+  }
+  if (data!=NULL) memset(data,fill,len);
+}
+
+bool DivSampleMem::grow(size_t size) {
+  bool ret=true;
+  if (size>cap) {
+    size=cap;
+    ret=false;
+  }
+  detach();
+  if (size<=len) return ret;
+
+  // double to avoid copying on every sample
+  size_t newLen=MAX(len*2,(size+DIV_SAMPLE_MEM_BLOCK-1)&(~(size_t)(DIV_SAMPLE_MEM_BLOCK-1)));
+  if (newLen>cap) newLen=cap;
+  resize(newLen);
+  return ret;
+}
+
+void DivSampleMem::fit(size_t size) {
+  size_t newLen=(size+DIV_SAMPLE_MEM_BLOCK-1)&(~(size_t)(DIV_SAMPLE_MEM_BLOCK-1));
+  if (newLen>cap) newLen=cap;
+  if (newLen>=len) return;
+  resize(newLen);
+}
+
+void DivSampleMem::share(DivSampleMem& other) {
+  if (&other==this || (refs!=NULL && refs==other.refs)) return;
+  quit();
+  if (other.data==NULL) return;
+  if (other.refs==NULL) {
+    other.refs=new int;
+    *other.refs=1;
+  }
+  (*other.refs)++;
+  refs=other.refs;
+  data=other.data;
+  len=other.len;
+}
+
+DivSampleMem::~DivSampleMem() {
+  quit();
+}
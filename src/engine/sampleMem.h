@@ -0,0 +1,122 @@
+/**
+ * Furnace Tracker - multi-system chiptune tracker
+ * Copyright (C) 2021-2024 tildearrow and contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _SAMPLEMEM_H
+#define _SAMPLEMEM_H
+
+#include <stddef.h>
+
+// allocation granularity
+#define DIV_SAMPLE_MEM_BLOCK 65536
+
+/**
+ * chip sample memory which is only allocated up to the extent in use.
+ * reads past the allocated part return the fill value.
+ * the full capacity is still what the chip reports.
+ *
+ * the allocated part may be shared between instances of the same chip (see share()).
+ * it is copied on write. none of this is thread-safe.
+ */
+class DivSampleMem {
+  unsigned char* data;
+  size_t len, cap;
+  unsigned char fill;
+  // reference count if shared, otherwise NULL
+  int* refs;
+
+  void resize(size_t newLen);
+  void detach();
+
+  public:
+    /**
+     * set the capacity and fill value. frees everything.
+     */
+    void init(size_t capacity, unsigned char fillVal=0);
+
+    /**
+     * free everything.
+     */
+    void quit();
+
+    /**
+     * clear the allocated part. call before rendering samples.
+     */
+    void clear();
+
+    /**
+     * make sure that at least size bytes are allocated (clamped to the capacity).
+     * the allocated part may move!
+     * @return whether the whole size fits.
+     */
+    bool grow(size_t size);
+
+    /**
+     * release what lies past size. call after rendering samples.
+     */
+    void fit(size_t size);
+
+    /**
+     * drop the contents and use the allocated part of another memory instead.
+     * both must have the same capacity and fill value.
+     */
+    void share(DivSampleMem& other);
+
+    /**
+     * whether the allocated part is shared with another memory.
+     */
+    inline bool isShared() const {
+      return refs!=NULL && *refs>1;
+    }
+
+    /**
+     * read a byte.
+     */
+    inline unsigned char read(size_t addr) const {
+      return (addr<len)?data[addr]:fill;
+    }
+
+    /**
+     * get the allocated part. may be NULL.
+     * do not write to it unless grow() has been called since the last share().
+     */
+    inline unsigned char* getData() const {
+      return data;
+    }
+
+    /**
+     * get the allocated length.
+     */
+    inline size_t getLen() const {
+      return len;
+    }
+
+    inline size_t getCapacity() const {
+      return cap;
+    }
+
+    DivSampleMem():
+      data(NULL),
+      len(0),
+      cap(0),
+      fill(0),
+      refs(NULL) {}
+    ~DivSampleMem();
+};
+
+#endif
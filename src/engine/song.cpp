@@ -57,6 +57,32 @@ void DivSubSong::rearrangePatterns() {
   }
 }
 
+void DivSubSong::fitPatterns(bool shrink) {
+  for (int i=0; i<DIV_MAX_CHANS; i++) {
+    pat[i].fitPatterns(shrink);
+  }
+}
+
+void DivSong::fitPatterns() {
+  int count=0;
+  for (DivSubSong* i: subsong) {
+    i->fitPatterns(true);
+  }
+  size_t usage=getPatternMemUsage(&count);
+  logD("pattern data: %dK in %d patterns (%dK with fixed-size patterns)",(int)(usage>>10),count,(int)((count*(sizeof(DivPattern)+DIV_MAX_ROWS*DIV_MAX_COLS*sizeof(short)))>>10));
+}
+
+size_t DivSong::getPatternMemUsage(int* count) {
+  size_t ret=0;
+  if (count!=NULL) *count=0;
+  for (DivSubSong* i: subsong) {
+    for (int j=0; j<DIV_MAX_CHANS; j++) {
+      ret+=i->pat[j].getMemUsage(count);
+    }
+  }
+  return ret;
+}
+
 void DivSong::clearSongData() {
   for (DivSubSong* i: subsong) {
     i->clearData();
@@ -176,6 +176,13 @@ struct DivSubSong {
   void optimizePatterns();
   void rearrangePatterns();
 
+  /**
+   * resize patterns to the pattern length and effect columns.
+   * not thread-safe! use a mutex!
+   * @param shrink whether to discard data past them as well.
+   */
+  void fitPatterns(bool shrink=false);
+
   DivSubSong(): 
     hilightA(4),
     hilightB(16),
@@ -190,6 +197,7 @@ struct DivSubSong {
       chanShow[i]=true;
       chanShowChanOsc[i]=true;
       chanCollapse[i]=0;
+      pat[i].patLen=&patLen;
     }
   }
 };
@@ -410,6 +418,18 @@ struct DivSong {
    */
   void clearSongData();
 
+  /**
+   * trim all patterns to the pattern length and effect columns of their subsong.
+   * used after loading.
+   */
+  void fitPatterns();
+
+  /**
+   * get the memory used by patterns.
+   * @param count if not NULL, the number of patterns is stored here.
+   */
+  size_t getPatternMemUsage(int* count=NULL);
+
   /**
    * clear instruments.
    */
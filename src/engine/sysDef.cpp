@@ -22,6 +22,7 @@
 #include "instrument.h"
 #include "song.h"
 #include "../ta-log.h"
+#include <mutex>
 
 DivSysDef* DivEngine::sysDefs[DIV_MAX_CHIP_DEFS];
 DivSystem DivEngine::sysFileMapFur[DIV_MAX_CHIP_DEFS];
@@ -419,9 +420,24 @@ template<const int bits, const int shift> int effectValLongShift(unsigned char c
   return (((((unsigned int)cmd)&((1<<(bits-8))-1))<<8)|((unsigned int)val))<<shift;
 };
 
+static std::once_flag sysDefsOnce;
+
 void DivEngine::registerSystems() {
+  // sysDefs and the file maps are shared by every DivEngine instance.
+  // they are built exactly once and are read-only afterwards.
+  std::call_once(sysDefsOnce,buildSysDefs);
+  systemsRegistered=true;
+}
+
+void DivEngine::buildSysDefs() {
   logD("registering systems...");
 
+  memset(sysDefs,0,DIV_MAX_CHIP_DEFS*sizeof(void*));
+  for (int i=0; i<DIV_MAX_CHIP_DEFS; i++) {
+    sysFileMapFur[i]=DIV_SYSTEM_NULL;
+    sysFileMapDMF[i]=DIV_SYSTEM_NULL;
+  }
+
   // Common effect handler maps
 
   EffectHandlerMap ayPostEffectHandlerMap={
@@ -2039,6 +2055,4 @@ void DivEngine::registerSystems() {
       sysFileMapDMF[sysDefs[i]->id_DMF]=(DivSystem)i;
     }
   }
-
-  systemsRegistered=true;
 }
@@ -19,6 +19,7 @@
 
 #include "engine.h"
 #include "../ta-log.h"
+#include "workPool.h"
 #ifdef HAVE_SNDFILE
 #include "sfWrapper.h"
 #endif
@@ -33,6 +34,70 @@ bool DivEngine::isExporting() {
   return exporting;
 }
 
+void DivEngine::initStems() {
+  quitStems();
+  for (int i=0; i<chans; i++) {
+    DivExportStem* stem=new DivExportStem;
+    stem->sys=dispatchOfChan[i];
+    stem->firstChan=i;
+    stem->lastChan=i;
+    // linked channels are exported together
+    if (getChannelType(i)==5) {
+      while (stem->lastChan+1<chans && getChannelType(stem->lastChan+1)==5) stem->lastChan++;
+    }
+
+    DivSystem sys=song.system[stem->sys];
+    stem->cont.init(sys,this,getChannelCount(sys),got.rate,song.systemFlags[stem->sys],true);
+    stem->cont.setRates(got.rate);
+    stem->cont.setQuality(lowQuality,dcHiPass);
+    stem->cont.dispatch->renderSamples(stem->sys);
+    for (int j=0; j<chans; j++) {
+      if (dispatchOfChan[j]!=stem->sys) continue;
+      stem->cont.dispatch->muteChannel(dispatchChanOfChan[j],j<stem->firstChan || j>stem->lastChan);
+    }
+
+    stems.push_back(stem);
+    i=stem->lastChan;
+  }
+}
+
+void DivEngine::quitStems() {
+  for (DivExportStem* i: stems) {
+    i->cont.quit();
+    for (int j=0; j<2; j++) {
+      if (i->out[j]!=NULL) delete[] i->out[j];
+    }
+    delete i;
+  }
+  stems.clear();
+}
+
+void DivEngine::initExportPool() {
+  // only go wide if multi-threaded rendering is enabled, or if asked to (-jobs).
+  // otherwise stay single-threaded like playback.
+  unsigned int howManyThreads=0;
+  if (exportThreads>0) {
+    howManyThreads=exportThreads;
+  } else if (renderPoolThreads>0) {
+    // use every core (up to one thread per chip)
+    howManyThreads=std::thread::hardware_concurrency();
+  }
+  if (howManyThreads>(unsigned int)(song.systemLen+stems.size())) howManyThreads=song.systemLen+stems.size();
+  if (howManyThreads<2) howManyThreads=0;
+  if (renderPool!=NULL) delete renderPool;
+  renderPool=new DivWorkPool(howManyThreads);
+  logD("export: %d render threads",howManyThreads);
+}
+
+void DivEngine::quitExportPool() {
+  // bring back the usual pool, so that nextBuf() doesn't have to.
+  if (renderPool!=NULL) {
+    delete renderPool;
+    renderPool=NULL;
+  }
+  initRenderPool();
+}
+
 #ifdef HAVE_SNDFILE
 void DivEngine::runExportThread() {
   size_t fadeOutSamples=got.rate*exportFadeOut;
@@ -62,6 +127,7 @@ void DivEngine::runExportThread() {
 
       // take control of audio output
       deinitAudioBackend();
+      initExportPool();
       playSub(false);
 
       logI("rendering to file...");
@@ -108,6 +174,8 @@ void DivEngine::runExportThread() {
         logE("could not close audio file!");
       }
 
+      quitExportPool();
+
       if (initAudioBackend()) {
         for (int i=0; i<song.systemLen; i++) {
           disCont[i].setRates(got.rate);
@@ -157,6 +225,7 @@ void DivEngine::runExportThread() {
 
       // take control of audio output
       deinitAudioBackend();
+      initExportPool();
       playSub(false);
 
       logI("rendering to files...");
@@ -220,6 +289,8 @@ void DivEngine::runExportThread() {
         }
       }
 
+      quitExportPool();
+
       if (initAudioBackend()) {
         for (int i=0; i<song.systemLen; i++) {
           disCont[i].setRates(got.rate);
@@ -237,114 +308,107 @@ void DivEngine::runExportThread() {
       // take control of audio output
       deinitAudioBackend();
 
-      float* outBuf[3];
-      outBuf[0]=new float[EXPORT_BUFSIZE];
-      outBuf[1]=new float[EXPORT_BUFSIZE];
-      outBuf[2]=new float[EXPORT_BUFSIZE*2];
+      // every channel gets its own copy of its chip, which is fed the same
+      // commands as the song plays. the song is only played once.
+      initStems();
 
-      logI("rendering to files...");
-      
-      for (int i=0; i<chans; i++) {
-        SNDFILE* sf;
-        SF_INFO si;
-        SFWrapper sfWrap;
-        String fname=fmt::sprintf("%s_c%02d.wav",exportPath,i+1);
-        logI("- %s",fname.c_str());
-        si.samplerate=got.rate;
-        si.channels=2;
-        si.format=SF_FORMAT_WAV|SF_FORMAT_PCM_16;
+      SNDFILE* sf[DIV_MAX_CHANS];
+      SF_INFO si;
+      SFWrapper sfWrap[DIV_MAX_CHANS];
+      si.samplerate=got.rate;
+      si.channels=2;
+      si.format=SF_FORMAT_WAV|SF_FORMAT_PCM_16;
 
-        sf=sfWrap.doOpen(fname.c_str(),SFM_WRITE,&si);
-        if (sf==NULL) {
+      bool failed=false;
+      for (size_t i=0; i<stems.size(); i++) {
+        String fname=fmt::sprintf("%s_c%02d.wav",exportPath,stems[i]->firstChan+1);
+        logI("- %s",fname.c_str());
+        sf[i]=sfWrap[i].doOpen(fname.c_str(),SFM_WRITE,&si);
+        if (sf[i]==NULL) {
           logE("could not open file for writing! (%s)",sf_strerror(NULL));
+          for (size_t j=0; j<i; j++) {
+            sfWrap[j].doClose();
+          }
+          failed=true;
           break;
         }
+      }
+
+      if (!failed) {
+        float* outBuf[2];
+        outBuf[0]=new float[EXPORT_BUFSIZE];
+        outBuf[1]=new float[EXPORT_BUFSIZE];
+        float* stemBuf=new float[EXPORT_BUFSIZE*2];
+
+        initExportPool();
+
+        logI("rendering to files (%d stems)...",(int)stems.size());
 
-        for (int j=0; j<chans; j++) {
-          bool mute=(j!=i);
-          isMuted[j]=mute;
-        }
-        if (getChannelType(i)==5) {
-          for (int j=i; j<chans; j++) {
-            if (getChannelType(j)!=5) break;
-            isMuted[j]=false;
-          }
-        }
-        for (int j=0; j<chans; j++) {
-          if (disCont[dispatchOfChan[j]].dispatch!=NULL) {
-            disCont[dispatchOfChan[j]].dispatch->muteChannel(dispatchChanOfChan[j],isMuted[j]);
-          }
-        }
-        
-        curOrder=0;
-        prevOrder=0;
-        curFadeOutSample=0;
-        lastLoopPos=-1;
-        totalLoops=0;
-        isFadingOut=false;
-        remainingLoops=-1;
         playSub(false);
 
         while (playing) {
           size_t total=0;
+          double mul=1.0;
           nextBuf(NULL,outBuf,0,2,EXPORT_BUFSIZE);
           if (totalProcessed>EXPORT_BUFSIZE) {
             logE("error: total processed is bigger than export bufsize! %d>%d",totalProcessed,EXPORT_BUFSIZE);
             totalProcessed=EXPORT_BUFSIZE;
           }
+          // find out where to stop and how much to fade out, then write all stems
+          size_t fadeStart=curFadeOutSample;
+          bool wasFadingOut=isFadingOut;
+          size_t fadeBegin=0;
           for (int j=0; j<(int)totalProcessed; j++) {
             total++;
             if (isFadingOut) {
-              double mul=(1.0-((double)curFadeOutSample/(double)fadeOutSamples));
-              outBuf[2][j<<1]=MAX(-1.0f,MIN(1.0f,outBuf[0][j]))*mul;
-              outBuf[2][1+(j<<1)]=MAX(-1.0f,MIN(1.0f,outBuf[1][j]))*mul;
               if (++curFadeOutSample>=fadeOutSamples) {
                 playing=false;
                 break;
               }
             } else {
-              outBuf[2][j<<1]=MAX(-1.0f,MIN(1.0f,outBuf[0][j]));
-              outBuf[2][1+(j<<1)]=MAX(-1.0f,MIN(1.0f,outBuf[1][j]));
               if (lastLoopPos>-1 && j>=lastLoopPos && totalLoops>=exportLoopCount) {
                 logD("start fading out...");
                 isFadingOut=true;
+                fadeBegin=j+1;
                 if (fadeOutSamples==0) break;
               }
             }
           }
-          if (sf_writef_float(sf,outBuf[2],total)!=(int)total) {
-            logE("error: failed to write entire buffer!");
-            break;
+          for (size_t i=0; i<stems.size(); i++) {
+            DivExportStem* stem=stems[i];
+            size_t fadePos=fadeStart;
+            for (size_t j=0; j<total; j++) {
+              if (wasFadingOut || (isFadingOut && j>=fadeBegin)) {
+                mul=(1.0-((double)fadePos/(double)fadeOutSamples));
+                fadePos++;
+              } else {
+                mul=1.0;
+              }
+              stemBuf[j<<1]=MAX(-1.0f,MIN(1.0f,stem->out[0][j]))*mul;
+              stemBuf[1+(j<<1)]=MAX(-1.0f,MIN(1.0f,stem->out[1][j]))*mul;
+            }
+            if (sf_writef_float(sf[i],stemBuf,total)!=(int)total) {
+              logE("error: failed to write entire buffer! (%d)",(int)i);
+            }
           }
-        }
 
-        if (sfWrap.doClose()!=0) {
-          logE("could not close audio file!");
+          if (stopExport) break;
         }
 
-        if (getChannelType(i)==5) {
-          i++;
-          while (true) {
-            if (i>=chans) break;
-            if (getChannelType(i)!=5) break;
-            i++;
+        delete[] outBuf[0];
+        delete[] outBuf[1];
+        delete[] stemBuf;
+
+        for (size_t i=0; i<stems.size(); i++) {
+          if (sfWrap[i].doClose()!=0) {
+            logE("could not close audio file!");
           }
-          i--;
         }
 
-        if (stopExport) break;
+        quitExportPool();
       }
 
-      delete[] outBuf[0];
-      delete[] outBuf[1];
-      delete[] outBuf[2];
-
-      for (int i=0; i<chans; i++) {
-        isMuted[i]=false;
-        if (disCont[dispatchOfChan[i]].dispatch!=NULL) {
-          disCont[dispatchOfChan[i]].dispatch->muteChannel(dispatchChanOfChan[i],false);
-        }
-      }
+      quitStems();
 
       if (initAudioBackend()) {
         for (int i=0; i<song.systemLen; i++) {
@@ -378,6 +442,8 @@ bool DivEngine::saveAudio(const char* path, int loops, DivAudioExportModes mode,
   logE("Furnace was not compiled with libsndfile. cannot export!");
   return false;
 #else
+  // clean up the previous export thread (it has finished by now)
+  waitAudioFile();
   exportPath=path;
   exportMode=mode;
   exportFadeOut=fadeOutTime;
@@ -421,6 +487,8 @@ bool DivEngine::saveAudio(const char* path, int loops, DivAudioExportModes mode,
 void DivEngine::waitAudioFile() {
   if (exportThread!=NULL) {
     exportThread->join();
+    delete exportThread;
+    exportThread=NULL;
   }
 }
 
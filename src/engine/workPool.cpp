@@ -18,90 +18,76 @@
  */
 
 #include "workPool.h"
+#include "allocTrap.h"
 #include "../ta-log.h"
 #include <thread>
+#include <chrono>
 
 void* _workThread(void* inst) {
   ((DivWorkThread*)inst)->run();
   return NULL;
 }
 
+bool DivWorkQueue::push(const DivPendingTask& task) {
+  size_t w=writePos.load(std::memory_order_relaxed);
+  if (w-readPos.load(std::memory_order_acquire)>=DIV_WORK_QUEUE_SIZE) return false;
+  func[w%DIV_WORK_QUEUE_SIZE].store(task.func,std::memory_order_relaxed);
+  funcArg[w%DIV_WORK_QUEUE_SIZE].store(task.funcArg,std::memory_order_relaxed);
+  writePos.store(w+1,std::memory_order_release);
+  return true;
+}
+
+bool DivWorkQueue::take(DivPendingTask& task) {
+  size_t r=readPos.load(std::memory_order_acquire);
+  while (r<writePos.load(std::memory_order_acquire)) {
+    task.func=func[r%DIV_WORK_QUEUE_SIZE].load(std::memory_order_relaxed);
+    task.funcArg=funcArg[r%DIV_WORK_QUEUE_SIZE].load(std::memory_order_relaxed);
+    // if someone else got it first, r is updated and we try again
+    if (readPos.compare_exchange_weak(r,r+1,std::memory_order_acq_rel,std::memory_order_acquire)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool DivWorkQueue::empty() {
+  return readPos.load(std::memory_order_acquire)>=writePos.load(std::memory_order_acquire);
+}
+
 void DivWorkThread::run() {
-  //std::unique_lock<std::mutex> unique(selfLock);
   DivPendingTask task;
-  bool setFuckingPromise=false;
 
   logV("running work thread");
 
   while (true) {
-    lock.lock();
-    if (tasks.empty()) {
-      lock.unlock();
-      isBusy=false;
-      if (setFuckingPromise) {
-        parent->notify.set_value();
-        setFuckingPromise=false;
-        //std::this_thread::yield();
-      }
-      if (terminate) {
-        break;
-      }
-      std::future<void> future=notify.get_future();
-      future.wait();
-      lock.lock();
-      notify=std::promise<void>();
-      promiseAlreadySet=false;
-      lock.unlock();
+    if (parent->take(index,task)) {
+      parent->run(task);
       continue;
-    } else {
-      task=tasks.front();
-      tasks.pop();
-      lock.unlock();
-
-      task.func(task.funcArg);
-
-      int busyCount=--parent->busyCount;
-      if (busyCount<0) {
-        logE("oh no PROBLEM...");
-      }
-      if (busyCount==0) {
-        setFuckingPromise=true;
-      }
     }
-  }
-}
+    if (parent->terminate) break;
 
-bool DivWorkThread::assign(void (*what)(void*), void* arg) {
-  lock.lock();
-  if (tasks.size()>=30) {
-    lock.unlock();
-    return false;
+    // no work. spin for a bit and then sleep.
+    std::chrono::steady_clock::time_point idleBegin=std::chrono::steady_clock::now();
+    for (int i=0; i<DIV_WORK_SPIN_COUNT; i++) {
+      if (parent->queued>0 || parent->terminate) break;
+      if ((i&63)==63) std::this_thread::yield();
+    }
+    if (parent->queued<=0 && !parent->terminate) {
+      parent->park();
+    }
+    parent->statIdleTime+=std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now()-idleBegin).count();
   }
-  tasks.push(DivPendingTask(what,arg));
-  parent->busyCount++;
-  isBusy=true;
-  lock.unlock();
-  return true;
-}
-
-void DivWorkThread::wait() {
-  if (!isBusy) return;
-}
-
-bool DivWorkThread::busy() {
-  return isBusy;
 }
 
 void DivWorkThread::finish() {
-  lock.lock();
-  terminate=true;
-  notify.set_value();
-  lock.unlock();
   thread->join();
+  delete thread;
+  thread=NULL;
 }
 
-bool DivWorkThread::init(DivWorkPool* p) {
+bool DivWorkThread::init(DivWorkPool* p, unsigned int i) {
   parent=p;
+  index=i;
   try {
     thread=new std::thread(_workThread,this);
   } catch (std::system_error& e) {
@@ -112,6 +98,36 @@ bool DivWorkThread::init(DivWorkPool* p) {
   return true;
 }
 
+bool DivWorkPool::take(unsigned int start, DivPendingTask& task) {
+  for (unsigned int i=0; i<count; i++) {
+    unsigned int which=(start+i)%count;
+    if (workThreads[which].tasks.take(task)) {
+      --queued;
+      if (i>0) statSteals++;
+      return true;
+    }
+  }
+  return false;
+}
+
+void DivWorkPool::run(DivPendingTask& task) {
+  DIV_ALLOC_TRAP_SCOPE(trapAlloc.load(std::memory_order_relaxed));
+  task.func(task.funcArg);
+  if (--pending<0) {
+    logE("oh no PROBLEM...");
+  }
+}
+
+void DivWorkPool::park() {
+  std::unique_lock<std::mutex> unique(parkLock);
+  parked++;
+  statParks++;
+  while (queued<=0 && !terminate) {
+    parkCond.wait(unique);
+  }
+  parked--;
+}
+
 void DivWorkPool::push(void (*what)(void*), void* arg) {
   // if no work threads, just execute
   if (!threaded) {
@@ -119,66 +135,77 @@ void DivWorkPool::push(void (*what)(void*), void* arg) {
     return;
   }
 
+  trapAlloc.store(DIV_ALLOC_TRAP_ACTIVE,std::memory_order_relaxed);
+  pending++;
   for (unsigned int tryCount=0; tryCount<count; tryCount++) {
     if (pos>=count) pos=0;
-    if (workThreads[pos++].assign(what,arg)) return;
+    if (workThreads[pos++].tasks.push(DivPendingTask(what,arg))) {
+      queued++;
+      if (parked>0) {
+        std::lock_guard<std::mutex> guard(parkLock);
+        parkCond.notify_one();
+      }
+      return;
+    }
   }
 
-  // all threads are busy
-  logW("DivWorkPool: all work threads busy!");
+  // all queues are full
+  logW("DivWorkPool: all work queues full!");
+  statInline++;
   what(arg);
+  pending--;
 }
 
 bool DivWorkPool::busy() {
   if (!threaded) return false;
-  for (unsigned int i=0; i<count; i++) {
-    if (workThreads[i].busy()) return true;
-  }
-  return false;
+  return pending>0;
 }
 
 void DivWorkPool::wait() {
   if (!threaded) return;
 
-  if (busyCount==0) {
-    return;
-  }
-
-  std::future<void> future=notify.get_future();
-
-  // start running
-  for (unsigned int i=0; i<count; i++) {
-    if (!workThreads[i].promiseAlreadySet && !workThreads[i].tasks.empty()) {
-      try {
-        workThreads[i].lock.lock();
-        workThreads[i].promiseAlreadySet=true;
-        workThreads[i].notify.set_value();
-        workThreads[i].lock.unlock();
-      } catch (std::exception& e) {
-        logE("ERROR IN THREAD SYNC! %s",e.what());
-        abort();
-      }
+  // help out while there are tasks left
+  DivPendingTask task;
+  unsigned int spin=0;
+  while (pending>0) {
+    if (take(0,task)) {
+      run(task);
+      continue;
     }
+    if ((++spin&63)==0) std::this_thread::yield();
   }
-  //std::this_thread::yield();
 
-  // wait
-  future.wait();
+  pos=0;
+}
 
-  notify=std::promise<void>();
+unsigned int DivWorkPool::getThreadCount() {
+  return threaded?count:0;
+}
 
-  pos=0;
+void DivWorkPool::getStats(unsigned int& steals, unsigned int& parks, unsigned int& inlined, unsigned long long& idleTime) {
+  steals=statSteals;
+  parks=statParks;
+  inlined=statInline;
+  idleTime=statIdleTime;
 }
 
 DivWorkPool::DivWorkPool(unsigned int threads):
   threaded(threads>0),
   count(threads),
   pos(0),
-  busyCount(0) {
+  pending(0),
+  queued(0),
+  parked(0),
+  terminate(false),
+  trapAlloc(false),
+  statSteals(0),
+  statParks(0),
+  statInline(0),
+  statIdleTime(0) {
   if (threaded) {
     workThreads=new DivWorkThread[threads];
     for (unsigned int i=0; i<count; i++) {
-      if (!workThreads[i].init(this)) { 
+      if (!workThreads[i].init(this,i)) {
         count=i;
         break;
       }
@@ -196,6 +223,12 @@ DivWorkPool::DivWorkPool(unsigned int threads):
 
 DivWorkPool::~DivWorkPool() {
   if (threaded) {
+    wait();
+    {
+      std::lock_guard<std::mutex> guard(parkLock);
+      terminate=true;
+      parkCond.notify_all();
+    }
     for (unsigned int i=0; i<count; i++) {
       workThreads[i].finish();
     }
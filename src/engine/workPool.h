@@ -22,10 +22,13 @@
 
 #include <thread>
 #include <atomic>
-#include <functional>
-#include <future>
+#include <mutex>
+#include <condition_variable>
 
-#include "../fixedQueue.h"
+// tasks per work thread queue
+#define DIV_WORK_QUEUE_SIZE 64
+// how many times to look for work before parking a thread
+#define DIV_WORK_SPIN_COUNT 4096
 
 class DivWorkPool;
 
@@ -40,32 +43,53 @@ struct DivPendingTask {
     funcArg(NULL) {}
 };
 
+/**
+ * a lock-free task queue with one producer and many consumers.
+ * the producer is whoever calls DivWorkPool::push(), and the consumers are
+ * the owning work thread plus anyone stealing from it.
+ */
+struct DivWorkQueue {
+  std::atomic<void (*)(void*)> func[DIV_WORK_QUEUE_SIZE];
+  std::atomic<void*> funcArg[DIV_WORK_QUEUE_SIZE];
+  std::atomic<size_t> readPos, writePos;
+
+  // producer only. returns false if the queue is full.
+  bool push(const DivPendingTask& task);
+  // any thread. returns false if the queue is empty.
+  bool take(DivPendingTask& task);
+  bool empty();
+
+  DivWorkQueue():
+    readPos(0),
+    writePos(0) {
+    for (int i=0; i<DIV_WORK_QUEUE_SIZE; i++) {
+      func[i]=NULL;
+      funcArg[i]=NULL;
+    }
+  }
+};
+
 struct DivWorkThread {
   DivWorkPool* parent;
-  std::mutex lock;
   std::thread* thread;
-  std::promise<void> notify;
-  FixedQueue<DivPendingTask,32> tasks;
-  std::atomic<bool> isBusy;
-  bool terminate;
-  bool promiseAlreadySet;
+  DivWorkQueue tasks;
+  unsigned int index;
 
   void run();
-  bool assign(void (*what)(void*), void* arg);
-  void wait();
-  bool busy();
   void finish();
 
-  bool init(DivWorkPool* p);
+  bool init(DivWorkPool* p, unsigned int i);
   DivWorkThread():
     parent(NULL),
-    isBusy(false),
-    terminate(false),
-    promiseAlreadySet(false) {}
+    thread(NULL),
+    index(0) {}
 };
 
 /**
  * this class provides an implementation of a "thread pool" for executing tasks in parallel.
+ * each work thread has its own lock-free queue, and steals from the others when its queue is empty.
+ * idle threads spin for a while before going to sleep.
+ * push() and wait() shall only be called from a single thread.
  * it is highly recommended to use `new` when allocating a DivWorkPool.
  */
 class DivWorkPool {
@@ -73,26 +97,76 @@ class DivWorkPool {
   unsigned int count;
   unsigned int pos;
   DivWorkThread* workThreads;
+
+  // tasks which were pushed but not finished yet
+  std::atomic<int> pending;
+  // tasks which were pushed but not taken yet
+  std::atomic<int> queued;
+  // threads which are sleeping
+  std::atomic<int> parked;
+  std::atomic<bool> terminate;
+  // whether the tasks come from a thread under an allocation trap
+  std::atomic<bool> trapAlloc;
+  std::mutex parkLock;
+  std::condition_variable parkCond;
+
+  // statistics
+  std::atomic<unsigned int> statSteals;
+  std::atomic<unsigned int> statParks;
+  std::atomic<unsigned int> statInline;
+  std::atomic<unsigned long long> statIdleTime;
+
+  friend struct DivWorkThread;
+
+  /**
+   * take a task, starting with the queue of the specified thread.
+   * @param start index of the first queue to look at.
+   * @param task where to put the task.
+   * @return whether a task was taken.
+   */
+  bool take(unsigned int start, DivPendingTask& task);
+
+  /**
+   * run a task taken from a queue.
+   */
+  void run(DivPendingTask& task);
+
+  /**
+   * put the calling work thread to sleep until there are tasks.
+   */
+  void park();
   public:
-    std::promise<void> notify;
-    std::atomic<int> busyCount;
-    
     /**
      * push a new job to this work pool.
-     * if all work threads are busy, this will block until one is free.
+     * if all queues are full, the job will be executed immediately.
      */
     void push(void (*what)(void*), void* arg);
-    
+
     /**
      * check whether this work pool is busy.
      */
     bool busy();
 
     /**
-     * wait for all work threads to finish.
+     * wait for all jobs to finish.
+     * the calling thread will execute pending jobs while waiting.
      */
     void wait();
 
+    /**
+     * get the number of work threads.
+     */
+    unsigned int getThreadCount();
+
+    /**
+     * get statistics.
+     * @param steals number of tasks taken from another thread's queue.
+     * @param parks number of times a work thread went to sleep.
+     * @param inlined number of tasks executed on push because the queues were full.
+     * @param idleTime total time work threads spent without work, in nanoseconds.
+     */
+    void getStats(unsigned int& steals, unsigned int& parks, unsigned int& inlined, unsigned long long& idleTime);
+
     DivWorkPool(unsigned int threads=0);
     ~DivWorkPool();
 };
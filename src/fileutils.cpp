@@ -23,12 +23,17 @@
 #include <windows.h>
 #include <shlobj.h>
 #include <shlwapi.h>
+#include <psapi.h>
+#include <errno.h>
 #else
 #include <unistd.h>
 #include <fcntl.h>
 #include <errno.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
 #endif
+#include <time.h>
 
 FILE* ps_fopen(const char* path, const char* mode) {
 #ifdef _WIN32
@@ -124,3 +129,149 @@ int touchFile(const char* path) {
   return 0;
 #endif
 }
+
+long getFileAge(const char* path) {
+#ifdef _WIN32
+  WIN32_FILE_ATTRIBUTE_DATA attr;
+  if (GetFileAttributesExW(utf8To16(path).c_str(),GetFileExInfoStandard,&attr)==0) return -1;
+  FILETIME now;
+  GetSystemTimeAsFileTime(&now);
+  ULARGE_INTEGER then, cur;
+  then.LowPart=attr.ftLastWriteTime.dwLowDateTime;
+  then.HighPart=attr.ftLastWriteTime.dwHighDateTime;
+  cur.LowPart=now.dwLowDateTime;
+  cur.HighPart=now.dwHighDateTime;
+  // 100ns units
+  if (cur.QuadPart<then.QuadPart) return 0;
+  return (long)((cur.QuadPart-then.QuadPart)/10000000ULL);
+#else
+  struct stat st;
+  if (stat(path,&st)<0) return -1;
+  time_t now=time(NULL);
+  if (now<st.st_mtime) return 0;
+  return (long)(now-st.st_mtime);
+#endif
+}
+
+// fallback for files which can't be mapped
+static int readWholeFile(FILE* f, unsigned char*& data, size_t& len) {
+  if (fseek(f,0,SEEK_END)<0) return -errno;
+  long size=ftell(f);
+  if (size<0) return -errno;
+  if (fseek(f,0,SEEK_SET)<0) return -errno;
+  len=size;
+  if (len==0) return 0;
+  data=new unsigned char[len];
+  if (fread(data,1,len,f)!=len) {
+    delete[] data;
+    data=NULL;
+    len=0;
+    return -EIO;
+  }
+  return 0;
+}
+
+int mapFile(const char* path, unsigned char*& data, size_t& len, bool& mapped) {
+  data=NULL;
+  len=0;
+  mapped=false;
+#ifdef _WIN32
+  HANDLE h=CreateFileW(utf8To16(path).c_str(),GENERIC_READ,FILE_SHARE_READ,NULL,OPEN_EXISTING,FILE_FLAG_SEQUENTIAL_SCAN,NULL);
+  if (h==INVALID_HANDLE_VALUE) {
+    switch (GetLastError()) {
+      case ERROR_FILE_NOT_FOUND:
+      case ERROR_PATH_NOT_FOUND:
+        return -ENOENT;
+        break;
+      case ERROR_ACCESS_DENIED:
+        return -EACCES;
+        break;
+    }
+    return -EIO;
+  }
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(h,&size)) {
+    CloseHandle(h);
+    return -EIO;
+  }
+  if (size.QuadPart==0) {
+    CloseHandle(h);
+    return 0;
+  }
+  HANDLE m=CreateFileMappingW(h,NULL,PAGE_READONLY,0,0,NULL);
+  if (m!=NULL) {
+    data=(unsigned char*)MapViewOfFile(m,FILE_MAP_READ,0,0,0);
+    // the view keeps the file open
+    CloseHandle(m);
+  }
+  CloseHandle(h);
+  if (data!=NULL) {
+    len=size.QuadPart;
+    mapped=true;
+    return 0;
+  }
+#else
+  int fd=open(path,O_RDONLY);
+  if (fd<0) return -errno;
+  struct stat st;
+  if (fstat(fd,&st)<0) {
+    int ret=-errno;
+    close(fd);
+    return ret;
+  }
+  if (S_ISREG(st.st_mode)) {
+    if (st.st_size==0) {
+      close(fd);
+      return 0;
+    }
+    void* m=mmap(NULL,st.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+    if (m!=MAP_FAILED) {
+#ifdef MADV_SEQUENTIAL
+      madvise(m,st.st_size,MADV_SEQUENTIAL);
+#endif
+      close(fd);
+      data=(unsigned char*)m;
+      len=st.st_size;
+      mapped=true;
+      return 0;
+    }
+  }
+  close(fd);
+#endif
+  // couldn't map. read it instead
+  FILE* f=ps_fopen(path,"rb");
+  if (f==NULL) return -errno;
+  int ret=readWholeFile(f,data,len);
+  fclose(f);
+  return ret;
+}
+
+void unmapFile(unsigned char* data, size_t len, bool mapped) {
+  if (data==NULL) return;
+  if (mapped) {
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+#else
+    munmap(data,len);
+#endif
+  } else {
+    delete[] data;
+  }
+}
+
+size_t getPeakRSS() {
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS pmc;
+  if (!GetProcessMemoryInfo(GetCurrentProcess(),&pmc,sizeof(pmc))) return 0;
+  return pmc.PeakWorkingSetSize;
+#else
+  struct rusage ru;
+  if (getrusage(RUSAGE_SELF,&ru)<0) return 0;
+#ifdef __APPLE__
+  // already in bytes
+  return ru.ru_maxrss;
+#else
+  return (size_t)ru.ru_maxrss*1024;
+#endif
+#endif
+}
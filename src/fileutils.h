@@ -20,6 +20,7 @@
 #ifndef _FILEUTILS_H
 #define _FILEUTILS_H
 #include <stdio.h>
+#include <stddef.h>
 
 FILE* ps_fopen(const char* path, const char* mode);
 bool moveFiles(const char* src, const char* dest);
@@ -29,5 +30,14 @@ int fileExists(const char* path);
 bool dirExists(const char* what);
 bool makeDir(const char* path);
 int touchFile(const char* path);
+// returns how many seconds ago a file was last modified, or -1 on error.
+long getFileAge(const char* path);
+// maps a file into memory for reading, or reads it whole if it can't be mapped.
+// returns 0 on success or a negative errno. an empty file gives data=NULL.
+// the data must be released with unmapFile().
+int mapFile(const char* path, unsigned char*& data, size_t& len, bool& mapped);
+void unmapFile(unsigned char* data, size_t len, bool mapped);
+// peak resident memory of this process in bytes, or 0 if not available.
+size_t getPeakRSS();
 
 #endif
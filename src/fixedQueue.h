@@ -42,6 +42,7 @@ template<typename T, size_t items> struct FixedQueue {
   void clear();
   bool empty();
   size_t size();
+  size_t capacity();
   FixedQueue():
     readPos(0),
     writePos(0) {}
@@ -170,6 +171,10 @@ template <typename T, size_t items> bool FixedQueue<T,items>::empty() {
   return (readPos==writePos);
 }
 
+template <typename T, size_t items> size_t FixedQueue<T,items>::capacity() {
+  return items-1;
+}
+
 template <typename T, size_t items> size_t FixedQueue<T,items>::size() {
   if (readPos>writePos) {
     return items+writePos-readPos;
@@ -613,6 +613,10 @@ void FurnaceGUI::drawDebug() {
       ImGui::Separator();
 
       ImGui::Text("audio: %dµs",lastProcTime);
+      for (int i=0; i<DIV_PROF_MAX; i++) {
+        DivProfStats stats=e->profiler.stage[i].getStats();
+        ImGui::Text("- %s: %.0fµs (p99 %.0fµs, max %.0fµs)",DivProfiler::getStageName(i),stats.p50,stats.p99,stats.max);
+      }
       ImGui::Text("render: %.0fµs",(double)renderTimeDelta/perfFreq);
       ImGui::Text("draw: %.0fµs",(double)drawTimeDelta/perfFreq);
       ImGui::Text("layout: %.0fµs",(double)layoutTimeDelta/perfFreq);
@@ -586,6 +586,9 @@ void FurnaceGUI::doAction(int what) {
       if (cursor.xCoarse<0 || cursor.xCoarse>=e->getTotalChannelCount()) break;
       e->curPat[cursor.xCoarse].effectCols++;
               if (e->curPat[cursor.xCoarse].effectCols>DIV_MAX_EFFECTS) e->curPat[cursor.xCoarse].effectCols=DIV_MAX_EFFECTS;
+      e->lockEngine([this]() {
+        e->curPat[cursor.xCoarse].fitPatterns();
+      });
       break;
     case GUI_ACTION_PAT_DECREASE_COLUMNS:
       if (cursor.xCoarse<0 || cursor.xCoarse>=e->getTotalChannelCount()) break;
@@ -690,7 +693,9 @@ void FurnaceGUI::doAction(int what) {
         if (curIns==-1) {
           showError("too many instruments!");
         } else {
-          (*e->song.ins[curIns])=(*e->song.ins[prevIns]);
+          e->lockEngine([this,prevIns]() {
+            (*e->song.ins[curIns])=(*e->song.ins[prevIns]);
+          });
           wantScrollList=true;
           MARK_MODIFIED;
           wavePreviewInit=true;
@@ -727,6 +732,8 @@ void FurnaceGUI::doAction(int what) {
     case GUI_ACTION_INS_LIST_DELETE:
       if (curIns>=0 && curIns<(int)e->song.ins.size()) {
         e->delInstrument(curIns);
+        // the view state is keyed by address
+        macroViewState.clear();
         wantScrollList=true;
         MARK_MODIFIED;
         if (curIns>=(int)e->song.ins.size()) {
@@ -1751,6 +1751,18 @@ void FurnaceGUI::doExpandSong(int multiplier) {
   }
   finishSelection();
 
+  // make room for the new pattern length
+  e->lockEngine([this,multiplier]() {
+    int newLen=e->curSubSong->patLen*multiplier;
+    for (int i=0; i<e->getTotalChannelCount(); i++) {
+      for (int j=0; j<DIV_MAX_PATTERNS; j++) {
+        if (e->curPat[i].data[j]==NULL) continue;
+        DivPatternData& d=e->curPat[i].data[j]->data;
+        d.resize(MAX(d.getRows(),newLen),d.getCols());
+      }
+    }
+  });
+
   UndoStep us;
   us.type=GUI_UNDO_PATTERN_EXPAND_SONG;
 
@@ -241,7 +241,9 @@ void FurnaceGUI::doReplace() {
     if (touched[i.x][(patIndex<<8)|i.y]) continue;
     touched[i.x][(patIndex<<8)|i.y]=true;
 
-    memcpy(prevVal,p->data[i.y],DIV_MAX_COLS*sizeof(short));
+    for (int j=0; j<DIV_MAX_COLS; j++) {
+      prevVal[j]=p->data[i.y][j];
+    }
 
     if (queryReplaceNoteDo) {
       switch (queryReplaceNoteMode) {
@@ -27,6 +27,7 @@
 #include "util.h"
 #include "../ta-log.h"
 #include "../fileutils.h"
+#include "../engine/backupStore.h"
 #include "imgui.h"
 #include "imgui_internal.h"
 #include "ImGuiFileDialog.h"
@@ -88,6 +89,8 @@ void FurnaceGUI::centerNextWindow(const char* name, float w, float h) {
 void FurnaceGUI::bindEngine(DivEngine* eng) {
   e=eng;
   wavePreview.setEngine(e);
+  // the oscilloscopes read these
+  e->enableOscTaps(true);
 }
 
 void FurnaceGUI::enableSafeMode() {
@@ -1647,7 +1650,7 @@ void FurnaceGUI::openFileDialog(FurnaceGUIFileDialogs type) {
       }
       hasOpened=fileDialog->openLoad(
         "Restore Backup",
-        {"Furnace song", "*.fur"},
+        {"Furnace backup", "*.fbk *.fur"},
         backupPath+String(DIR_SEPARATOR_STR),
         dpiScale
       );
@@ -1722,7 +1725,10 @@ void FurnaceGUI::openFileDialog(FurnaceGUIFileDialogs type) {
                 prevIns=curIns;
               }
               if (prevIns>=0 && prevIns<=(int)e->song.ins.size()) {
-                *e->song.ins[prevIns]=*instruments[0];
+                // replacing macros may reallocate them under the playback thread
+                e->lockEngine([this,&instruments]() {
+                  *e->song.ins[prevIns]=*instruments[0];
+                });
               }
             } else {
               e->loadTempIns(instruments[0]);
@@ -2176,52 +2182,20 @@ int FurnaceGUI::load(String path) {
   bool wasPlaying=e->isPlaying();
   if (!path.empty()) {
     logI("loading module...");
-    FILE* f=ps_fopen(path.c_str(),"rb");
-    if (f==NULL) {
-      perror("error");
-      lastError=strerror(errno);
-      return 1;
-    }
-    if (fseek(f,0,SEEK_END)<0) {
-      perror("size error");
-      lastError=fmt::sprintf("on seek: %s",strerror(errno));
-      fclose(f);
-      return 1;
-    }
-    ssize_t len=ftell(f);
-    if (len==(SIZE_MAX>>1)) {
-      perror("could not get file length");
-      lastError=fmt::sprintf("on pre tell: %s",strerror(errno));
-      fclose(f);
-      return 1;
-    }
-    if (len<1) {
-      if (len==0) {
-        logE("that file is empty!");
-        lastError="file is empty";
-      } else {
-        perror("tell error");
-        lastError=fmt::sprintf("on tell: %s",strerror(errno));
+    bool loaded=false;
+    if (DivBackupStore::isBackupPoint(path)) {
+      // rebuild the song from the backup store
+      size_t len=0;
+      unsigned char* file=DivBackupStore(backupPath).restore(path,len);
+      if (file==NULL) {
+        lastError="could not restore backup";
+        return 1;
       }
-      fclose(f);
-      return 1;
-    }
-    if (fseek(f,0,SEEK_SET)<0) {
-      perror("size error");
-      lastError=fmt::sprintf("on get size: %s",strerror(errno));
-      fclose(f);
-      return 1;
-    }
-    unsigned char* file=new unsigned char[len];
-    if (fread(file,1,(size_t)len,f)!=(size_t)len) {
-      perror("read error");
-      lastError=fmt::sprintf("on read: %s",strerror(errno));
-      fclose(f);
-      delete[] file;
-      return 1;
+      loaded=e->load(file,len);
+    } else {
+      loaded=e->loadFile(path);
     }
-    fclose(f);
-    if (!e->load(file,(size_t)len)) {
+    if (!loaded) {
       lastError=e->getLastError();
       logE("could not open file!");
       return 1;
@@ -2244,6 +2218,7 @@ int FurnaceGUI::load(String path) {
   lastError="everything OK";
   undoHist.clear();
   redoHist.clear();
+  macroViewState.clear();
   updateWindowTitle();
   updateScroll(0);
   if (!e->getWarnings().empty()) {
@@ -2301,7 +2276,7 @@ void FurnaceGUI::pushRecentSys(const char* path) {
 void FurnaceGUI::delFirstBackup(String name) {
   std::vector<String> listOfFiles;
 #ifdef _WIN32
-  String findPath=backupPath+String(DIR_SEPARATOR_STR)+name+String("*.fur");
+  String findPath=backupPath+String(DIR_SEPARATOR_STR)+name+String("*.f*");
   WIN32_FIND_DATAW next;
   HANDLE backDir=FindFirstFileW(utf8To16(findPath.c_str()).c_str(),&next);
   if (backDir!=INVALID_HANDLE_VALUE) {
@@ -2320,7 +2295,10 @@ void FurnaceGUI::delFirstBackup(String name) {
     struct dirent* next=readdir(backDir);
     if (next==NULL) break;
     if (strstr(next->d_name,name.c_str())!=next->d_name) continue;
-    listOfFiles.push_back(String(next->d_name));
+    // backup points, or full backups from older versions
+    String fileName=next->d_name;
+    if (!DivBackupStore::isBackupPoint(fileName) && (fileName.size()<4 || fileName.compare(fileName.size()-4,4,".fur")!=0)) continue;
+    listOfFiles.push_back(fileName);
   }
   closedir(backDir);
 #endif
@@ -2518,7 +2496,7 @@ void FurnaceGUI::processDrags(int dragX, int dragY) {
       if (macroDragChar) {
         MACRO_DRAG(macroDragCTarget);
       } else {
-        MACRO_DRAG(macroDragTarget);
+        MACRO_DRAG((*macroDragTarget));
       }
     }
   }
@@ -4734,7 +4712,9 @@ bool FurnaceGUI::loop() {
         if (curFileDialog==GUI_FILE_INS_OPEN_REPLACE) {
           if (prevInsData!=NULL) {
             if (prevIns>=0 && prevIns<(int)e->song.ins.size()) {
-              *e->song.ins[prevIns]=*prevInsData;
+              e->lockEngine([this]() {
+                *e->song.ins[prevIns]=*prevInsData;
+              });
             }
           }
         } else {
@@ -5141,7 +5121,9 @@ bool FurnaceGUI::loop() {
                   pendingInsSingle=true;
                 } else { // replace with the only instrument
                   if (curIns>=0 && curIns<(int)e->song.ins.size()) {
-                    *e->song.ins[curIns]=*instruments[0];
+                    e->lockEngine([this,&instruments]() {
+                      *e->song.ins[curIns]=*instruments[0];
+                    });
                   } else {
                     showError("...but you haven't selected an instrument!");
                   }
@@ -5407,6 +5389,7 @@ bool FurnaceGUI::loop() {
         e->createNewFromDefaults();
         undoHist.clear();
         redoHist.clear();
+        macroViewState.clear();
         curFileName="";
         modified=false;
         curNibble=false;
@@ -5736,11 +5719,7 @@ bool FurnaceGUI::loop() {
               e->lockEngine([this]() {
                 for (int i=0; i<e->getTotalChannelCount(); i++) {
                   DivPattern* pat=e->curPat[i].getPattern(e->curOrders->ord[i][curOrder],true);
-                  memset(pat->data,-1,DIV_MAX_ROWS*DIV_MAX_COLS*sizeof(short));
-                  for (int j=0; j<DIV_MAX_ROWS; j++) {
-                    pat->data[j][0]=0;
-                    pat->data[j][1]=0;
-                  }
+                  pat->clear();
                 }
               });
               MARK_MODIFIED;
@@ -6060,7 +6039,9 @@ bool FurnaceGUI::loop() {
           if (!i.second || pendingInsSingle) {
             if (i.second) {
               if (curIns>=0 && curIns<(int)e->song.ins.size()) {
-                *e->song.ins[curIns]=*i.first;
+                e->lockEngine([this,&i]() {
+                  *e->song.ins[curIns]=*i.first;
+                });
               } else {
                 showError("...but you haven't selected an instrument!");
               }
@@ -6250,7 +6231,8 @@ bool FurnaceGUI::loop() {
               }
             }
             logD("saving backup...");
-            SafeWriter* w=e->saveFur(true,true);
+            std::vector<size_t> blockPtrs;
+            SafeWriter* w=e->saveFur(true,true,&blockPtrs);
             logV("writing file...");
 
             if (w!=NULL) {
@@ -6283,34 +6265,34 @@ bool FurnaceGUI::loop() {
 #ifdef _WIN32
               struct tm* tempTM=localtime(&curTime);
               if (tempTM==NULL) {
-                backupFileName+="-unknownTime.fur";
+                backupFileName+="-unknownTime" DIV_BACKUP_EXT;
               } else {
                 curTM=*tempTM;
-                backupFileName+=fmt::sprintf("-%d%.2d%.2d-%.2d%.2d%.2d.fur",curTM.tm_year+1900,curTM.tm_mon+1,curTM.tm_mday,curTM.tm_hour,curTM.tm_min,curTM.tm_sec);
+                backupFileName+=fmt::sprintf("-%d%.2d%.2d-%.2d%.2d%.2d" DIV_BACKUP_EXT,curTM.tm_year+1900,curTM.tm_mon+1,curTM.tm_mday,curTM.tm_hour,curTM.tm_min,curTM.tm_sec);
               }
 #else
               if (localtime_r(&curTime,&curTM)==NULL) {
-                backupFileName+="-unknownTime.fur";
+                backupFileName+="-unknownTime" DIV_BACKUP_EXT;
               } else {
-                backupFileName+=fmt::sprintf("-%d%.2d%.2d-%.2d%.2d%.2d.fur",curTM.tm_year+1900,curTM.tm_mon+1,curTM.tm_mday,curTM.tm_hour,curTM.tm_min,curTM.tm_sec);
+                backupFileName+=fmt::sprintf("-%d%.2d%.2d-%.2d%.2d%.2d" DIV_BACKUP_EXT,curTM.tm_year+1900,curTM.tm_mon+1,curTM.tm_mday,curTM.tm_hour,curTM.tm_min,curTM.tm_sec);
               }
 #endif
 
               String finalPath=backupPath+String(DIR_SEPARATOR_STR)+backupFileName;
-              
-              FILE* outFile=ps_fopen(finalPath.c_str(),"wb");
-              if (outFile!=NULL) {
-                if (fwrite(w->getFinalBuf(),1,w->size(),outFile)!=w->size()) {
-                  logW("did not write backup entirely: %s!",strerror(errno));
-                }
-                fclose(outFile);
+
+              // only the blocks which changed since the last backup are written
+              DivBackupStore store(backupPath);
+              int newChunks=store.save(finalPath,w->getFinalBuf(),w->size(),blockPtrs);
+              if (newChunks<0) {
+                logW("could not save backup!");
               } else {
-                logW("could not save backup: %s!",strerror(errno));
+                logV("%d new chunks",newChunks);
               }
               w->finish();
 
               // delete previous backup if there are too many
               delFirstBackup(backupBaseName);
+              store.collectGarbage();
             }
             logD("backup saved.");
             backupTimer=30.0;
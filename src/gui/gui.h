@@ -42,13 +42,12 @@
 #define handleUnimportant if (settings.insFocusesPattern && patternOpen) {nextWindow=GUI_WINDOW_PATTERN;}
 #define unimportant(x) if (x) {handleUnimportant}
 
-#define MARK_MODIFIED modified=true;
+#define MARK_MODIFIED modified=true; e->invalidateCheckpoints();
 #define WAKE_UP drawHalt=16;
 
 #define RESET_WAVE_MACRO_ZOOM \
   for (DivInstrument* _wi: e->song.ins) { \
-    _wi->std.waveMacro.vZoom=-1; \
-    _wi->std.waveMacro.vScroll=-1; \
+    resetMacroZoom(&_wi->std.waveMacro); \
   }
 
 #define CHECK_LONG_HOLD (mobileUI && ImGui::GetIO().MouseDown[ImGuiMouseButton_Left] && ImGui::GetIO().MouseDownDuration[ImGuiMouseButton_Left]>=longThreshold && ImGui::GetIO().MouseDownDurationPrev[ImGuiMouseButton_Left]<longThreshold && ImGui::GetIO().MouseDragMaxDistanceSqr[ImGuiMouseButton_Left]<=ImGui::GetIO().ConfigInertialScrollToleranceSqr)
@@ -1297,6 +1296,19 @@ struct FurnaceGUIMacroEditState {
     selectedMacro(0) {}
 };
 
+// per-macro view state (not saved in the file)
+struct FurnaceGUIMacroViewState {
+  int vScroll, vZoom;
+  int typeMemory[16];
+  unsigned char lenMemory;
+  FurnaceGUIMacroViewState():
+    vScroll(0),
+    vZoom(-1),
+    lenMemory(0) {
+    memset(typeMemory,0,16*sizeof(int));
+  }
+};
+
 enum FurnaceGUIFindQueryModes {
   GUI_QUERY_IGNORE=0,
   GUI_QUERY_MATCH,
@@ -1693,6 +1705,7 @@ class FurnaceGUI {
     int oplStandardWaveNames;
     int cursorMoveNoScroll;
     int lowLatency;
+    int chipSleep;
     int notePreviewBehavior;
     int powerSave;
     int absorbInsInput;
@@ -1764,6 +1777,8 @@ class FurnaceGUI {
     int wasapiEx;
     int chanOscThreads;
     int renderPoolThreads;
+    int renderTickAhead;
+    int renderAhead;
     int showPool;
     int writeInsNames;
     int readInsNames;
@@ -1894,6 +1909,7 @@ class FurnaceGUI {
       oplStandardWaveNames(0),
       cursorMoveNoScroll(0),
       lowLatency(0),
+      chipSleep(0),
       notePreviewBehavior(1),
       powerSave(1),
       absorbInsInput(0),
@@ -1964,6 +1980,8 @@ class FurnaceGUI {
       wasapiEx(0),
       chanOscThreads(0),
       renderPoolThreads(0),
+      renderTickAhead(0),
+      renderAhead(0),
       showPool(0),
       writeInsNames(0),
       readInsNames(1),
@@ -2155,7 +2173,7 @@ class FurnaceGUI {
   ImVec2 macroDragStart;
   ImVec2 macroDragAreaSize;
   unsigned char* macroDragCTarget;
-  int* macroDragTarget;
+  DivMacroData* macroDragTarget;
   int macroDragLen;
   int macroDragMin, macroDragMax;
   int macroDragLastX, macroDragLastY;
@@ -2184,6 +2202,7 @@ class FurnaceGUI {
   bool macroLoopDragActive;
 
   FurnaceGUIMacroEditState macroEditStateFM, macroEditStateOP[4], macroEditStateMacros;
+  std::map<const DivInstrumentMacro*,FurnaceGUIMacroViewState> macroViewState;
 
   ImVec2 waveDragStart;
   ImVec2 waveDragAreaSize;
@@ -2484,6 +2503,8 @@ class FurnaceGUI {
 
   void patternRow(int i, bool isPlaying, float lineHeight, int chans, int ord, const DivPattern** patCache, bool inhibitSel);
 
+  FurnaceGUIMacroViewState& getMacroViewState(const DivInstrumentMacro* macro);
+  void resetMacroZoom(const DivInstrumentMacro* macro);
   void drawMacroEdit(FurnaceGUIMacroDesc& i, int totalFit, float availableWidth, int index);
   void drawMacros(std::vector<FurnaceGUIMacroDesc>& macros, FurnaceGUIMacroEditState& state);
   void alterSampleMap(int column, int val);
@@ -434,8 +434,8 @@ const char* macroQSoundMode="QSound";
 const char* macroDummyMode="Bug";
 
 String macroHoverNote(int id, float val, void* u) {
-  int* macroVal=(int*)u;
-  if ((macroVal[id]&0xc0000000)==0x40000000 || (macroVal[id]&0xc0000000)==0x80000000) {
+  int macroVal=((DivMacroData*)u)->get(id);
+  if ((macroVal&0xc0000000)==0x40000000 || (macroVal&0xc0000000)==0x80000000) {
     if (val<-60 || val>=120) return "???";
     return fmt::sprintf("%d: %s",id,noteNames[(int)val+60]);
   }
@@ -1522,12 +1522,24 @@ void FurnaceGUI::drawFMPreview(const ImVec2& size) {
   ImGui::PlotLines("##DebugFMPreview",asFloat,FM_PREVIEW_SIZE,0,NULL,-1.0,1.0,size);
 }
 
+FurnaceGUIMacroViewState& FurnaceGUI::getMacroViewState(const DivInstrumentMacro* macro) {
+  return macroViewState[macro];
+}
+
+void FurnaceGUI::resetMacroZoom(const DivInstrumentMacro* macro) {
+  auto it=macroViewState.find(macro);
+  if (it!=macroViewState.end()) {
+    it->second.vZoom=-1;
+  }
+}
+
 void FurnaceGUI::drawMacroEdit(FurnaceGUIMacroDesc& i, int totalFit, float availableWidth, int index) {
   static float asFloat[256];
   static int asInt[256];
   static float loopIndicator[256];
   static float bit30Indicator[256];
   static bool doHighlight[256];
+  FurnaceGUIMacroViewState& view=getMacroViewState(i.macro);
 
   if ((i.macro->open&6)==0) {
     for (int j=0; j<256; j++) {
@@ -1548,20 +1560,20 @@ void FurnaceGUI::drawMacroEdit(FurnaceGUIMacroDesc& i, int totalFit, float avail
     }
     ImGui::PushStyleVar(ImGuiStyleVar_FramePadding,ImVec2(0.0f,0.0f));
 
-    if (i.macro->vZoom<1) {
+    if (view.vZoom<1) {
       if (i.macro->macroType==DIV_MACRO_ARP || i.isArp) {
-        i.macro->vZoom=24;
-        i.macro->vScroll=120-12;
+        view.vZoom=24;
+        view.vScroll=120-12;
       } else if (i.macro->macroType==DIV_MACRO_PITCH || i.isPitch) {
-        i.macro->vZoom=128;
-        i.macro->vScroll=2048-64;
+        view.vZoom=128;
+        view.vScroll=2048-64;
       } else {
-        i.macro->vZoom=i.max-i.min;
-        i.macro->vScroll=0;
+        view.vZoom=i.max-i.min;
+        view.vScroll=0;
       }
     }
-    if (i.macro->vZoom>(i.max-i.min)) {
-      i.macro->vZoom=i.max-i.min;
+    if (view.vZoom>(i.max-i.min)) {
+      view.vZoom=i.max-i.min;
     }
 
     memset(doHighlight,0,256*sizeof(bool));
@@ -1589,7 +1601,7 @@ void FurnaceGUI::drawMacroEdit(FurnaceGUIMacroDesc& i, int totalFit, float avail
     if (i.isBitfield) {
       PlotBitfield("##IMacro",asInt,totalFit,0,i.bitfieldBits,i.max,ImVec2(availableWidth,(i.macro->open&1)?(i.height*dpiScale):(32.0f*dpiScale)),sizeof(float),doHighlight);
     } else {
-      PlotCustom("##IMacro",asFloat,totalFit,macroDragScroll,NULL,i.min+i.macro->vScroll,i.min+i.macro->vScroll+i.macro->vZoom,ImVec2(availableWidth,(i.macro->open&1)?(i.height*dpiScale):(32.0f*dpiScale)),sizeof(float),i.color,i.macro->len-macroDragScroll,i.hoverFunc,i.hoverFuncUser,i.blockMode,(i.macro->open&1)?genericGuide:NULL,doHighlight);
+      PlotCustom("##IMacro",asFloat,totalFit,macroDragScroll,NULL,i.min+view.vScroll,i.min+view.vScroll+view.vZoom,ImVec2(availableWidth,(i.macro->open&1)?(i.height*dpiScale):(32.0f*dpiScale)),sizeof(float),i.color,i.macro->len-macroDragScroll,i.hoverFunc,i.hoverFuncUser,i.blockMode,(i.macro->open&1)?genericGuide:NULL,doHighlight);
     }
     if ((i.macro->open&1) && (ImGui::IsItemClicked(ImGuiMouseButton_Left) || ImGui::IsItemClicked(ImGuiMouseButton_Right))) {
       ImGui::InhibitInertialScroll();
@@ -1599,8 +1611,8 @@ void FurnaceGUI::drawMacroEdit(FurnaceGUIMacroDesc& i, int totalFit, float avail
         macroDragMin=i.min;
         macroDragMax=i.max;
       } else {
-        macroDragMin=i.min+i.macro->vScroll;
-        macroDragMax=i.min+i.macro->vScroll+i.macro->vZoom;
+        macroDragMin=i.min+view.vScroll;
+        macroDragMax=i.min+view.vScroll+view.vZoom;
       }
       macroDragBitOff=i.bitOffset;
       macroDragBitMode=i.isBitfield;
@@ -1610,7 +1622,7 @@ void FurnaceGUI::drawMacroEdit(FurnaceGUIMacroDesc& i, int totalFit, float avail
       macroDragActive=true;
       macroDragBit30=i.bit30;
       macroDragSettingBit30=false;
-      macroDragTarget=i.macro->val;
+      macroDragTarget=&i.macro->val;
       macroDragChar=false;
       macroDragLineMode=(i.isBitfield)?false:ImGui::IsItemClicked(ImGuiMouseButton_Right);
       macroDragLineInitial=ImVec2(0,0);
@@ -1621,11 +1633,11 @@ void FurnaceGUI::drawMacroEdit(FurnaceGUIMacroDesc& i, int totalFit, float avail
       if (ImGui::IsItemHovered()) {
         if (ctrlWheeling) {
           if (ImGui::IsKeyDown(ImGuiKey_LeftShift) || ImGui::IsKeyDown(ImGuiKey_RightShift)) {
-            i.macro->vZoom+=wheelY*(1+(i.macro->vZoom>>4));
-            if (i.macro->vZoom<1) i.macro->vZoom=1;
-            if (i.macro->vZoom>(i.max-i.min)) i.macro->vZoom=i.max-i.min;
-            if ((i.macro->vScroll+i.macro->vZoom)>(i.max-i.min)) {
-              i.macro->vScroll=(i.max-i.min)-i.macro->vZoom;
+            view.vZoom+=wheelY*(1+(view.vZoom>>4));
+            if (view.vZoom<1) view.vZoom=1;
+            if (view.vZoom>(i.max-i.min)) view.vZoom=i.max-i.min;
+            if ((view.vScroll+view.vZoom)>(i.max-i.min)) {
+              view.vScroll=(i.max-i.min)-view.vZoom;
             }
           } else {
             macroPointSize+=wheelY;
@@ -1633,9 +1645,9 @@ void FurnaceGUI::drawMacroEdit(FurnaceGUIMacroDesc& i, int totalFit, float avail
             if (macroPointSize>256) macroPointSize=256;
           }
         } else if ((ImGui::IsKeyDown(ImGuiKey_LeftShift) || ImGui::IsKeyDown(ImGuiKey_RightShift)) && wheelY!=0) {
-          i.macro->vScroll+=wheelY*(1+(i.macro->vZoom>>4));
-          if (i.macro->vScroll<0) i.macro->vScroll=0;
-          if (i.macro->vScroll>((i.max-i.min)-i.macro->vZoom)) i.macro->vScroll=(i.max-i.min)-i.macro->vZoom;
+          view.vScroll+=wheelY*(1+(view.vZoom>>4));
+          if (view.vScroll<0) view.vScroll=0;
+          if (view.vScroll>((i.max-i.min)-view.vZoom)) view.vScroll=(i.max-i.min)-view.vZoom;
         }
       }
 
@@ -1643,18 +1655,18 @@ void FurnaceGUI::drawMacroEdit(FurnaceGUIMacroDesc& i, int totalFit, float avail
       if (!i.isBitfield) {
         if (settings.oldMacroVSlider) {
           ImGui::SameLine(0.0f);
-          if (ImGui::VSliderInt("##IMacroVScroll",ImVec2(20.0f*dpiScale,i.height*dpiScale),&i.macro->vScroll,0,(i.max-i.min)-i.macro->vZoom,"",ImGuiSliderFlags_NoInput)) {
-            if (i.macro->vScroll<0) i.macro->vScroll=0;
-            if (i.macro->vScroll>((i.max-i.min)-i.macro->vZoom)) i.macro->vScroll=(i.max-i.min)-i.macro->vZoom;
+          if (ImGui::VSliderInt("##IMacroVScroll",ImVec2(20.0f*dpiScale,i.height*dpiScale),&view.vScroll,0,(i.max-i.min)-view.vZoom,"",ImGuiSliderFlags_NoInput)) {
+            if (view.vScroll<0) view.vScroll=0;
+            if (view.vScroll>((i.max-i.min)-view.vZoom)) view.vScroll=(i.max-i.min)-view.vZoom;
           }
           if (ImGui::IsItemHovered() && ctrlWheeling) {
-            i.macro->vScroll+=wheelY*(1+(i.macro->vZoom>>4));
-            if (i.macro->vScroll<0) i.macro->vScroll=0;
-            if (i.macro->vScroll>((i.max-i.min)-i.macro->vZoom)) i.macro->vScroll=(i.max-i.min)-i.macro->vZoom;
+            view.vScroll+=wheelY*(1+(view.vZoom>>4));
+            if (view.vScroll<0) view.vScroll=0;
+            if (view.vScroll>((i.max-i.min)-view.vZoom)) view.vScroll=(i.max-i.min)-view.vZoom;
           }
         } else {
-          ImS64 scrollV=(i.max-i.min-i.macro->vZoom)-i.macro->vScroll;
-          ImS64 availV=i.macro->vZoom;
+          ImS64 scrollV=(i.max-i.min-view.vZoom)-view.vScroll;
+          ImS64 availV=view.vZoom;
           ImS64 contentsV=(i.max-i.min);
 
           ImGui::SameLine(0.0f);
@@ -1664,15 +1676,15 @@ void FurnaceGUI::drawMacroEdit(FurnaceGUIMacroDesc& i, int totalFit, float avail
           scrollbarPos.Max.y+=i.height*dpiScale;
           ImGui::Dummy(ImVec2(ImGui::GetStyle().ScrollbarSize,i.height*dpiScale));
           if (ImGui::IsItemHovered() && ctrlWheeling) {
-            i.macro->vScroll+=wheelY*(1+(i.macro->vZoom>>4));
-            if (i.macro->vScroll<0) i.macro->vScroll=0;
-            if (i.macro->vScroll>((i.max-i.min)-i.macro->vZoom)) i.macro->vScroll=(i.max-i.min)-i.macro->vZoom;
+            view.vScroll+=wheelY*(1+(view.vZoom>>4));
+            if (view.vScroll<0) view.vScroll=0;
+            if (view.vScroll>((i.max-i.min)-view.vZoom)) view.vScroll=(i.max-i.min)-view.vZoom;
           }
 
           ImGuiID scrollbarID=ImGui::GetID("##IMacroVScroll");
           ImGui::KeepAliveID(scrollbarID);
           if (ImGui::ScrollbarEx(scrollbarPos,scrollbarID,ImGuiAxis_Y,&scrollV,availV,contentsV,0)) {
-            i.macro->vScroll=(i.max-i.min-i.macro->vZoom)-scrollV;
+            view.vScroll=(i.max-i.min-view.vZoom)-scrollV;
           }
         }
       }
@@ -1690,7 +1702,7 @@ void FurnaceGUI::drawMacroEdit(FurnaceGUIMacroDesc& i, int totalFit, float avail
           macroDragActive=true;
           macroDragBit30=i.bit30;
           macroDragSettingBit30=true;
-          macroDragTarget=i.macro->val;
+          macroDragTarget=&i.macro->val;
           macroDragChar=false;
           macroDragLineMode=false;
           macroDragLineInitial=ImVec2(0,0);
@@ -1725,14 +1737,22 @@ void FurnaceGUI::drawMacroEdit(FurnaceGUIMacroDesc& i, int totalFit, float avail
       ImGui::SetNextItemWidth(availableWidth);
       String& mmlStr=mmlString[index];
       if (ImGui::InputText("##IMacroMML",&mmlStr)) {
-        decodeMMLStr(mmlStr,i.macro->val,i.macro->len,i.macro->loop,i.min,(i.isBitfield)?((1<<(i.isBitfield?i.max:0))-1):i.max,i.macro->rel,i.bit30);
+        int mmlVal[256];
+        i.macro->val.copyTo(mmlVal,256);
+        decodeMMLStr(mmlStr,mmlVal,i.macro->len,i.macro->loop,i.min,(i.isBitfield)?((1<<(i.isBitfield?i.max:0))-1):i.max,i.macro->rel,i.bit30);
+        i.macro->val.setFrom(mmlVal,256);
       }
       if (!ImGui::IsItemActive()) {
-        encodeMMLStr(mmlStr,i.macro->val,i.macro->len,i.macro->loop,i.macro->rel,false,i.bit30);
+        int mmlVal[256];
+        i.macro->val.copyTo(mmlVal,i.macro->len);
+        encodeMMLStr(mmlStr,mmlVal,i.macro->len,i.macro->loop,i.macro->rel,false,i.bit30);
       }
     }
     ImGui::PopStyleVar();
   } else {
+    int params[16];
+    i.macro->val.copyTo(params,16);
+
     if (i.macro->open&2) {
       if (ImGui::BeginTable("MacroADSR",4)) {
         ImGui::TableSetupColumn("c0",ImGuiTableColumnFlags_WidthFixed);
@@ -1747,18 +1767,18 @@ void FurnaceGUI::drawMacroEdit(FurnaceGUIMacroDesc& i, int totalFit, float avail
         ImGui::Text("Bottom");
         ImGui::TableNextColumn();
         ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x);
-        if (ImGui::InputInt("##MABottom",&i.macro->val[0],1,16)) { PARAMETER
-          if (i.macro->val[0]<i.min) i.macro->val[0]=i.min;
-          if (i.macro->val[0]>i.max) i.macro->val[0]=i.max;
+        if (ImGui::InputInt("##MABottom",&params[0],1,16)) { PARAMETER
+          if (params[0]<i.min) params[0]=i.min;
+          if (params[0]>i.max) params[0]=i.max;
         }
 
         ImGui::TableNextColumn();
         ImGui::Text("Top");
         ImGui::TableNextColumn();
         ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x);
-        if (ImGui::InputInt("##MATop",&i.macro->val[1],1,16)) { PARAMETER
-          if (i.macro->val[1]<i.min) i.macro->val[1]=i.min;
-          if (i.macro->val[1]>i.max) i.macro->val[1]=i.max;
+        if (ImGui::InputInt("##MATop",&params[1],1,16)) { PARAMETER
+          if (params[1]<i.min) params[1]=i.min;
+          if (params[1]>i.max) params[1]=i.max;
         }
 
         /*ImGui::TableNextColumn();
@@ -1770,18 +1790,18 @@ void FurnaceGUI::drawMacroEdit(FurnaceGUIMacroDesc& i, int totalFit, float avail
         ImGui::Text("Attack");
         ImGui::TableNextColumn();
         ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x);
-        if (CWSliderInt("##MAAR",&i.macro->val[2],0,255)) { PARAMETER
-          if (i.macro->val[2]<0) i.macro->val[2]=0;
-          if (i.macro->val[2]>255) i.macro->val[2]=255;
+        if (CWSliderInt("##MAAR",&params[2],0,255)) { PARAMETER
+          if (params[2]<0) params[2]=0;
+          if (params[2]>255) params[2]=255;
         } rightClickable
 
         ImGui::TableNextColumn();
         ImGui::Text("Sustain");
         ImGui::TableNextColumn();
         ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x);
-        if (CWSliderInt("##MASL",&i.macro->val[5],0,255)) { PARAMETER
-          if (i.macro->val[5]<0) i.macro->val[5]=0;
-          if (i.macro->val[5]>255) i.macro->val[5]=255;
+        if (CWSliderInt("##MASL",&params[5],0,255)) { PARAMETER
+          if (params[5]<0) params[5]=0;
+          if (params[5]>255) params[5]=255;
         } rightClickable
 
         ImGui::TableNextRow();
@@ -1790,18 +1810,18 @@ void FurnaceGUI::drawMacroEdit(FurnaceGUIMacroDesc& i, int totalFit, float avail
         ImGui::Text("Hold");
         ImGui::TableNextColumn();
         ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x);
-        if (CWSliderInt("##MAHT",&i.macro->val[3],0,255)) { PARAMETER
-          if (i.macro->val[3]<0) i.macro->val[3]=0;
-          if (i.macro->val[3]>255) i.macro->val[3]=255;
+        if (CWSliderInt("##MAHT",&params[3],0,255)) { PARAMETER
+          if (params[3]<0) params[3]=0;
+          if (params[3]>255) params[3]=255;
         } rightClickable
 
         ImGui::TableNextColumn();
         ImGui::Text("SusTime");
         ImGui::TableNextColumn();
         ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x);
-        if (CWSliderInt("##MAST",&i.macro->val[6],0,255)) { PARAMETER
-          if (i.macro->val[6]<0) i.macro->val[6]=0;
-          if (i.macro->val[6]>255) i.macro->val[6]=255;
+        if (CWSliderInt("##MAST",&params[6],0,255)) { PARAMETER
+          if (params[6]<0) params[6]=0;
+          if (params[6]>255) params[6]=255;
         } rightClickable
 
         ImGui::TableNextRow();
@@ -1810,18 +1830,18 @@ void FurnaceGUI::drawMacroEdit(FurnaceGUIMacroDesc& i, int totalFit, float avail
         ImGui::Text("Decay");
         ImGui::TableNextColumn();
         ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x);
-        if (CWSliderInt("##MADR",&i.macro->val[4],0,255)) { PARAMETER
-          if (i.macro->val[4]<0) i.macro->val[4]=0;
-          if (i.macro->val[4]>255) i.macro->val[4]=255;
+        if (CWSliderInt("##MADR",&params[4],0,255)) { PARAMETER
+          if (params[4]<0) params[4]=0;
+          if (params[4]>255) params[4]=255;
         } rightClickable
 
         ImGui::TableNextColumn();
         ImGui::Text("SusDecay");
         ImGui::TableNextColumn();
         ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x);
-        if (CWSliderInt("##MASR",&i.macro->val[7],0,255)) { PARAMETER
-          if (i.macro->val[7]<0) i.macro->val[7]=0;
-          if (i.macro->val[7]>255) i.macro->val[7]=255;
+        if (CWSliderInt("##MASR",&params[7],0,255)) { PARAMETER
+          if (params[7]<0) params[7]=0;
+          if (params[7]>255) params[7]=255;
         } rightClickable
 
         ImGui::TableNextRow();
@@ -1833,9 +1853,9 @@ void FurnaceGUI::drawMacroEdit(FurnaceGUIMacroDesc& i, int totalFit, float avail
         ImGui::Text("Release");
         ImGui::TableNextColumn();
         ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x);
-        if (CWSliderInt("##MARR",&i.macro->val[8],0,255)) { PARAMETER
-          if (i.macro->val[8]<0) i.macro->val[8]=0;
-          if (i.macro->val[8]>255) i.macro->val[8]=255;
+        if (CWSliderInt("##MARR",&params[8],0,255)) { PARAMETER
+          if (params[8]<0) params[8]=0;
+          if (params[8]>255) params[8]=255;
         } rightClickable
 
         ImGui::EndTable();
@@ -1855,18 +1875,18 @@ void FurnaceGUI::drawMacroEdit(FurnaceGUIMacroDesc& i, int totalFit, float avail
         ImGui::Text("Bottom");
         ImGui::TableNextColumn();
         ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x);
-        if (ImGui::InputInt("##MABottom",&i.macro->val[0],1,16)) { PARAMETER
-          if (i.macro->val[0]<i.min) i.macro->val[0]=i.min;
-          if (i.macro->val[0]>i.max) i.macro->val[0]=i.max;
+        if (ImGui::InputInt("##MABottom",&params[0],1,16)) { PARAMETER
+          if (params[0]<i.min) params[0]=i.min;
+          if (params[0]>i.max) params[0]=i.max;
         }
 
         ImGui::TableNextColumn();
         ImGui::Text("Top");
         ImGui::TableNextColumn();
         ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x);
-        if (ImGui::InputInt("##MATop",&i.macro->val[1],1,16)) { PARAMETER
-          if (i.macro->val[1]<i.min) i.macro->val[1]=i.min;
-          if (i.macro->val[1]>i.max) i.macro->val[1]=i.max;
+        if (ImGui::InputInt("##MATop",&params[1],1,16)) { PARAMETER
+          if (params[1]<i.min) params[1]=i.min;
+          if (params[1]>i.max) params[1]=i.max;
         }
 
         /*ImGui::TableNextColumn();
@@ -1878,18 +1898,18 @@ void FurnaceGUI::drawMacroEdit(FurnaceGUIMacroDesc& i, int totalFit, float avail
         ImGui::Text("Speed");
         ImGui::TableNextColumn();
         ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x);
-        if (CWSliderInt("##MLSpeed",&i.macro->val[11],0,255)) { PARAMETER
-          if (i.macro->val[11]<0) i.macro->val[11]=0;
-          if (i.macro->val[11]>255) i.macro->val[11]=255;
+        if (CWSliderInt("##MLSpeed",&params[11],0,255)) { PARAMETER
+          if (params[11]<0) params[11]=0;
+          if (params[11]>255) params[11]=255;
         } rightClickable
 
         ImGui::TableNextColumn();
         ImGui::Text("Phase");
         ImGui::TableNextColumn();
         ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x);
-        if (CWSliderInt("##MLPhase",&i.macro->val[13],0,1023)) { PARAMETER
-          if (i.macro->val[13]<0) i.macro->val[13]=0;
-          if (i.macro->val[13]>1023) i.macro->val[13]=1023;
+        if (CWSliderInt("##MLPhase",&params[13],0,1023)) { PARAMETER
+          if (params[13]<0) params[13]=0;
+          if (params[13]>1023) params[13]=1023;
         } rightClickable
 
         ImGui::TableNextColumn();
@@ -1897,14 +1917,15 @@ void FurnaceGUI::drawMacroEdit(FurnaceGUIMacroDesc& i, int totalFit, float avail
         ImGui::Text("Shape");
         ImGui::TableNextColumn();
         ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x);
-        if (CWSliderInt("##MLShape",&i.macro->val[12],0,2,macroLFOShapes[i.macro->val[12]&3])) { PARAMETER
-          if (i.macro->val[12]<0) i.macro->val[12]=0;
-          if (i.macro->val[12]>2) i.macro->val[12]=2;
+        if (CWSliderInt("##MLShape",&params[12],0,2,macroLFOShapes[params[12]&3])) { PARAMETER
+          if (params[12]<0) params[12]=0;
+          if (params[12]>2) params[12]=2;
         } rightClickable
 
         ImGui::EndTable();
       }
     }
+    i.macro->val.setFrom(params,16);
   }
 }
 
@@ -1922,14 +1943,15 @@ void FurnaceGUI::drawMacroEdit(FurnaceGUIMacroDesc& i, int totalFit, float avail
       /* swap memory */ \
       /* this way the macro isn't corrupted if the user decides to go */ \
       /* back to sequence mode */ \
-      i.macro->len^=i.macro->lenMemory; \
-      i.macro->lenMemory^=i.macro->len; \
-      i.macro->len^=i.macro->lenMemory; \
+      FurnaceGUIMacroViewState& _view=getMacroViewState(i.macro); \
+      unsigned char _len=i.macro->len; \
+      i.macro->len=_view.lenMemory; \
+      _view.lenMemory=_len; \
 \
       for (int j=0; j<16; j++) { \
-        i.macro->val[j]^=i.macro->typeMemory[j]; \
-        i.macro->typeMemory[j]^=i.macro->val[j]; \
-        i.macro->val[j]^=i.macro->typeMemory[j]; \
+        int _val=i.macro->val[j]; \
+        i.macro->val[j]=_view.typeMemory[j]; \
+        _view.typeMemory[j]=_val; \
       } \
 \
       /* if ADSR/LFO, populate min/max */ \
@@ -2978,6 +3000,12 @@ void FurnaceGUI::drawInsEdit() {
       }
     } else {
       DivInstrument* ins=e->song.ins[curIns];
+      // editing must not reallocate macro storage under the playback thread
+      if (!ins->std.isFull()) {
+        e->lockEngine([ins]() {
+          ins->std.reserveFull();
+        });
+      }
       if (updateFMPreview) {
         renderFMPreview(ins);
         updateFMPreview=false;
@@ -3004,6 +3032,11 @@ void FurnaceGUI::drawInsEdit() {
             if (ImGui::Selectable(name.c_str(),curIns==(int)i)) {
               curIns=i;
               ins=e->song.ins[curIns];
+              if (!ins->std.isFull()) {
+                e->lockEngine([ins]() {
+                  ins->std.reserveFull();
+                });
+              }
               wavePreviewInit=true;
               updateFMPreview=true;
             }
@@ -3072,45 +3105,45 @@ void FurnaceGUI::drawInsEdit() {
               ins->type=i;
 
               // reset macro zoom
-              ins->std.volMacro.vZoom=-1;
-              ins->std.dutyMacro.vZoom=-1;
-              ins->std.waveMacro.vZoom=-1;
-              ins->std.ex1Macro.vZoom=-1;
-              ins->std.ex2Macro.vZoom=-1;
-              ins->std.ex3Macro.vZoom=-1;
-              ins->std.ex4Macro.vZoom=-1;
-              ins->std.ex5Macro.vZoom=-1;
-              ins->std.ex6Macro.vZoom=-1;
-              ins->std.ex7Macro.vZoom=-1;
-              ins->std.ex8Macro.vZoom=-1;
-              ins->std.panLMacro.vZoom=-1;
-              ins->std.panRMacro.vZoom=-1;
-              ins->std.phaseResetMacro.vZoom=-1;
-              ins->std.algMacro.vZoom=-1;
-              ins->std.fbMacro.vZoom=-1;
-              ins->std.fmsMacro.vZoom=-1;
-              ins->std.amsMacro.vZoom=-1;
+              resetMacroZoom(&ins->std.volMacro);
+              resetMacroZoom(&ins->std.dutyMacro);
+              resetMacroZoom(&ins->std.waveMacro);
+              resetMacroZoom(&ins->std.ex1Macro);
+              resetMacroZoom(&ins->std.ex2Macro);
+              resetMacroZoom(&ins->std.ex3Macro);
+              resetMacroZoom(&ins->std.ex4Macro);
+              resetMacroZoom(&ins->std.ex5Macro);
+              resetMacroZoom(&ins->std.ex6Macro);
+              resetMacroZoom(&ins->std.ex7Macro);
+              resetMacroZoom(&ins->std.ex8Macro);
+              resetMacroZoom(&ins->std.panLMacro);
+              resetMacroZoom(&ins->std.panRMacro);
+              resetMacroZoom(&ins->std.phaseResetMacro);
+              resetMacroZoom(&ins->std.algMacro);
+              resetMacroZoom(&ins->std.fbMacro);
+              resetMacroZoom(&ins->std.fmsMacro);
+              resetMacroZoom(&ins->std.amsMacro);
               for (int j=0; j<4; j++) {
-                ins->std.opMacros[j].amMacro.vZoom=-1;
-                ins->std.opMacros[j].arMacro.vZoom=-1;
-                ins->std.opMacros[j].drMacro.vZoom=-1;
-                ins->std.opMacros[j].multMacro.vZoom=-1;
-                ins->std.opMacros[j].rrMacro.vZoom=-1;
-                ins->std.opMacros[j].slMacro.vZoom=-1;
-                ins->std.opMacros[j].tlMacro.vZoom=-1;
-                ins->std.opMacros[j].dt2Macro.vZoom=-1;
-                ins->std.opMacros[j].rsMacro.vZoom=-1;
-                ins->std.opMacros[j].dtMacro.vZoom=-1;
-                ins->std.opMacros[j].d2rMacro.vZoom=-1;
-                ins->std.opMacros[j].ssgMacro.vZoom=-1;
-                ins->std.opMacros[j].damMacro.vZoom=-1;
-                ins->std.opMacros[j].dvbMacro.vZoom=-1;
-                ins->std.opMacros[j].egtMacro.vZoom=-1;
-                ins->std.opMacros[j].kslMacro.vZoom=-1;
-                ins->std.opMacros[j].susMacro.vZoom=-1;
-                ins->std.opMacros[j].vibMacro.vZoom=-1;
-                ins->std.opMacros[j].wsMacro.vZoom=-1;
-                ins->std.opMacros[j].ksrMacro.vZoom=-1;
+                resetMacroZoom(&ins->std.opMacros[j].amMacro);
+                resetMacroZoom(&ins->std.opMacros[j].arMacro);
+                resetMacroZoom(&ins->std.opMacros[j].drMacro);
+                resetMacroZoom(&ins->std.opMacros[j].multMacro);
+                resetMacroZoom(&ins->std.opMacros[j].rrMacro);
+                resetMacroZoom(&ins->std.opMacros[j].slMacro);
+                resetMacroZoom(&ins->std.opMacros[j].tlMacro);
+                resetMacroZoom(&ins->std.opMacros[j].dt2Macro);
+                resetMacroZoom(&ins->std.opMacros[j].rsMacro);
+                resetMacroZoom(&ins->std.opMacros[j].dtMacro);
+                resetMacroZoom(&ins->std.opMacros[j].d2rMacro);
+                resetMacroZoom(&ins->std.opMacros[j].ssgMacro);
+                resetMacroZoom(&ins->std.opMacros[j].damMacro);
+                resetMacroZoom(&ins->std.opMacros[j].dvbMacro);
+                resetMacroZoom(&ins->std.opMacros[j].egtMacro);
+                resetMacroZoom(&ins->std.opMacros[j].kslMacro);
+                resetMacroZoom(&ins->std.opMacros[j].susMacro);
+                resetMacroZoom(&ins->std.opMacros[j].vibMacro);
+                resetMacroZoom(&ins->std.opMacros[j].wsMacro);
+                resetMacroZoom(&ins->std.opMacros[j].ksrMacro);
               }
             }
           }
@@ -3959,8 +3992,8 @@ void FurnaceGUI::drawInsEdit() {
                     if (ImGui::Checkbox(ESFM_NAME(ESFM_FIXED),&fixedOn)) { PARAMETER
                       opE.fixed=fixedOn;
                       // HACK: reset zoom and scroll in fixed pitch macros so that they draw correctly
-                      ins->std.opMacros[i].ssgMacro.vZoom=-1;
-                      ins->std.opMacros[i].dtMacro.vZoom=-1;
+                      resetMacroZoom(&ins->std.opMacros[i].ssgMacro);
+                      resetMacroZoom(&ins->std.opMacros[i].dtMacro);
                     }
                     if (ins->type==DIV_INS_ESFM) {
                       if (fixedOn) {
@@ -4699,8 +4732,8 @@ void FurnaceGUI::drawInsEdit() {
                         if (ImGui::Checkbox(ESFM_NAME(ESFM_FIXED),&fixedOn)) { PARAMETER
                           opE.fixed=fixedOn;
                           // HACK: reset zoom and scroll in fixed pitch macros so that they draw correctly
-                          ins->std.opMacros[i].ssgMacro.vZoom=-1;
-                          ins->std.opMacros[i].dtMacro.vZoom=-1;
+                          resetMacroZoom(&ins->std.opMacros[i].ssgMacro);
+                          resetMacroZoom(&ins->std.opMacros[i].dtMacro);
                         }
 
                         ImGui::EndTable();
@@ -5231,8 +5264,8 @@ void FurnaceGUI::drawInsEdit() {
                     if (ImGui::Checkbox(ESFM_NAME(ESFM_FIXED),&fixedOn)) { PARAMETER
                       opE.fixed=fixedOn;
                       // HACK: reset zoom and scroll in fixed pitch macros so that they draw correctly
-                      ins->std.opMacros[i].ssgMacro.vZoom=-1;
-                      ins->std.opMacros[i].dtMacro.vZoom=-1;
+                      resetMacroZoom(&ins->std.opMacros[i].ssgMacro);
+                      resetMacroZoom(&ins->std.opMacros[i].dtMacro);
                     }
                   }
 
@@ -5357,7 +5390,7 @@ void FurnaceGUI::drawInsEdit() {
                   macroList.push_back(FurnaceGUIMacroDesc("Block",&ins->std.opMacros[ordi].ssgMacro,0,7,64,uiColors[GUI_COLOR_MACRO_OTHER],true));
                   macroList.push_back(FurnaceGUIMacroDesc("FreqNum",&ins->std.opMacros[ordi].dtMacro,0,1023,160,uiColors[GUI_COLOR_MACRO_OTHER]));
                 } else {
-                  macroList.push_back(FurnaceGUIMacroDesc("Op. Arpeggio",&ins->std.opMacros[ordi].ssgMacro,-120,120,160,uiColors[GUI_COLOR_MACRO_PITCH],true,NULL,macroHoverNote,false,NULL,0,true,ins->std.opMacros[ordi].ssgMacro.val,true));
+                  macroList.push_back(FurnaceGUIMacroDesc("Op. Arpeggio",&ins->std.opMacros[ordi].ssgMacro,-120,120,160,uiColors[GUI_COLOR_MACRO_PITCH],true,NULL,macroHoverNote,false,NULL,0,true,&ins->std.opMacros[ordi].ssgMacro.val,true));
                   macroList.push_back(FurnaceGUIMacroDesc("Op. Pitch",&ins->std.opMacros[ordi].dtMacro,-2048,2047,160,uiColors[GUI_COLOR_MACRO_PITCH],true,macroRelativeMode,NULL,false,NULL,0,false,NULL,false,true));
                 }
 
@@ -5759,11 +5792,11 @@ void FurnaceGUI::drawInsEdit() {
           popToggleColors();
 
           if (ImGui::Checkbox("Absolute Cutoff Macro",&ins->c64.filterIsAbs)) {
-            ins->std.algMacro.vZoom=-1;
+            resetMacroZoom(&ins->std.algMacro);
             PARAMETER;
           }
           if (ImGui::Checkbox("Absolute Duty Macro",&ins->c64.dutyIsAbs)) {
-            ins->std.dutyMacro.vZoom=-1;
+            resetMacroZoom(&ins->std.dutyMacro);
             PARAMETER;
           }
           P(ImGui::Checkbox("Don't test before new note",&ins->c64.noTest));
@@ -7116,7 +7149,7 @@ void FurnaceGUI::drawInsEdit() {
             macroList.push_back(FurnaceGUIMacroDesc(volumeLabel,&ins->std.volMacro,volMin,volMax,160,uiColors[GUI_COLOR_MACRO_VOLUME]));
           }
           if (ins->type!=DIV_INS_MSM6258 && ins->type!=DIV_INS_MSM6295 && ins->type!=DIV_INS_ADPCMA) {
-            macroList.push_back(FurnaceGUIMacroDesc("Arpeggio",&ins->std.arpMacro,-120,120,160,uiColors[GUI_COLOR_MACRO_PITCH],true,NULL,macroHoverNote,false,NULL,0,true,ins->std.arpMacro.val));
+            macroList.push_back(FurnaceGUIMacroDesc("Arpeggio",&ins->std.arpMacro,-120,120,160,uiColors[GUI_COLOR_MACRO_PITCH],true,NULL,macroHoverNote,false,NULL,0,true,&ins->std.arpMacro.val));
           }
           if (dutyMax>0) {
             if (ins->type==DIV_INS_MIKEY) {
@@ -7356,7 +7389,9 @@ void FurnaceGUI::drawInsEdit() {
     if (ImGui::BeginPopup("macroMenu",ImGuiWindowFlags_NoMove|ImGuiWindowFlags_AlwaysAutoResize|ImGuiWindowFlags_NoTitleBar|ImGuiWindowFlags_NoSavedSettings)) {
       if (ImGui::MenuItem("copy")) {
         String mmlStr;
-        encodeMMLStr(mmlStr,lastMacroDesc.macro->val,lastMacroDesc.macro->len,lastMacroDesc.macro->loop,lastMacroDesc.macro->rel);
+        int mmlVal[256];
+        lastMacroDesc.macro->val.copyTo(mmlVal,lastMacroDesc.macro->len);
+        encodeMMLStr(mmlStr,mmlVal,lastMacroDesc.macro->len,lastMacroDesc.macro->loop,lastMacroDesc.macro->rel);
         SDL_SetClipboardText(mmlStr.c_str());
       }
       if (ImGui::MenuItem("paste")) {
@@ -7369,7 +7404,10 @@ void FurnaceGUI::drawInsEdit() {
           SDL_free(clipText);
         }
         if (!mmlStr.empty()) {
-          decodeMMLStr(mmlStr,lastMacroDesc.macro->val,lastMacroDesc.macro->len,lastMacroDesc.macro->loop,lastMacroDesc.min,(lastMacroDesc.isBitfield)?((1<<(lastMacroDesc.isBitfield?lastMacroDesc.max:0))-1):lastMacroDesc.max,lastMacroDesc.macro->rel);
+          int mmlVal[256];
+          lastMacroDesc.macro->val.copyTo(mmlVal,256);
+          decodeMMLStr(mmlStr,mmlVal,lastMacroDesc.macro->len,lastMacroDesc.macro->loop,lastMacroDesc.min,(lastMacroDesc.isBitfield)?((1<<(lastMacroDesc.isBitfield?lastMacroDesc.max:0))-1):lastMacroDesc.max,lastMacroDesc.macro->rel);
+          lastMacroDesc.macro->val.setFrom(mmlVal,256);
         }
       }
       ImGui::Separator();
@@ -7393,7 +7431,7 @@ void FurnaceGUI::drawInsEdit() {
         if (ImGui::Button("offset")) {
           int oldData[256];
           memset(oldData,0,256*sizeof(int));
-          memcpy(oldData,lastMacroDesc.macro->val,lastMacroDesc.macro->len*sizeof(int));
+          lastMacroDesc.macro->val.copyTo(oldData,lastMacroDesc.macro->len);
 
           for (int i=0; i<lastMacroDesc.macro->len; i++) {
             int val=0;
@@ -7429,7 +7467,7 @@ void FurnaceGUI::drawInsEdit() {
         if (ImGui::Button("scale")) {
           int oldData[256];
           memset(oldData,0,256*sizeof(int));
-          memcpy(oldData,lastMacroDesc.macro->val,lastMacroDesc.macro->len*sizeof(int));
+          lastMacroDesc.macro->val.copyTo(oldData,lastMacroDesc.macro->len);
 
           lastMacroDesc.macro->len=MIN(128,((double)lastMacroDesc.macro->len*(macroScaleX/100.0)));
 
@@ -88,6 +88,7 @@ void FurnaceGUI::endIntroTune() {
   }
   undoHist.clear();
   redoHist.clear();
+  macroViewState.clear();
   modified=false;
   curNibble=false;
   orderNibble=false;
@@ -176,6 +176,7 @@ void FurnaceGUI::drawNewSong() {
     e->createNew(nextDesc.c_str(),nextDescName,false);
     undoHist.clear();
     redoHist.clear();
+    macroViewState.clear();
     curFileName="";
     modified=false;
     curNibble=false;
@@ -919,6 +919,9 @@ void FurnaceGUI::drawPattern() {
             if (ImGui::SmallButton(chanID)) {
               e->curPat[i].effectCols++;
               if (e->curPat[i].effectCols>DIV_MAX_EFFECTS) e->curPat[i].effectCols=DIV_MAX_EFFECTS;
+              e->lockEngine([this,i]() {
+                e->curPat[i].fitPatterns();
+              });
             }
             ImGui::EndDisabled();
           }
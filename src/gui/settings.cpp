@@ -21,6 +21,7 @@
 #include "imgui_internal.h"
 #include "fonts.h"
 #include "../ta-log.h"
+#include "../engine/renderAhead.h"
 #include "../fileutils.h"
 #include "../utfutils.h"
 #include "util.h"
@@ -144,7 +145,8 @@ const char* nesCores[]={
 const char* c64Cores[]={
   "reSID",
   "reSIDfp",
-  "dSID"
+  "dSID",
+  "reSID (fast)"
 };
 
 const char* pokeyCores[]={
@@ -1026,6 +1028,15 @@ void FurnaceGUI::drawSettings() {
               }
             }
             popWarningColor();
+
+            bool renderTickAheadB=settings.renderTickAhead;
+            if (ImGui::Checkbox("Tick-ahead rendering",&renderTickAheadB)) {
+              settings.renderTickAhead=renderTickAheadB;
+              settingsChanged=true;
+            }
+            if (ImGui::IsItemHovered()) {
+              ImGui::SetTooltip("runs tick logic ahead and renders each chip in a single task per buffer.\nreduces thread synchronization on multi-chip songs.\n\nonly used when every chip in the song supports it.");
+            }
           }
         }
 
@@ -1038,6 +1049,37 @@ void FurnaceGUI::drawSettings() {
           ImGui::SetTooltip("reduces latency by running the engine faster than the tick rate.\nuseful for live playback/jam mode.\n\nwarning: only enable if your buffer size is small (10ms or less).");
         }
 
+        bool chipSleepB=settings.chipSleep;
+        if (ImGui::Checkbox("Sleep silent chips",&chipSleepB)) {
+          settings.chipSleep=chipSleepB;
+          settingsChanged=true;
+        }
+        if (ImGui::IsItemHovered()) {
+          ImGui::SetTooltip("stops emulating a chip while it is silent and nothing is written to it.\nonly some chips support this.\n\nwaveforms may restart at a different position after waking up.\nnever used when exporting.");
+        }
+
+        bool renderAheadB=(settings.renderAhead>0);
+        if (ImGui::Checkbox("Render ahead",&renderAheadB)) {
+          if (renderAheadB) {
+            settings.renderAhead=2;
+          } else {
+            settings.renderAhead=0;
+          }
+          settingsChanged=true;
+        }
+        if (ImGui::IsItemHovered()) {
+          ImGui::SetTooltip("runs the engine on its own thread, a number of buffers ahead of the audio output.\nprevents dropouts caused by the interface or heavy songs when using small buffer sizes,\nat the cost of additional latency.");
+        }
+
+        if (renderAheadB) {
+          String aheadLabel=fmt::sprintf("%%d (latency: ~%.1fms)",1000.0*(double)(settings.renderAhead*settings.audioBufSize)/(double)MAX(1,settings.audioRate));
+          if (ImGui::SliderInt("Buffers ahead",&settings.renderAhead,1,DIV_RENDER_AHEAD_MAX,aheadLabel.c_str())) {
+            if (settings.renderAhead<1) settings.renderAhead=1;
+            if (settings.renderAhead>DIV_RENDER_AHEAD_MAX) settings.renderAhead=DIV_RENDER_AHEAD_MAX;
+            settingsChanged=true;
+          }
+        }
+
         bool forceMonoB=settings.forceMono;
         if (ImGui::Checkbox("Force mono audio",&forceMonoB)) {
           settings.forceMono=forceMonoB;
@@ -1564,10 +1606,10 @@ void FurnaceGUI::drawSettings() {
           ImGui::Text("SID");
           ImGui::TableNextColumn();
           ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x);
-          if (ImGui::Combo("##C64Core",&settings.c64Core,c64Cores,3)) settingsChanged=true;
+          if (ImGui::Combo("##C64Core",&settings.c64Core,c64Cores,4)) settingsChanged=true;
           ImGui::TableNextColumn();
           ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x);
-          if (ImGui::Combo("##C64CoreRender",&settings.c64CoreRender,c64Cores,3)) settingsChanged=true;
+          if (ImGui::Combo("##C64CoreRender",&settings.c64CoreRender,c64Cores,4)) settingsChanged=true;
 
           ImGui::TableNextRow();
           ImGui::TableNextColumn();
@@ -3805,6 +3847,8 @@ void FurnaceGUI::readConfig(DivConfig& conf, FurnaceGUISettingGroups groups) {
 
     settings.chanOscThreads=conf.getInt("chanOscThreads",0);
     settings.renderPoolThreads=conf.getInt("renderPoolThreads",0);
+    settings.renderTickAhead=conf.getInt("renderTickAhead",0);
+    settings.renderAhead=conf.getInt("renderAhead",0);
     settings.showPool=conf.getInt("showPool",0);
     settings.writeInsNames=conf.getInt("writeInsNames",0);
     settings.readInsNames=conf.getInt("readInsNames",1);
@@ -3857,6 +3901,7 @@ void FurnaceGUI::readConfig(DivConfig& conf, FurnaceGUISettingGroups groups) {
     settings.audioChans=conf.getInt("audioChans",2);
 
     settings.lowLatency=conf.getInt("lowLatency",0);
+    settings.chipSleep=conf.getInt("chipSleep",0);
 
     settings.metroVol=conf.getInt("metroVol",100);
     settings.sampleVol=conf.getInt("sampleVol",50);
@@ -4091,7 +4136,7 @@ void FurnaceGUI::readConfig(DivConfig& conf, FurnaceGUISettingGroups groups) {
   clampSetting(settings.snCore,0,1);
   clampSetting(settings.nesCore,0,1);
   clampSetting(settings.fdsCore,0,1);
-  clampSetting(settings.c64Core,0,2);
+  clampSetting(settings.c64Core,0,3);
   clampSetting(settings.pokeyCore,0,1);
   clampSetting(settings.opnCore,0,1);
   clampSetting(settings.opl2Core,0,2);
@@ -4101,7 +4146,7 @@ void FurnaceGUI::readConfig(DivConfig& conf, FurnaceGUISettingGroups groups) {
   clampSetting(settings.snCoreRender,0,1);
   clampSetting(settings.nesCoreRender,0,1);
   clampSetting(settings.fdsCoreRender,0,1);
-  clampSetting(settings.c64CoreRender,0,2);
+  clampSetting(settings.c64CoreRender,0,3);
   clampSetting(settings.pokeyCoreRender,0,1);
   clampSetting(settings.opnCoreRender,0,1);
   clampSetting(settings.opl2CoreRender,0,2);
@@ -4165,6 +4210,7 @@ void FurnaceGUI::readConfig(DivConfig& conf, FurnaceGUISettingGroups groups) {
   clampSetting(settings.oplStandardWaveNames,0,1);
   clampSetting(settings.cursorMoveNoScroll,0,1);
   clampSetting(settings.lowLatency,0,1);
+  clampSetting(settings.chipSleep,0,1);
   clampSetting(settings.notePreviewBehavior,0,3);
   clampSetting(settings.powerSave,0,1);
   clampSetting(settings.absorbInsInput,0,1);
@@ -4234,6 +4280,8 @@ void FurnaceGUI::readConfig(DivConfig& conf, FurnaceGUISettingGroups groups) {
   clampSetting(settings.wasapiEx,0,1);
   clampSetting(settings.chanOscThreads,0,256);
   clampSetting(settings.renderPoolThreads,0,DIV_MAX_CHIPS);
+  clampSetting(settings.renderTickAhead,0,1);
+  clampSetting(settings.renderAhead,0,DIV_RENDER_AHEAD_MAX);
   clampSetting(settings.showPool,0,1);
   clampSetting(settings.writeInsNames,0,1);
   clampSetting(settings.readInsNames,0,1);
@@ -4270,6 +4318,8 @@ void FurnaceGUI::writeConfig(DivConfig& conf, FurnaceGUISettingGroups groups) {
     
     conf.set("chanOscThreads",settings.chanOscThreads);
     conf.set("renderPoolThreads",settings.renderPoolThreads);
+    conf.set("renderTickAhead",settings.renderTickAhead);
+    conf.set("renderAhead",settings.renderAhead);
     conf.set("showPool",settings.showPool);
     conf.set("writeInsNames",settings.writeInsNames);
     conf.set("readInsNames",settings.readInsNames);
@@ -4316,6 +4366,7 @@ void FurnaceGUI::writeConfig(DivConfig& conf, FurnaceGUISettingGroups groups) {
     conf.set("audioChans",settings.audioChans);
 
     conf.set("lowLatency",settings.lowLatency);
+    conf.set("chipSleep",settings.chipSleep);
 
     conf.set("metroVol",settings.metroVol);
     conf.set("sampleVol",settings.sampleVol);
@@ -235,6 +235,9 @@ void FurnaceGUI::drawSpeed(bool asChild) {
         if (patLen<1) patLen=1;
         if (patLen>DIV_MAX_PATTERNS) patLen=DIV_MAX_PATTERNS;
         e->curSubSong->patLen=patLen;
+        e->lockEngine([this]() {
+          e->curSubSong->fitPatterns();
+        });
       }
 
       ImGui::TableNextRow();
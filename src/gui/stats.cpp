@@ -36,6 +36,58 @@ void FurnaceGUI::drawStats() {
     ImGui::Text("Audio load");
     ImGui::SameLine();
     ImGui::ProgressBar((double)lastProcTime/maxGot,ImVec2(-FLT_MIN,0),procStr.c_str());
+    int patCount=0;
+    size_t patMem=e->song.getPatternMemUsage(&patCount);
+    ImGui::Text("Pattern data: %dK (%d patterns)",(int)(patMem>>10),patCount);
+    ImGui::Separator();
+    if (ImGui::TreeNode("Render time")) {
+      ImGui::Text("buffer: %.0fµs",maxGot/1000.0);
+      if (ImGui::BeginTable("ProfStages",4,ImGuiTableFlags_Borders|ImGuiTableFlags_SizingFixedSame)) {
+        ImGui::TableSetupColumn("stage");
+        ImGui::TableSetupColumn("p50");
+        ImGui::TableSetupColumn("p99");
+        ImGui::TableSetupColumn("max");
+        ImGui::TableHeadersRow();
+        for (int i=0; i<DIV_PROF_MAX; i++) {
+          DivProfStats stats=e->profiler.stage[i].getStats();
+          ImGui::TableNextRow();
+          ImGui::TableNextColumn();
+          ImGui::TextUnformatted(DivProfiler::getStageName(i));
+          ImGui::TableNextColumn();
+          ImGui::Text("%.0fµs",stats.p50);
+          ImGui::TableNextColumn();
+          ImGui::Text("%.0fµs",stats.p99);
+          ImGui::TableNextColumn();
+          ImGui::Text("%.0fµs",stats.max);
+        }
+        ImGui::EndTable();
+      }
+      if (ImGui::BeginTable("ProfChips",5,ImGuiTableFlags_Borders|ImGuiTableFlags_SizingFixedFit)) {
+        ImGui::TableSetupColumn("chip");
+        ImGui::TableSetupColumn("acquire p50");
+        ImGui::TableSetupColumn("acquire p99");
+        ImGui::TableSetupColumn("acquire max");
+        ImGui::TableSetupColumn("fill p99");
+        ImGui::TableHeadersRow();
+        for (int i=0; i<e->song.systemLen; i++) {
+          DivProfStats acquireStats=e->profiler.chipAcquire[i].getStats();
+          DivProfStats fillStats=e->profiler.chipFill[i].getStats();
+          ImGui::TableNextRow();
+          ImGui::TableNextColumn();
+          ImGui::Text("%d. %s",i+1,e->getSystemName(e->song.system[i]));
+          ImGui::TableNextColumn();
+          ImGui::Text("%.0fµs",acquireStats.p50);
+          ImGui::TableNextColumn();
+          ImGui::Text("%.0fµs",acquireStats.p99);
+          ImGui::TableNextColumn();
+          ImGui::Text("%.0fµs",acquireStats.max);
+          ImGui::TableNextColumn();
+          ImGui::Text("%.0fµs",fillStats.p99);
+        }
+        ImGui::EndTable();
+      }
+      ImGui::TreePop();
+    }
     ImGui::Separator();
     for (int i=0; i<e->song.systemLen; i++) {
       DivDispatch* dispatch=e->getDispatch(i);
@@ -60,7 +60,10 @@ String outName;
 String vgmOutName;
 String zsmOutName;
 String cmdOutName;
+String batchName;
+String profileName;
 int loops=1;
+int batchJobs=1;
 int benchMode=0;
 int subsong=-1;
 DivAudioExportModes outMode=DIV_EXPORT_MODE_ONE;
@@ -289,6 +292,26 @@ TAParamResult pLoops(String val) {
   return TA_PARAM_SUCCESS;
 }
 
+TAParamResult pJobs(String val) {
+  try {
+    int v=std::stoi(val);
+    if (v<1) {
+      logE("job count shall be 1 or higher.");
+      return TA_PARAM_ERROR;
+    }
+    batchJobs=v;
+  } catch (std::exception& e) {
+    logE("job count shall be a number.");
+    return TA_PARAM_ERROR;
+  }
+  return TA_PARAM_SUCCESS;
+}
+
+TAParamResult pProfile(String val) {
+  profileName=val;
+  return TA_PARAM_SUCCESS;
+}
+
 TAParamResult pSubSong(String val) {
   try {
     int v=std::stoi(val);
@@ -355,6 +378,12 @@ TAParamResult pCmdOut(String val) {
   return TA_PARAM_SUCCESS;
 }
 
+TAParamResult pBatch(String val) {
+  batchName=val;
+  e.setAudio(DIV_AUDIO_DUMMY);
+  return TA_PARAM_SUCCESS;
+}
+
 bool needsValue(String param) {
   for (size_t i=0; i<params.size(); i++) {
     if (params[i].name==param) {
@@ -373,6 +402,8 @@ void initParams() {
   params.push_back(TAParam("D","direct",false,pDirect,"","set VGM export direct stream mode"));
   params.push_back(TAParam("Z","zsmout",true,pZSMOut,"<filename>","output .zsm data for Commander X16 Zsound"));
   params.push_back(TAParam("C","cmdout",true,pCmdOut,"<filename>","output command stream"));
+  params.push_back(TAParam("R","batch",true,pBatch,"<filename>","render every song listed in a file (one \"input<TAB>output\" pair per line)"));
+  params.push_back(TAParam("J","jobs",true,pJobs,"<count>","render this many songs at once in batch mode (1 by default)"));
   params.push_back(TAParam("b","binary",false,pBinary,"","set command stream output format to binary"));
   params.push_back(TAParam("L","loglevel",true,pLogLevel,"debug|info|warning|error","set the log level (info by default)"));
   params.push_back(TAParam("v","view",true,pView,"pattern|commands|nothing","set visualization (nothing by default)"));
@@ -386,6 +417,7 @@ void initParams() {
   params.push_back(TAParam("A","safeaudio",false,pSafeModeAudio,"","enable safe mode (with audio"));
 
   params.push_back(TAParam("B","benchmark",true,pBenchmark,"render|seek","run performance test"));
+  params.push_back(TAParam("P","profile",true,pProfile,"<filename>|-","write per-stage/per-chip render timing as JSON after a render benchmark"));
 
   params.push_back(TAParam("V","version",false,pVersion,"","view information about Furnace."));
   params.push_back(TAParam("W","warranty",false,pWarranty,"","view warranty disclaimer."));
@@ -409,6 +441,127 @@ void reportError(String what) {
 }
 #endif
 
+// loads a song into the engine. returns false and sets err on failure.
+bool loadSongFile(DivEngine& eng, const String& path, String& err) {
+  if (!eng.loadFile(path)) {
+    err=fmt::sprintf("could not open file! (%s)",eng.getLastError());
+    return false;
+  }
+  return true;
+}
+
+// renders a song from a batch. returns false on failure.
+bool renderBatchSong(DivEngine& eng, const std::pair<String,String>& song) {
+  String err;
+  std::chrono::steady_clock::time_point songBegin=std::chrono::steady_clock::now();
+  if (!loadSongFile(eng,song.first,err)) {
+    logE("%s: %s",song.first,err);
+    return false;
+  }
+  if (subsong!=-1) {
+    eng.changeSongP(subsong);
+  }
+  std::chrono::steady_clock::time_point renderBegin=std::chrono::steady_clock::now();
+  if (!eng.saveAudio(song.second.c_str(),loops,outMode)) {
+    logE("%s: could not render!",song.first);
+    return false;
+  }
+  eng.waitAudioFile();
+  std::chrono::steady_clock::time_point songEnd=std::chrono::steady_clock::now();
+
+  double loadTime=(double)std::chrono::duration_cast<std::chrono::microseconds>(renderBegin-songBegin).count()/1000000.0;
+  double renderTime=(double)std::chrono::duration_cast<std::chrono::microseconds>(songEnd-renderBegin).count()/1000000.0;
+  printf("[RESULT] %s: load %fs, render %fs\n",song.first.c_str(),loadTime,renderTime);
+  return true;
+}
+
+// renders every song in a manifest using the already initialized engine.
+// each line is "input<TAB>output". if there is no output, ".wav" is appended to the input.
+// empty lines and lines starting with # are ignored.
+// if more than one job is requested, additional engine instances are created and each one
+// renders songs on its own thread.
+int runBatch(const String& path) {
+  FILE* f=ps_fopen(path.c_str(),"rb");
+  if (f==NULL) {
+    reportError(fmt::sprintf("couldn't open batch file! (%s)",strerror(errno)));
+    return 1;
+  }
+
+  std::vector<std::pair<String,String>> songs;
+  char line[4096];
+  while (fgets(line,4096,f)!=NULL) {
+    String l=line;
+    while (!l.empty() && (l.back()=='\n' || l.back()=='\r')) l.pop_back();
+    if (l.empty() || l[0]=='#') continue;
+    size_t tabPos=l.find('\t');
+    if (tabPos==String::npos) {
+      songs.push_back(std::pair<String,String>(l,l+".wav"));
+    } else {
+      songs.push_back(std::pair<String,String>(l.substr(0,tabPos),l.substr(tabPos+1)));
+    }
+  }
+  fclose(f);
+
+  int jobs=batchJobs;
+  if (jobs>(int)songs.size()) jobs=songs.size();
+  if (jobs<1) jobs=1;
+
+  logI("rendering %d songs (%d at once)...",(int)songs.size(),jobs);
+  e.setConsoleMode(true);
+
+  // split the cores between the jobs
+  unsigned int threadsPerJob=std::thread::hardware_concurrency()/jobs;
+  if (threadsPerJob<1) threadsPerJob=1;
+  if (jobs>1) e.setExportThreads(threadsPerJob);
+
+  std::vector<DivEngine*> engines;
+  engines.push_back(&e);
+  for (int i=1; i<jobs; i++) {
+    DivEngine* eng=new DivEngine;
+    eng->preInitFrom(e);
+    eng->setAudio(DIV_AUDIO_DUMMY);
+    eng->setConsoleMode(true);
+    eng->setExportThreads(threadsPerJob);
+    if (!eng->init()) {
+      logE("could not initialize engine for job %d!",i);
+      eng->quit(false);
+      delete eng;
+      break;
+    }
+    engines.push_back(eng);
+  }
+
+  std::atomic<size_t> nextSong(0);
+  std::atomic<int> failed(0);
+  std::chrono::steady_clock::time_point batchBegin=std::chrono::steady_clock::now();
+  auto worker=[&](DivEngine* eng) {
+    for (size_t i=nextSong++; i<songs.size(); i=nextSong++) {
+      if (!renderBatchSong(*eng,songs[i])) failed++;
+    }
+  };
+  if (engines.size()<2) {
+    worker(&e);
+  } else {
+    std::vector<std::thread> threads;
+    for (DivEngine* i: engines) {
+      threads.push_back(std::thread(worker,i));
+    }
+    for (std::thread& i: threads) {
+      i.join();
+    }
+  }
+  std::chrono::steady_clock::time_point batchEnd=std::chrono::steady_clock::now();
+
+  for (size_t i=1; i<engines.size(); i++) {
+    engines[i]->quit(false);
+    delete engines[i];
+  }
+
+  double totalTime=(double)std::chrono::duration_cast<std::chrono::microseconds>(batchEnd-batchBegin).count()/1000000.0;
+  printf("[RESULT] %d songs (%d failed) in %fs\n",(int)songs.size(),(int)failed,totalTime);
+  return (failed>0)?1:0;
+}
+
 #ifndef _WIN32
 #ifdef HAVE_GUI
 static void handleTermGUI(int) {
@@ -543,9 +696,14 @@ int main(int argc, char** argv) {
     return 1;
   }
 
+  if (!fileName.empty() && batchName!="") {
+    logE("can't use a file and -batch at the same time.");
+    return 1;
+  }
+
 #ifdef HAVE_GUI
-  if (e.preInit(consoleMode || benchMode || infoMode || outName!="" || vgmOutName!="" || cmdOutName!="")) {
-    if (consoleMode || benchMode || infoMode || outName!="" || vgmOutName!="" || cmdOutName!="") {
+  if (e.preInit(consoleMode || benchMode || infoMode || outName!="" || vgmOutName!="" || cmdOutName!="" || batchName!="")) {
+    if (consoleMode || benchMode || infoMode || outName!="" || vgmOutName!="" || cmdOutName!="" || batchName!="") {
       logW("engine wants safe mode, but Furnace GUI is not going to start.");
     } else {
       safeMode=true;
@@ -557,7 +715,7 @@ int main(int argc, char** argv) {
   }
 #endif
 
-  if (safeMode && (consoleMode || benchMode || infoMode || outName!="" || vgmOutName!="" || cmdOutName!="")) {
+  if (safeMode && (consoleMode || benchMode || infoMode || outName!="" || vgmOutName!="" || cmdOutName!="" || batchName!="")) {
     logE("you can't use safe mode and console/export mode together.");
     return 1;
   }
@@ -568,59 +726,9 @@ int main(int argc, char** argv) {
 
   if (!fileName.empty() && ((!e.getConfBool("tutIntroPlayed",false)) || e.getConfInt("alwaysPlayIntro",0)!=3 || consoleMode || benchMode || infoMode || outName!="" || vgmOutName!="" || cmdOutName!="")) {
     logI("loading module...");
-    FILE* f=ps_fopen(fileName.c_str(),"rb");
-    if (f==NULL) {
-      reportError(fmt::sprintf("couldn't open file! (%s)",strerror(errno)));
-      e.everythingOK();
-      finishLogFile();
-      return 1;
-    }
-    if (fseek(f,0,SEEK_END)<0) {
-      reportError(fmt::sprintf("couldn't open file! (couldn't get file size: %s)",strerror(errno)));
-      e.everythingOK();
-      fclose(f);
-      finishLogFile();
-      return 1;
-    }
-    ssize_t len=ftell(f);
-    if (len==(SIZE_MAX>>1)) {
-      reportError(fmt::sprintf("couldn't open file! (couldn't get file length: %s)",strerror(errno)));
-      e.everythingOK();
-      fclose(f);
-      finishLogFile();
-      return 1;
-    }
-    if (len<1) {
-      if (len==0) {
-        reportError("that file is empty!");
-      } else {
-        reportError(fmt::sprintf("couldn't open file! (tell error: %s)",strerror(errno)));
-      }
-      e.everythingOK();
-      fclose(f);
-      finishLogFile();
-      return 1;
-    }
-    unsigned char* file=new unsigned char[len];
-    if (fseek(f,0,SEEK_SET)<0) {
-      reportError(fmt::sprintf("couldn't open file! (size error: %s)",strerror(errno)));
-      e.everythingOK();
-      fclose(f);
-      delete[] file;
-      finishLogFile();
-      return 1;
-    }
-    if (fread(file,1,(size_t)len,f)!=(size_t)len) {
-      reportError(fmt::sprintf("couldn't open file! (read error: %s)",strerror(errno)));
-      e.everythingOK();
-      fclose(f);
-      delete[] file;
-      finishLogFile();
-      return 1;
-    }
-    fclose(f);
-    if (!e.load(file,(size_t)len)) {
-      reportError(fmt::sprintf("could not open file! (%s)",e.getLastError()));
+    String loadError;
+    if (!loadSongFile(e,fileName,loadError)) {
+      reportError(loadError);
       e.everythingOK();
       finishLogFile();
       return 1;
@@ -647,12 +755,32 @@ int main(int argc, char** argv) {
     e.changeSongP(subsong);
   }
 
+  if (batchName!="") {
+    int batchResult=runBatch(batchName);
+    finishLogFile();
+    return batchResult;
+  }
+
   if (benchMode) {
     logI("starting benchmark!");
     if (benchMode==2) {
       e.benchmarkSeek();
     } else {
       e.benchmarkPlayback();
+      if (profileName!="") {
+        String json=e.getProfilerJSON();
+        if (profileName=="-") {
+          fputs(json.c_str(),stdout);
+        } else {
+          FILE* f=ps_fopen(profileName.c_str(),"wb");
+          if (f!=NULL) {
+            fwrite(json.c_str(),1,json.size(),f);
+            fclose(f);
+          } else {
+            reportError(fmt::sprintf("could not write profile! (%s)",strerror(errno)));
+          }
+        }
+      }
     }
     finishLogFile();
     return 0;
@@ -0,0 +1,33 @@
+#!/bin/bash
+# renders all files in test/songs/ in batch mode, first with one job and then with several
+# engine instances running at once, and checks that the outputs are identical.
+# useful when touching state shared between engine instances.
+# usage: test/furnace-batch-test.sh [jobs]
+
+jobs=${1:-$(nproc)}
+testDir="test/batch/$(date +%Y%m%d%H%M%S)"
+
+echo "furnace batch test begin ($jobs jobs)..."
+mkdir -p "$testDir/single" "$testDir/multi" || exit 1
+
+for i in `ls "test/songs/"`; do
+  printf "test/songs/%s\t%s/single/%s.wav\n" "$i" "$testDir" "$i" >> "$testDir/single.txt"
+  printf "test/songs/%s\t%s/multi/%s.wav\n" "$i" "$testDir" "$i" >> "$testDir/multi.txt"
+done
+
+echo "--- STEP 1: render test files (single job)"
+./build/furnace -batch "$testDir/single.txt" || exit 1
+echo "--- STEP 2: render test files ($jobs jobs)"
+./build/furnace -batch "$testDir/multi.txt" -jobs "$jobs" || exit 1
+echo "--- STEP 3: compare"
+failed=0
+for i in `ls "$testDir/single"`; do
+  echo -n "$i... "
+  if cmp -s "$testDir/single/$i" "$testDir/multi/$i"; then
+    echo "[1;32mOK[m"
+  else
+    echo "[1;31mFAIL FAIL FAIL[m"
+    failed=1
+  fi
+done
+exit $failed